@@ -39,6 +39,8 @@
 #endif
 
 #define MAX_BS_BUF                 (16*1024*1024)
+/* maximum number of CTU rows reported with their encoding time */
+#define MAX_CTU_ROWS               (512)
 
 typedef enum _STATES {
     STATE_ENCODING,
@@ -164,9 +166,16 @@ int check_conf(XEVE_CDSC* cdsc)
     return ret;
 }
 
-static int set_extra_config(XEVE id, ARGS_PARSER * args, XEVE_PARAM * param)
+/* low delay output: the slices of a picture are written as they are encoded */
+static int write_nalu(void * opaque, void * data, int size, int last)
+{
+    return (size > 0) ? write_data((WRITER *)opaque, (unsigned char *)data, size) : 0;
+}
+
+static int set_extra_config(XEVE id, ARGS_PARSER * args, XEVE_PARAM * param, WRITER * wr_out)
 {
     int  ret, size, value;
+    XEVE_NALU_OUT nalu_out;
 
     if(args->hash)
     {
@@ -179,6 +188,18 @@ static int set_extra_config(XEVE id, ARGS_PARSER * args, XEVE_PARAM * param)
             return -1;
         }
     }
+    if(args->nalu_out && wr_out != NULL)
+    {
+        nalu_out.fn = write_nalu;
+        nalu_out.opaque = wr_out;
+        size = sizeof(XEVE_NALU_OUT);
+        ret = xeve_config(id, XEVE_CFG_SET_NALU_OUT, &nalu_out, &size);
+        if(XEVE_FAILED(ret))
+        {
+            logerr("failed to set config for NAL unit output\n");
+            return -1;
+        }
+    }
 
     return 0;
 }
@@ -255,6 +276,10 @@ static void print_config(ARGS_PARSER * args, XEVE_PARAM * param)
     logv2("\theight                   = %d\n", param->h);
     logv2("\tFPS                      = %d\n", param->fps);
     logv2("\tintra picture period     = %d\n", param->keyint);
+    if (param->intra_refresh)
+    {
+        logv2("\tintra refresh period     = %d\n", param->intra_refresh);
+    }
     if (param->rc_type == XEVE_RC_CRF)
     {
         logv2("\tCRF                      = %d\n", param->crf);
@@ -272,6 +297,10 @@ static void print_config(ARGS_PARSER * args, XEVE_PARAM * param)
     {
         logv2("\tBit_Rate                 = %dkbps\n", param->bitrate);
     }
+    if (param->rc_pass != 0)
+    {
+        logv2("\trate-control pass        = %d%s (%s)\n", param->rc_pass, (param->rc_pass == 1 && param->rc_pass_fast) ? " fast" : "", param->rc_stats);
+    }
     if (args->input_depth == 8 && param->codec_bit_depth > 8)
     {
         logv2("Note: PSNR is calculated as 10-bit (Input YUV bitdepth: %d)\n", args->input_depth);
@@ -306,17 +335,20 @@ static void print_config(ARGS_PARSER * args, XEVE_PARAM * param)
 
 }
 
-static int remove_file_contents(char * filename)
+/* the logs go to the standard error when the bitstream or the reconstructed
+   video is written to the standard output */
+static int is_stdout_used(int argc, const char **argv)
 {
-    /* reconstruction file - remove contents and close */
-    FILE * fp;
-    fp = fopen(filename, "wb");
-    if(fp == NULL)
+    int i;
+    for(i = 2; i < argc; i++)
     {
-        logerr("cannot remove file (%s)\n", filename);
-        return -1;
+        if(!strcmp(argv[i], WRITER_STDOUT) &&
+           (!strcmp(argv[i - 1], "-o") || !strcmp(argv[i - 1], "--output") ||
+            !strcmp(argv[i - 1], "-r") || !strcmp(argv[i - 1], "--recon")))
+        {
+            return 1;
+        }
     }
-    fclose(fp);
     return 0;
 }
 
@@ -380,14 +412,13 @@ int setup_bumping(XEVE id)
     return 0;
 }
 
-static int y4m_test(FILE * fp)
+static int y4m_test(READER * rd)
 {
 
     char buffer[9] = { 0 };
 
     /*Peek to check if y4m header is present*/
-    if (!fread(buffer, 1, 8, fp)) return -1;
-    fseek( fp, 0, SEEK_SET );
+    if (!reader_peek(rd, buffer, 8)) return -1;
     buffer[8] = '\0';
     if (memcmp(buffer, "YUV4MPEG", 8))
     {
@@ -514,7 +545,7 @@ static int y4m_parse_tags(Y4M_INFO * y4m, char * tags)
 }
 
 
-int y4m_header_parser(FILE * ip_y4m, Y4M_INFO * y4m)
+int y4m_header_parser(READER * ip_y4m, Y4M_INFO * y4m)
 {
     char buffer[80] = { 0 };
     int ret;
@@ -524,7 +555,7 @@ int y4m_header_parser(FILE * ip_y4m, Y4M_INFO * y4m)
     for (i = 0; i < 79; i++)
     {
 
-        if (!fread(buffer + i, 1, 1, ip_y4m)) return -1;
+        if (!reader_read(ip_y4m, buffer + i, 1)) return -1;
 
         if (buffer[i] == '\n') break;
     }
@@ -598,7 +629,9 @@ int main(int argc, const char **argv)
 {
     STATES             state = STATE_ENCODING;
     unsigned char    * bs_buf = NULL;
-    FILE             * fp_inp = NULL;
+    READER           * rd_inp = NULL;
+    WRITER           * wr_out = NULL;
+    WRITER           * wr_rec = NULL;
     XEVE               id;
     XEVE_CDSC          cdsc;
     XEVE_PARAM       * param = NULL;
@@ -626,9 +659,17 @@ int main(int argc, const char **argv)
     int                max_frames = 0;
     int                skip_frames = 0;
     int                is_max_frames = 0, is_skip_frames = 0;
+    int                is_fast_pass = 0;
     char             * errstr = NULL;
     int                color_format;
     int                width, height;
+    long long          sync_wait[XEVE_MAX_THREADS];
+    long long          row_time[MAX_CTU_ROWS];
+
+    if(is_stdout_used(argc, argv))
+    {
+        op_log_fp = stderr;
+    }
     logv2("XEVE: eXtra-fast Essential Video Encoder\n");
 
     /* help message */
@@ -671,18 +712,18 @@ int main(int argc, const char **argv)
         logerr("input file should be set\n");
         ret = -1; goto ERR;
     }
-    fp_inp = fopen(fname_inp, "rb");
-    if(fp_inp == NULL)
+    rd_inp = reader_open(fname_inp, args->read_buffer * 1024);
+    if(rd_inp == NULL)
     {
         logerr("cannot open input file (%s)\n", fname_inp);
         ret = -1; goto ERR;
     }
 
     /* y4m header parsing  */
-    is_y4m = y4m_test(fp_inp);
+    is_y4m = y4m_test(rd_inp);
     if (is_y4m)
     {
-        if (y4m_header_parser(fp_inp, &y4m))
+        if (y4m_header_parser(rd_inp, &y4m))
         {
             logerr("This y4m is not supported (%s)\n", fname_inp);
             ret = -1; goto ERR;
@@ -749,18 +790,33 @@ int main(int argc, const char **argv)
         logerr("cannot get 'output' option\n");
         ret = -1; goto ERR;
     }
-    if (is_out)
-    {
-        remove_file_contents(fname_out);
-    }
     if (args->get_str(args, "recon", fname_rec, &is_rec))
     {
         logerr("cannot get 'recon' option\n");
         ret = -1; goto ERR;
     }
+    if (is_out && is_rec && !strcmp(fname_out, WRITER_STDOUT) && !strcmp(fname_rec, WRITER_STDOUT))
+    {
+        logerr("bitstream and reconstructed video cannot be both written to standard output\n");
+        ret = -1; goto ERR;
+    }
+    if (is_out)
+    {
+        wr_out = writer_open(fname_out, args->write_buffer * 1024);
+        if (wr_out == NULL)
+        {
+            logerr("cannot open output file (%s)\n", fname_out);
+            ret = -1; goto ERR;
+        }
+    }
     if (is_rec)
     {
-        remove_file_contents(fname_rec);
+        wr_rec = writer_open(fname_rec, args->write_buffer * 1024);
+        if (wr_rec == NULL)
+        {
+            logerr("cannot open recon file (%s)\n", fname_rec);
+            ret = -1; goto ERR;
+        }
     }
     if (args->get_int(args, "frames", &max_frames, &is_max_frames))
     {
@@ -789,7 +845,7 @@ int main(int argc, const char **argv)
         ret = -1; goto ERR;
     }
 
-    if (set_extra_config(id, args, param))
+    if (set_extra_config(id, args, param, wr_out))
     {
         logerr("cannot set extra configurations\n");
         ret = -1; goto ERR;
@@ -812,6 +868,8 @@ int main(int argc, const char **argv)
     print_config(args, param);
     print_stat_init(args);
 
+    is_fast_pass = (param->rc_pass == 1 && param->rc_pass_fast);
+
     bitrate = 0;
     bitb.addr = bs_buf;
     bitb.bsize = MAX_BS_BUF;
@@ -839,7 +897,7 @@ int main(int argc, const char **argv)
                     logerr("cannot get empty orignal buffer\n");
                     ret = -1; goto ERR;
                 }
-                if(imgb_read(fp_inp, ilist_t->imgb, param->w, param->h, is_y4m))
+                if(imgb_read(rd_inp, ilist_t->imgb, param->w, param->h, is_y4m))
                 {
                     logv3("reached end of original file (or reading error)\n");
                     ret = -1; goto ERR;
@@ -863,7 +921,7 @@ int main(int argc, const char **argv)
                 ret = -1; goto ERR;
             }
             /* read original image */
-            ret = imgb_read(fp_inp, ilist_t->imgb, param->w, param->h, is_y4m);
+            ret = imgb_read(rd_inp, ilist_t->imgb, param->w, param->h, is_y4m);
             if ((ret < 0))
             {
                 logv3("reached out the end of input file\n");
@@ -881,6 +939,13 @@ int main(int argc, const char **argv)
                 ret = -1; goto ERR;
             }
             pic_icnt++;
+
+            if (is_fast_pass)
+            {
+                /* no picture is encoded in the fast first pass and
+                   the encoder holds its own copy of the pushed image */
+                imgb_list_make_unused(ilist_t);
+            }
         }
         /* encoding */
         clk_beg = xeve_clk_get();
@@ -899,13 +964,16 @@ int main(int argc, const char **argv)
         if (ret == XEVE_OK_OUT_NOT_AVAILABLE)
         {
             /* logv3("--> RETURN OK BUT PICTURE IS NOT AVAILABLE YET\n"); */
-            continue;
+            if (!is_fast_pass)
+            {
+                continue;
+            }
         }
         else if(ret == XEVE_OK)
         {
-            if(is_out && stat.write > 0)
+            if(is_out && stat.write > 0 && !args->nalu_out)
             {
-                if(write_data(fname_out, bs_buf, stat.write))
+                if(write_data(wr_out, bs_buf, stat.write))
                 {
                     logerr("cannot write bitstream\n");
                     ret = -1; goto ERR;
@@ -958,7 +1026,7 @@ int main(int argc, const char **argv)
             {
                 if(is_rec)
                 {
-                    if(imgb_write(args->fname_rec, ilist_t->imgb, param->w, param->h))
+                    if(imgb_write(wr_rec, ilist_t->imgb, param->w, param->h))
                     {
                         logerr("cannot write reconstruction image\n");
                         ret = -1; goto ERR;
@@ -984,7 +1052,7 @@ int main(int argc, const char **argv)
                 logv2("[ %d / %d frames ] [ %.2f frame/sec ] [ %.4f kbps ] [ %2dh %2dm %2ds ] \r"
                        , encod_frames, max_frames, ((float)(encod_frames + 1) * 1000) / ((float)xeve_clk_msec(clk_tot))
                        , curr_bitrate, h, m, s);
-                fflush(stdout);
+                fflush(log_out());
                 encod_frames++;
             }
 
@@ -1013,6 +1081,15 @@ int main(int argc, const char **argv)
         }
     }
 
+    if (is_fast_pass)
+    {
+        logv2_line("Summary");
+        logv2("Analyzed frame count              = %d\n", (int)pic_icnt);
+        logv2("Total analysis time               = %.3f msec\n", (float)xeve_clk_msec(clk_tot));
+        logv2_line(NULL);
+        goto ERR;
+    }
+
     /* store remained reconstructed pictures in output list */
     while(pic_icnt - pic_ocnt > 0)
     {
@@ -1022,7 +1099,7 @@ int main(int argc, const char **argv)
         {
             if(is_rec)
             {
-                if(imgb_write(args->fname_rec, ilist_t->imgb, param->w, param->h))
+                if(imgb_write(wr_rec, ilist_t->imgb, param->w, param->h))
                 {
                     logerr("cannot write reconstruction image\n");
                     ret = -1; goto ERR;
@@ -1063,6 +1140,23 @@ int main(int argc, const char **argv)
         (float)xeve_clk_msec(clk_tot)/pic_ocnt);
     logv2("Average encoding speed            = %.3f frames/sec\n",
         ((float)pic_ocnt * 1000) / ((float)xeve_clk_msec(clk_tot)));
+
+    size = sizeof(sync_wait);
+    if(XEVE_SUCCEEDED(xeve_config(id, XEVE_CFG_GET_SYNC_WAIT_TIME, sync_wait, &size)))
+    {
+        for(i = 0; i < size / (int)sizeof(long long); i++)
+        {
+            logv3("Thread %-3d dependency wait time  = %.3f msec\n", i, sync_wait[i] / 1000.0);
+        }
+    }
+    size = sizeof(row_time);
+    if(XEVE_SUCCEEDED(xeve_config(id, XEVE_CFG_GET_ROW_TIME, row_time, &size)))
+    {
+        for(i = 0; i < size / (int)sizeof(long long); i++)
+        {
+            logv3("CTU row %-4d encoding time       = %.3f msec\n", i, row_time[i] / 1000.0);
+        }
+    }
     logv2_line(NULL);
 
     if (is_max_frames && pic_ocnt != max_frames)
@@ -1072,9 +1166,19 @@ int main(int argc, const char **argv)
 
 ERR:
     if(id) xeve_delete(id);
+    if(writer_close(wr_out) && ret >= 0)
+    {
+        logerr("cannot write bitstream\n");
+        ret = -1;
+    }
+    if(writer_close(wr_rec) && ret >= 0)
+    {
+        logerr("cannot write reconstruction image\n");
+        ret = -1;
+    }
     imgb_list_free(ilist_org);
     imgb_list_free(ilist_rec);
-    if(fp_inp) fclose(fp_inp);
+    reader_close(rd_inp);
     if(bs_buf) free(bs_buf); /* release bitstream buffer */
     if(args) args->release(args);
     return ret;
@@ -79,15 +79,15 @@ static const ARGS_OPT args_opt_table[] = \
     */
     {
         'i', "input", ARGS_VAL_TYPE_STRING | ARGS_VAL_TYPE_MANDATORY, 0, NULL,
-        "file name of input video"
+        "file name of input video ('-' for standard input)"
     },
     {
         'o', "output", ARGS_VAL_TYPE_STRING, 0, NULL,
-        "file name of output bitstream"
+        "file name of output bitstream ('-' for standard output)"
     },
     {
         'r', "recon", ARGS_VAL_TYPE_STRING, 0, NULL,
-        "file name of reconstructed video"
+        "file name of reconstructed video ('-' for standard output)"
     },
     {
         'w',  "width", ARGS_VAL_TYPE_INTEGER | ARGS_VAL_TYPE_MANDATORY, 0, NULL,
@@ -115,7 +115,7 @@ static const ARGS_OPT args_opt_table[] = \
     },
     {
         'm',  "threads", ARGS_VAL_TYPE_INTEGER, 0, NULL,
-        "force to use a specific number of threads"
+        "force to use a specific number of threads (0: one per processor core)"
     },
     {
         'd',  "input-depth", ARGS_VAL_TYPE_INTEGER, 0, NULL,
@@ -167,6 +167,23 @@ static const ARGS_OPT args_opt_table[] = \
         ARGS_NO_KEY,  "hash", ARGS_VAL_TYPE_NONE, 0, NULL,
         "embed picture signature (HASH) for conformance checking in decoding"
     },
+    {
+        ARGS_NO_KEY,  "nalu-out", ARGS_VAL_TYPE_NONE, 0, NULL,
+        "write each slice to the output as soon as it is encoded\n"
+        "      (low delay output in the baseline profile only)"
+    },
+    {
+        ARGS_NO_KEY,  "write-buffer", ARGS_VAL_TYPE_INTEGER, 0, NULL,
+        "size in KB of the buffer of each output file written by a writer thread\n"
+        "      - 0: write from the encoding loop\n"
+        "      - default: 16384"
+    },
+    {
+        ARGS_NO_KEY,  "read-buffer", ARGS_VAL_TYPE_INTEGER, 0, NULL,
+        "size in KB of the buffer of the input file read ahead by a reader thread\n"
+        "      - 0: read from the encoding loop\n"
+        "      - default: 32768"
+    },
     {
         ARGS_NO_KEY,  "cutree", ARGS_VAL_TYPE_INTEGER, 0, NULL,
         "use cutree block qp adaptation\n"
@@ -418,6 +435,31 @@ static const ARGS_OPT args_opt_table[] = \
         ARGS_NO_KEY,  "lookahead", ARGS_VAL_TYPE_INTEGER, 0, NULL,
         "number of pre analysis frames for rate control and cutree, disable:0"
     },
+    {
+        ARGS_NO_KEY,  "scenecut", ARGS_VAL_TYPE_INTEGER, 0, NULL,
+        "threshold of scene-cut detection for I-picture insertion (0~100)\n"
+        "      - 0: off"
+    },
+    {
+        ARGS_NO_KEY,  "rc-pass", ARGS_VAL_TYPE_INTEGER, 0, NULL,
+        "multi-pass rate control\n"
+        "      - 0: single pass\n"
+        "      - 1: first pass, write statistics to rc-stats file\n"
+        "      - 2: second pass, read statistics from rc-stats file (ABR)"
+    },
+    {
+        ARGS_NO_KEY,  "rc-pass-fast", ARGS_VAL_TYPE_NONE, 0, NULL,
+        "first pass runs only the forecast analysis (no bitstream)"
+    },
+    {
+        ARGS_NO_KEY,  "rc-stats", ARGS_VAL_TYPE_STRING, 0, NULL,
+        "file name of multi-pass rate control statistics"
+    },
+    {
+        ARGS_NO_KEY,  "intra-refresh", ARGS_VAL_TYPE_INTEGER, 0, NULL,
+        "period of intra refresh by a moving CTU column (low delay only)\n"
+        "      - 0: off"
+    },
     {
         ARGS_NO_KEY,  "chroma-qp-table-present-flag", ARGS_VAL_TYPE_INTEGER, 0, NULL,
         "chroma-qp-table-present-flag"
@@ -512,6 +554,12 @@ static const ARGS_OPT args_opt_table[] = \
         ARGS_NO_KEY,  "ref", ARGS_VAL_TYPE_INTEGER, 0, NULL,
         "Number of reference pictures"
     },
+    {
+        ARGS_NO_KEY,  "me-pyramid", ARGS_VAL_TYPE_INTEGER, 0, NULL,
+        "hierarchical motion pre-search on 1/4 and 1/2 resolution luma\n"
+        "      - 0: off\n"
+        "      - 1: on"
+    },
     {ARGS_END_KEY, "", ARGS_VAL_TYPE_NONE, 0, NULL, ""} /* termination */
 };
 
@@ -540,6 +588,9 @@ struct _ARGS_PARSER
     char fname_rec[256];
     int frames;
     int hash;
+    int nalu_out;
+    int write_buffer;
+    int read_buffer;
     int input_depth;
     int input_csp;
     int seek;
@@ -594,7 +645,8 @@ static int args_read_value(ARGS_OPT * ops, const char * argv)
     {
         return -1;
     }
-    if(argv[0] == '-' && (argv[1] < '0' || argv[1] > '9')) return -1;
+    /* a value cannot be an option, except a negative number or "-" */
+    if(argv[0] == '-' && argv[1] != '\0' && (argv[1] < '0' || argv[1] > '9')) return -1;
 
     switch(ARGS_GET_CMD_OPT_VAL_TYPE(ops->val_type))
     {
@@ -857,6 +909,11 @@ static int args_init(ARGS_PARSER * args, XEVE_PARAM* param)
     args_set_variable_by_key_long(opts, "recon", args->fname_rec);
     args_set_variable_by_key_long(opts, "frames", &args->frames);
     args_set_variable_by_key_long(opts, "hash", &args->hash);
+    args_set_variable_by_key_long(opts, "nalu-out", &args->nalu_out);
+    args_set_variable_by_key_long(opts, "write-buffer", &args->write_buffer);
+    args->write_buffer = 16384; /* default */
+    args_set_variable_by_key_long(opts, "read-buffer", &args->read_buffer);
+    args->read_buffer = 32768; /* default */
     args_set_variable_by_key_long(opts, "verbose", &op_verbose);
     op_verbose = VERBOSE_SIMPLE; /* default */
     args_set_variable_by_key_long(opts, "input-depth", &args->input_depth);
@@ -890,7 +947,23 @@ static int args_init(ARGS_PARSER * args, XEVE_PARAM* param)
     ARGS_SET_PARAM_VAR_KEY_LONG(opts, param, rc_type);
     ARGS_SET_PARAM_VAR_KEY_LONG(opts, param, use_filler);
     ARGS_SET_PARAM_VAR_KEY_LONG(opts, param, lookahead);
+    ARGS_SET_PARAM_VAR_KEY_LONG(opts, param, scenecut);
+    ARGS_SET_PARAM_VAR_KEY_LONG(opts, param, rc_pass);
+    ARGS_SET_PARAM_VAR_KEY_LONG(opts, param, rc_pass_fast);
+    args_set_variable_by_key_long(opts, "rc-stats", param->rc_stats);
+    ARGS_SET_PARAM_VAR_KEY_LONG(opts, param, intra_refresh);
     ARGS_SET_PARAM_VAR_KEY_LONG(opts, param, ref);
+    ARGS_SET_PARAM_VAR_KEY_LONG(opts, param, me_pyramid);
+    args_set_variable_by_key_long(opts, "tile-uniform-spacing", &param->tile_uniform_spacing_flag);
+    args_set_variable_by_key_long(opts, "num-tile-columns", &param->tile_columns);
+    args_set_variable_by_key_long(opts, "num-tile-rows", &param->tile_rows);
+    args_set_variable_by_key_long(opts, "tile-column-width-array", param->tile_column_width_array);
+    args_set_variable_by_key_long(opts, "tile-row-height-array", param->tile_row_height_array);
+    args_set_variable_by_key_long(opts, "num-slices-in-pic", &param->num_slice_in_pic);
+    args_set_variable_by_key_long(opts, "tile-array-in-slice", param->tile_array_in_slice);
+    args_set_variable_by_key_long(opts, "arbitrary-slice-flag", &param->arbitrary_slice_flag);
+    args_set_variable_by_key_long(opts, "num-remaining-tiles-in-slice", param->num_remaining_tiles_in_slice_minus1);
+    args_set_variable_by_key_long(opts, "lp-filter-across-tiles-en-flag", &param->loop_filter_across_tiles_enabled_flag);
 
 
 #if 0
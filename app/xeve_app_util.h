@@ -50,6 +50,15 @@
 #define VERBOSE_FRAME              3
 
 
+/* log output, the standard error is used when a stream is written to the
+   standard output */
+static FILE * op_log_fp = NULL;
+
+static FILE * log_out(void)
+{
+    return (op_log_fp == NULL) ? stdout : op_log_fp;
+}
+
 /* logging functions */
 static void log_msg(char * filename, int line, const char *fmt, ...)
 {
@@ -59,7 +68,7 @@ static void log_msg(char * filename, int line, const char *fmt, ...)
     va_start(args, fmt);
     vsprintf(str + strlen(str), fmt, args);
     va_end(args);
-    printf("%s", str);
+    fputs(str, log_out());
 }
 
 static void log_line(char * pre)
@@ -79,7 +88,7 @@ static void log_line(char * pre)
 
     for(i = len ; i< chars; i++) {str[i] = '=';}
     str[chars] = '\0';
-    printf("%s\n", str);
+    fprintf(log_out(), "%s\n", str);
 }
 
 #if defined(__GNUC__)
@@ -151,7 +160,486 @@ static XEVE_CLK xeve_clk_from(XEVE_CLK from) \
 
 #define XEVEA_CLIP(n,min,max) (((n)>(max))? (max) : (((n)<(min))? (min) : (n)))
 
-static int imgb_read(FILE * fp, XEVE_IMGB * img, int width, int height, int is_y4m)
+/* Threads of the input reader and the output writers */
+#if defined(_WIN64) || defined(_WIN32)
+#include <process.h>
+#include <io.h>
+#include <fcntl.h>
+
+typedef HANDLE             APP_THREAD;
+typedef CRITICAL_SECTION   APP_MUTEX;
+typedef CONDITION_VARIABLE APP_COND;
+typedef unsigned int (__stdcall * APP_THREAD_FUNC)(void * arg);
+#define APP_THREAD_RET          unsigned int __stdcall
+
+#define app_mutex_init(m)       InitializeCriticalSection(m)
+#define app_mutex_destroy(m)    DeleteCriticalSection(m)
+#define app_mutex_lock(m)       EnterCriticalSection(m)
+#define app_mutex_unlock(m)     LeaveCriticalSection(m)
+#define app_cond_init(c)        InitializeConditionVariable(c)
+#define app_cond_destroy(c)
+#define app_cond_wait(c, m)     SleepConditionVariableCS(c, m, INFINITE)
+#define app_cond_wake(c)        WakeAllConditionVariable(c)
+#define app_set_binary(fp)      _setmode(_fileno(fp), _O_BINARY)
+
+static int app_thread_create(APP_THREAD * t, APP_THREAD_FUNC entry, void * arg)
+{
+    *t = (HANDLE)_beginthreadex(NULL, 0, entry, arg, 0, NULL);
+    return (*t == 0) ? -1 : 0;
+}
+
+static void app_thread_join(APP_THREAD t)
+{
+    WaitForSingleObject(t, INFINITE);
+    CloseHandle(t);
+}
+#else
+#include <pthread.h>
+
+typedef pthread_t          APP_THREAD;
+typedef pthread_mutex_t    APP_MUTEX;
+typedef pthread_cond_t     APP_COND;
+typedef void * (* APP_THREAD_FUNC)(void * arg);
+#define APP_THREAD_RET          void *
+
+#define app_mutex_init(m)       pthread_mutex_init(m, NULL)
+#define app_mutex_destroy(m)    pthread_mutex_destroy(m)
+#define app_mutex_lock(m)       pthread_mutex_lock(m)
+#define app_mutex_unlock(m)     pthread_mutex_unlock(m)
+#define app_cond_init(c)        pthread_cond_init(c, NULL)
+#define app_cond_destroy(c)     pthread_cond_destroy(c)
+#define app_cond_wait(c, m)     pthread_cond_wait(c, m)
+#define app_cond_wake(c)        pthread_cond_broadcast(c)
+#define app_set_binary(fp)
+
+static int app_thread_create(APP_THREAD * t, APP_THREAD_FUNC entry, void * arg)
+{
+    return pthread_create(t, NULL, entry, arg) ? -1 : 0;
+}
+
+static void app_thread_join(APP_THREAD t)
+{
+    pthread_join(t, NULL);
+}
+#endif
+
+/* name of an output file standing for the standard output */
+#define WRITER_STDOUT            "-"
+
+/* an output file which stays open during the encoding. with a buffer, the
+   data is copied to a ring buffer and written to the file by a writer thread,
+   so the encoding loop does not wait for the file system */
+typedef struct _WRITER
+{
+    FILE             * fp;
+    /* ring buffer, NULL when the data is written by the caller */
+    unsigned char    * buf;
+    int                size;
+    /* number of bytes put into and taken from the ring buffer */
+    unsigned long long head;
+    unsigned long long tail;
+    /* no more data is put */
+    int                eof;
+    /* a write to the file failed */
+    int                err;
+    APP_THREAD         thread;
+    APP_MUTEX          lock;
+    APP_COND           cond;
+} WRITER;
+
+static void writer_run(WRITER * wr)
+{
+    int off, len;
+
+    app_mutex_lock(&wr->lock);
+    while(1)
+    {
+        while(wr->head == wr->tail && !wr->eof)
+        {
+            app_cond_wait(&wr->cond, &wr->lock);
+        }
+        if(wr->head == wr->tail)
+        {
+            break;
+        }
+        off = (int)(wr->tail % wr->size);
+        len = (int)(wr->head - wr->tail);
+        len = (len < wr->size - off) ? len : wr->size - off;
+        app_mutex_unlock(&wr->lock);
+
+        /* the bytes between tail and head are not touched by the caller */
+        len = (int)fwrite(wr->buf + off, 1, len, wr->fp) == len ? len : -1;
+
+        app_mutex_lock(&wr->lock);
+        if(len < 0)
+        {
+            wr->err = 1;
+            wr->tail = wr->head;
+        }
+        else
+        {
+            wr->tail += len;
+        }
+        app_cond_wake(&wr->cond);
+    }
+    app_mutex_unlock(&wr->lock);
+}
+
+static APP_THREAD_RET writer_entry(void * arg)
+{
+    writer_run((WRITER *)arg);
+    return 0;
+}
+
+/* open (and truncate) an output file, buf_size is the size of the ring buffer
+   in bytes or zero to write the data directly */
+static WRITER * writer_open(char * fname, int buf_size)
+{
+    WRITER * wr;
+
+    wr = (WRITER *)calloc(1, sizeof(WRITER));
+    if(wr == NULL)
+    {
+        return NULL;
+    }
+    if(!strcmp(fname, WRITER_STDOUT))
+    {
+        wr->fp = stdout;
+        app_set_binary(wr->fp);
+    }
+    else
+    {
+        wr->fp = fopen(fname, "wb");
+        if(wr->fp == NULL)
+        {
+            logerr("cannot open an writing file=%s\n", fname);
+            free(wr);
+            return NULL;
+        }
+    }
+    if(buf_size > 0)
+    {
+        wr->buf = (unsigned char *)malloc(buf_size);
+        if(wr->buf == NULL)
+        {
+            logerr("cannot allocate writing buffer, size=%d\n", buf_size);
+            goto ERR;
+        }
+        wr->size = buf_size;
+        app_mutex_init(&wr->lock);
+        app_cond_init(&wr->cond);
+        if(app_thread_create(&wr->thread, writer_entry, wr))
+        {
+            logerr("cannot create writing thread\n");
+            app_cond_destroy(&wr->cond);
+            app_mutex_destroy(&wr->lock);
+            goto ERR;
+        }
+    }
+    return wr;
+
+ERR:
+    if(wr->buf) free(wr->buf);
+    if(wr->fp != stdout) fclose(wr->fp);
+    free(wr);
+    return NULL;
+}
+
+static int writer_write(WRITER * wr, void * data, int size)
+{
+    unsigned char * p = (unsigned char *)data;
+    int             off, len;
+
+    if(wr->buf == NULL)
+    {
+        return (fwrite(p, 1, size, wr->fp) == (size_t)size) ? 0 : -1;
+    }
+
+    app_mutex_lock(&wr->lock);
+    while(size > 0 && !wr->err)
+    {
+        while(wr->head - wr->tail == (unsigned long long)wr->size && !wr->err)
+        {
+            app_cond_wait(&wr->cond, &wr->lock);
+        }
+        off = (int)(wr->head % wr->size);
+        len = wr->size - (int)(wr->head - wr->tail);
+        len = (len < wr->size - off) ? len : wr->size - off;
+        len = (len < size) ? len : size;
+        app_mutex_unlock(&wr->lock);
+
+        /* the free part of the ring buffer is not touched by the writer */
+        memcpy(wr->buf + off, p, len);
+        p += len;
+        size -= len;
+
+        app_mutex_lock(&wr->lock);
+        wr->head += len;
+        app_cond_wake(&wr->cond);
+    }
+    len = wr->err ? -1 : 0;
+    app_mutex_unlock(&wr->lock);
+    return len;
+}
+
+/* write the buffered data and close the file */
+static int writer_close(WRITER * wr)
+{
+    int err;
+
+    if(wr == NULL)
+    {
+        return 0;
+    }
+    if(wr->buf != NULL)
+    {
+        app_mutex_lock(&wr->lock);
+        wr->eof = 1;
+        app_cond_wake(&wr->cond);
+        app_mutex_unlock(&wr->lock);
+        app_thread_join(wr->thread);
+        app_cond_destroy(&wr->cond);
+        app_mutex_destroy(&wr->lock);
+        free(wr->buf);
+    }
+    err = wr->err || fflush(wr->fp);
+    if(wr->fp != stdout)
+    {
+        err |= fclose(wr->fp);
+    }
+    free(wr);
+    return err ? -1 : 0;
+}
+
+/* name of an input file standing for the standard input */
+#define READER_STDIN             "-"
+
+/* largest read of the reader thread, so the first frames are available
+   before the whole ring buffer is filled */
+#define READER_CHUNK             (1 << 20)
+
+/* an input file read ahead of the encoding. with a buffer, a reader thread
+   fills a ring buffer from the file (or pipe), so the encoding loop takes the
+   frames from memory instead of waiting for the file system */
+typedef struct _READER
+{
+    FILE             * fp;
+    /* ring buffer, NULL when the data is read by the caller */
+    unsigned char    * buf;
+    int                size;
+    /* number of bytes put into and taken from the ring buffer */
+    unsigned long long head;
+    unsigned long long tail;
+    /* the end of the file is reached */
+    int                eof;
+    /* no more data is taken */
+    int                stop;
+    /* bytes peeked from the file when the data is read by the caller */
+    unsigned char      pk[16];
+    int                pk_len;
+    APP_THREAD         thread;
+    APP_MUTEX          lock;
+    APP_COND           cond;
+} READER;
+
+static void reader_run(READER * rd)
+{
+    int off, len, got;
+
+    app_mutex_lock(&rd->lock);
+    while(!rd->eof)
+    {
+        while(rd->head - rd->tail == (unsigned long long)rd->size && !rd->stop)
+        {
+            app_cond_wait(&rd->cond, &rd->lock);
+        }
+        if(rd->stop)
+        {
+            break;
+        }
+        off = (int)(rd->head % rd->size);
+        len = rd->size - (int)(rd->head - rd->tail);
+        len = (len < rd->size - off) ? len : rd->size - off;
+        len = (len < READER_CHUNK) ? len : READER_CHUNK;
+        app_mutex_unlock(&rd->lock);
+
+        /* the free part of the ring buffer is not touched by the caller */
+        got = (int)fread(rd->buf + off, 1, len, rd->fp);
+
+        app_mutex_lock(&rd->lock);
+        rd->head += got;
+        if(got < len)
+        {
+            rd->eof = 1;
+        }
+        app_cond_wake(&rd->cond);
+    }
+    app_mutex_unlock(&rd->lock);
+}
+
+static APP_THREAD_RET reader_entry(void * arg)
+{
+    reader_run((READER *)arg);
+    return 0;
+}
+
+/* open an input file, buf_size is the size of the ring buffer in bytes or
+   zero to read the data directly */
+static READER * reader_open(char * fname, int buf_size)
+{
+    READER * rd;
+
+    rd = (READER *)calloc(1, sizeof(READER));
+    if(rd == NULL)
+    {
+        return NULL;
+    }
+    if(!strcmp(fname, READER_STDIN))
+    {
+        rd->fp = stdin;
+        app_set_binary(rd->fp);
+    }
+    else
+    {
+        rd->fp = fopen(fname, "rb");
+        if(rd->fp == NULL)
+        {
+            free(rd);
+            return NULL;
+        }
+    }
+    if(buf_size > 0)
+    {
+        buf_size = (buf_size < (int)sizeof(rd->pk)) ? (int)sizeof(rd->pk) : buf_size;
+        rd->buf = (unsigned char *)malloc(buf_size);
+        if(rd->buf == NULL)
+        {
+            logerr("cannot allocate reading buffer, size=%d\n", buf_size);
+            goto ERR;
+        }
+        rd->size = buf_size;
+        app_mutex_init(&rd->lock);
+        app_cond_init(&rd->cond);
+        if(app_thread_create(&rd->thread, reader_entry, rd))
+        {
+            logerr("cannot create reading thread\n");
+            app_cond_destroy(&rd->cond);
+            app_mutex_destroy(&rd->lock);
+            goto ERR;
+        }
+    }
+    return rd;
+
+ERR:
+    if(rd->buf) free(rd->buf);
+    if(rd->fp != stdin) fclose(rd->fp);
+    free(rd);
+    return NULL;
+}
+
+/* copy up to size bytes from the ring buffer (or peeked bytes), consuming
+   them when take is set. return the number of copied bytes */
+static int reader_copy(READER * rd, unsigned char * dst, int size, int take)
+{
+    unsigned long long pos;
+    int                off, len, cnt = 0;
+
+    if(rd->buf == NULL)
+    {
+        len = (rd->pk_len < size) ? rd->pk_len : size;
+        memcpy(dst, rd->pk, len);
+        if(take)
+        {
+            rd->pk_len -= len;
+            memmove(rd->pk, rd->pk + len, rd->pk_len);
+        }
+        return len;
+    }
+
+    app_mutex_lock(&rd->lock);
+    pos = rd->tail;
+    while(cnt < size)
+    {
+        while(rd->head == pos && !rd->eof)
+        {
+            app_cond_wait(&rd->cond, &rd->lock);
+        }
+        if(rd->head == pos)
+        {
+            break;
+        }
+        off = (int)(pos % rd->size);
+        len = (int)(rd->head - pos);
+        len = (len < rd->size - off) ? len : rd->size - off;
+        len = (len < size - cnt) ? len : size - cnt;
+        app_mutex_unlock(&rd->lock);
+
+        /* the bytes between tail and head are not touched by the reader */
+        memcpy(dst + cnt, rd->buf + off, len);
+        cnt += len;
+        pos += len;
+
+        app_mutex_lock(&rd->lock);
+        if(take)
+        {
+            rd->tail = pos;
+            app_cond_wake(&rd->cond);
+        }
+    }
+    app_mutex_unlock(&rd->lock);
+    return cnt;
+}
+
+/* read size bytes, return the number of read bytes */
+static int reader_read(READER * rd, void * data, int size)
+{
+    int cnt;
+
+    cnt = reader_copy(rd, (unsigned char *)data, size, 1);
+    if(rd->buf == NULL && cnt < size)
+    {
+        cnt += (int)fread((unsigned char *)data + cnt, 1, size - cnt, rd->fp);
+    }
+    return cnt;
+}
+
+/* get the first size bytes without consuming them, so the format of a pipe
+   can be probed. size is not larger than the peek buffer */
+static int reader_peek(READER * rd, void * data, int size)
+{
+    if(rd->buf == NULL && rd->pk_len < size)
+    {
+        rd->pk_len += (int)fread(rd->pk + rd->pk_len, 1, size - rd->pk_len, rd->fp);
+    }
+    return reader_copy(rd, (unsigned char *)data, size, 0);
+}
+
+/* stop the reader thread and close the file */
+static void reader_close(READER * rd)
+{
+    if(rd == NULL)
+    {
+        return;
+    }
+    if(rd->buf != NULL)
+    {
+        app_mutex_lock(&rd->lock);
+        rd->stop = 1;
+        app_cond_wake(&rd->cond);
+        app_mutex_unlock(&rd->lock);
+        app_thread_join(rd->thread);
+        app_cond_destroy(&rd->cond);
+        app_mutex_destroy(&rd->lock);
+        free(rd->buf);
+    }
+    if(rd->fp != stdin)
+    {
+        fclose(rd->fp);
+    }
+    free(rd);
+}
+
+static int imgb_read(READER * rd, XEVE_IMGB * img, int width, int height, int is_y4m)
 {
     int f_w, f_h;
     int y_size, u_size, v_size;
@@ -161,7 +649,7 @@ static int imgb_read(FILE * fp, XEVE_IMGB * img, int width, int height, int is_y
     char t_buf[10];
     if (is_y4m)
     {
-        if (6 != fread(t_buf, 1, 6, fp)) return -1;
+        if (6 != reader_read(rd, t_buf, 6)) return -1;
         if (memcmp(t_buf, "FRAME", 5))
         {
             logerr("Loss of framing in Y4M input data\n");
@@ -199,7 +687,7 @@ static int imgb_read(FILE * fp, XEVE_IMGB * img, int width, int height, int is_y
     p8 = (unsigned char*)img->a[0];
     for (int j = 0; j < f_h; j++)
     {
-        if (fread(p8, 1, f_w, fp) != (unsigned)f_w)
+        if (reader_read(rd, p8, f_w) != f_w)
         {
             return -1;
         }
@@ -215,7 +703,7 @@ static int imgb_read(FILE * fp, XEVE_IMGB * img, int width, int height, int is_y
         p8 = (unsigned char*)img->a[1];
         for (int j = 0; j < f_h; j++)
         {
-            if (fread(p8, 1, f_w, fp) != (unsigned)f_w)
+            if (reader_read(rd, p8, f_w) != f_w)
             {
                 return -1;
             }
@@ -225,7 +713,7 @@ static int imgb_read(FILE * fp, XEVE_IMGB * img, int width, int height, int is_y
         p8 = (unsigned char*)img->a[2];
         for (int j = 0; j < f_h; j++)
         {
-            if (fread(p8, 1, f_w, fp) != (unsigned)f_w)
+            if (reader_read(rd, p8, f_w) != f_w)
             {
                 return -1;
             }
@@ -238,23 +726,16 @@ static int imgb_read(FILE * fp, XEVE_IMGB * img, int width, int height, int is_y
     return 0;
 }
 
-static int imgb_write(char * fname, XEVE_IMGB * imgb, int width, int height)
+static int imgb_write(WRITER * wr, XEVE_IMGB * imgb, int width, int height)
 {
     unsigned char * p8;
     int             i, j, bd;
     int             cs_w_off, cs_h_off;
-    FILE          * fp;
 
     int chroma_format = XEVE_CS_GET_FORMAT(imgb->cs);
     int bit_depth = XEVE_CS_GET_BIT_DEPTH(imgb->cs);
     int w_shift = (chroma_format == XEVE_CF_YCBCR420) || (chroma_format == XEVE_CF_YCBCR422) ? 1 : 0;
     int h_shift = chroma_format == XEVE_CF_YCBCR420 ? 1 : 0;
-    fp = fopen(fname, "ab");
-    if(fp == NULL)
-    {
-        logerr("cannot open file = %s\n", fname);
-        return -1;
-    }
     if(bit_depth == 8 && (chroma_format == XEVE_CF_YCBCR400 || chroma_format == XEVE_CF_YCBCR420 || chroma_format == XEVE_CF_YCBCR422 || chroma_format == XEVE_CF_YCBCR444))
     {
         bd = 1;
@@ -270,7 +751,6 @@ static int imgb_write(char * fname, XEVE_IMGB * imgb, int width, int height)
     else
     {
         logerr("cannot support the color space\n");
-        fclose(fp);
         return -1;
     }
 
@@ -284,12 +764,13 @@ static int imgb_write(char * fname, XEVE_IMGB * imgb, int width, int height)
         }
         for (j = 0; j < height; j++)
         {
-            fwrite(p8, width * bd, 1, fp);
+            if(writer_write(wr, p8, width * bd))
+            {
+                return -1;
+            }
             p8 += imgb->s[i];
         }
     }
-
-    fclose(fp);
     return 0;
 }
 
@@ -757,19 +1238,9 @@ static int cal_psnr(IMGB_LIST * imgblist_inp, XEVE_IMGB * rec, XEVE_MTIME ts,
     return -1;
 }
 
-static int write_data(char * fname, unsigned char * data, int size)
+static int write_data(WRITER * wr, unsigned char * data, int size)
 {
-    FILE * fp;
-
-    fp = fopen(fname, "ab");
-    if(fp == NULL)
-    {
-        logerr("cannot open an writing file=%s\n", fname);
-        return -1;
-    }
-    fwrite(data, 1, size, fp);
-    fclose(fp);
-    return 0;
+    return writer_write(wr, data, size);
 }
 
 
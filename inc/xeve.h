@@ -39,7 +39,9 @@ extern "C"
 
 #include <xeve_exports.h>
 
-#define XEVE_MAX_THREADS                 (8)
+#define XEVE_MAX_THREADS                 (256)
+/* select the number of threads from the processor cores of the system */
+#define XEVE_THREADS_AUTO                (0)
 #define XEVE_MAX_NUM_TILES_ROW           (22)
 #define XEVE_MAX_NUM_TILES_COL           (20)
 
@@ -118,6 +120,7 @@ extern "C"
  * config types
  *****************************************************************************/
 #define XEVE_CFG_SET_FORCE_OUT          (102)
+#define XEVE_CFG_SET_NALU_OUT           (103)
 #define XEVE_CFG_SET_FINTRA             (200)
 #define XEVE_CFG_SET_QP                 (201)
 #define XEVE_CFG_SET_BPS                (202)
@@ -150,6 +153,11 @@ extern "C"
 #define XEVE_CFG_GET_HEIGHT             (702)
 #define XEVE_CFG_GET_RECON              (703)
 #define XEVE_CFG_GET_SUPPORT_PROF       (704)
+/* per-thread time (us) spent waiting for CTU dependencies, buf is an array of long long */
+#define XEVE_CFG_GET_SYNC_WAIT_TIME     (705)
+/* per-CTU row time (us) spent on the CTU encoding over the encoded pictures,
+   buf is an array of long long */
+#define XEVE_CFG_GET_ROW_TIME           (706)
 
 /*****************************************************************************
  * NALU types
@@ -295,6 +303,23 @@ typedef struct _XEVE_BITB
 
 } XEVE_BITB;
 
+/*****************************************************************************
+ * NAL unit output (low delay)
+ *****************************************************************************/
+typedef struct _XEVE_NALU_OUT
+{
+    /* called during xeve_encode() with the NAL units (size field included)
+       written in the bitstream buffer since the previous call, once a slice
+       is completed. last is set for the final call of a picture. data is
+       in the bitstream buffer given to xeve_encode(). returning a non-zero
+       value stops the encoding.
+       the output is low delay in the baseline profile only, where a slice
+       is written before the next one is analyzed. the main profile writes
+       the slices after the picture level loop filter */
+    int               (*fn)(void * opaque, void * data, int size, int last);
+    void              * opaque;
+} XEVE_NALU_OUT;
+
 #define XEVE_MAX_NUM_TILE_WIDTH                 120
 #define XEVE_MAX_NUM_TILE_HEIGHT                64
 #define XEVE_MAX_NUM_TILES                      (XEVE_MAX_NUM_TILE_WIDTH * XEVE_MAX_NUM_TILE_HEIGHT)
@@ -329,7 +354,10 @@ typedef struct _XEVE_PARAM
 {
     /* profile : baseline or main */
     int            profile;
-    /* number of thread for parallel proessing */
+    /* number of thread for parallel proessing
+       - XEVE_THREADS_AUTO: use one thread per physical processor core,
+         limited by the parallel tasks of the picture. cores are assumed
+         to be equally fast and cache and NUMA topology are not considered */
     int            threads;
     /* width of input frame */
     int            w;
@@ -364,6 +392,30 @@ typedef struct _XEVE_PARAM
     int            aq_mode;
     /* number of look-ahead frame buffer */
     int            lookahead;
+    /* scene-cut detection threshold (0~100)
+       - 0 : off (default)
+       - N : the anchor of a mini-GOP is coded as an I-picture when the
+             forecast inter cost of a picture in the mini-GOP saves less
+             than N% of its intra cost. ignored with closed GOP */
+    int            scenecut;
+    /* multi-pass rate control
+       - 0 : single pass (default)
+       - 1 : first pass, statistics of every picture are written to rc_stats
+       - 2 : second pass, the bits of the whole sequence are distributed
+             by the statistics read from rc_stats (ABR only) */
+    int            rc_pass;
+    /* the first pass runs only the forecast analysis without encoding.
+       xeve_encode() returns XEVE_OK_OUT_NOT_AVAILABLE for every picture */
+    int            rc_pass_fast;
+    /* file name of the multi-pass rate control statistics */
+    char           rc_stats[256];
+    /* periodic intra refresh (low delay only)
+       - 0 : off (default)
+       - N : a column of CTUs moving from left to right is coded in intra,
+             the whole picture is refreshed every N pictures. inter
+             prediction of the refreshed area is limited to the refreshed
+             area of the reference pictures */
+    int            intra_refresh;
     /* use closed GOP sturcture
        - 0 : use open GOP (default)
        - 1 : use closed GOP */
@@ -402,6 +454,13 @@ typedef struct _XEVE_PARAM
     int            gop_size;
     int            force_output;
     int            use_fcst;
+    /* reference pushed images instead of copying them
+       - 0 : copy the pushed image into an internal buffer (default)
+       - 1 : use the planes of the pushed image directly when they are in the
+             internal format (cs equal to this cs, 16-bit samples, aligned
+             size not smaller than the encoding size). the image is held by
+             addref() and given back by release() once the picture is encoded */
+    int            inbuf_ref;
     int            chroma_format_idc;
     int            cs_w_shift;
     int            cs_h_shift;
@@ -418,6 +477,12 @@ typedef struct _XEVE_PARAM
     int            me_sub;
     int            me_sub_pos;
     int            me_sub_range;
+    /* hierarchical motion pre-search on a downscaled luma pyramid
+       - 0 : no pre-search (default)
+       - 1 : search each CTU on 1/4 and 1/2 resolution luma first and start
+             the integer-pel search also from the result, which replaces the
+             raster search for large motion */
+    int            me_pyramid;
     double         skip_th;             // Use it carefully. If this value is greater than zero, a huge quality drop occurs
     int            merge_num;
     int            rdoq;
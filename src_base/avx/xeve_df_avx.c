@@ -0,0 +1,303 @@
+/* The copyright in this software is being made available under the BSD
+   License, included below. This software may be subject to contributor and
+   other third party rights, including patent rights, and no such rights are
+   granted under this license.
+
+   Copyright (c) 2020, Samsung Electronics Co., Ltd.
+   All Rights Reserved. */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+   
+   - Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+   
+   - Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+   
+   - Neither the name of the copyright owner, nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+   
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+   POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "xeve_type.h"
+
+#if X86_SSE
+
+/* 16-bit lanes stay exact up to 10-bit samples, deeper content goes to C */
+#define DBK_MAX_BIT_DEPTH_AVX   10
+
+/* signed division truncating toward zero, as done by C for s16 values */
+#define DBK_DIV_AVX(x, shift) \
+    _mm256_srai_epi16(_mm256_add_epi16(x, _mm256_and_si256(_mm256_srai_epi16(x, 15), _mm256_set1_epi16((1 << (shift)) - 1))), shift)
+
+#define DBK_CLIP_AVX(x, max) \
+    _mm256_min_epi16(_mm256_max_epi16(x, _mm256_setzero_si256()), max)
+
+/* d1 correction of B and C for each lane, zero where st is zero */
+#define DBK_D1_AVX(A, B, C, D, st, d, d1, clip) \
+{ \
+    __m256i abs_, t16_; \
+    d = _mm256_add_epi16(_mm256_sub_epi16(A, D), _mm256_slli_epi16(_mm256_sub_epi16(C, B), 2)); \
+    d = DBK_DIV_AVX(d, 3); \
+    abs_ = _mm256_abs_epi16(d); \
+    t16_ = _mm256_max_epi16(_mm256_slli_epi16(_mm256_sub_epi16(abs_, st), 1), _mm256_setzero_si256()); \
+    clip = _mm256_max_epi16(_mm256_sub_epi16(abs_, t16_), _mm256_setzero_si256()); \
+    d1 = _mm256_sign_epi16(clip, d); \
+}
+
+#define DBK_LUMA_AVX(A, B, C, D, st, max) \
+{ \
+    __m256i d_, d1_, d2_, clip_; \
+    DBK_D1_AVX(A, B, C, D, st, d_, d1_, clip_); \
+    clip_ = _mm256_srai_epi16(clip_, 1); \
+    d2_ = DBK_DIV_AVX(_mm256_sub_epi16(A, D), 2); \
+    d2_ = _mm256_min_epi16(_mm256_max_epi16(d2_, _mm256_sub_epi16(_mm256_setzero_si256(), clip_)), clip_); \
+    A = DBK_CLIP_AVX(_mm256_sub_epi16(A, d2_), max); \
+    B = DBK_CLIP_AVX(_mm256_add_epi16(B, d1_), max); \
+    C = DBK_CLIP_AVX(_mm256_sub_epi16(C, d1_), max); \
+    D = DBK_CLIP_AVX(_mm256_add_epi16(D, d2_), max); \
+}
+
+#define DBK_CHROMA_AVX(A, B, C, D, st, max) \
+{ \
+    __m256i d_, d1_, clip_; \
+    DBK_D1_AVX(A, B, C, D, st, d_, d1_, clip_); \
+    B = DBK_CLIP_AVX(_mm256_add_epi16(B, d1_), max); \
+    C = DBK_CLIP_AVX(_mm256_sub_epi16(C, d1_), max); \
+}
+
+/* row r of a vertical edge in the low lane and row r + 8 in the high lane */
+#define DBK_LOAD_ROW_PAIR_AVX(buf, stride, r) \
+    _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadl_epi64((__m128i*)((buf) + (r) * (stride) - 2))) \
+                          , _mm_loadl_epi64((__m128i*)((buf) + ((r) + 8) * (stride) - 2)), 1)
+
+/* 16 rows of 4 samples around a vertical edge into A, B, C, D columns */
+#define DBK_LOAD_VER_AVX(buf, stride, A, B, C, D) \
+{ \
+    __m256i r0_, r1_, r2_, r3_, t0_, t1_, t2_, t3_; \
+    r0_ = _mm256_unpacklo_epi16(DBK_LOAD_ROW_PAIR_AVX(buf, stride, 0), DBK_LOAD_ROW_PAIR_AVX(buf, stride, 1)); \
+    r1_ = _mm256_unpacklo_epi16(DBK_LOAD_ROW_PAIR_AVX(buf, stride, 2), DBK_LOAD_ROW_PAIR_AVX(buf, stride, 3)); \
+    r2_ = _mm256_unpacklo_epi16(DBK_LOAD_ROW_PAIR_AVX(buf, stride, 4), DBK_LOAD_ROW_PAIR_AVX(buf, stride, 5)); \
+    r3_ = _mm256_unpacklo_epi16(DBK_LOAD_ROW_PAIR_AVX(buf, stride, 6), DBK_LOAD_ROW_PAIR_AVX(buf, stride, 7)); \
+    t0_ = _mm256_unpacklo_epi32(r0_, r1_); \
+    t1_ = _mm256_unpackhi_epi32(r0_, r1_); \
+    t2_ = _mm256_unpacklo_epi32(r2_, r3_); \
+    t3_ = _mm256_unpackhi_epi32(r2_, r3_); \
+    A = _mm256_unpacklo_epi64(t0_, t2_); \
+    B = _mm256_unpackhi_epi64(t0_, t2_); \
+    C = _mm256_unpacklo_epi64(t1_, t3_); \
+    D = _mm256_unpackhi_epi64(t1_, t3_); \
+}
+
+/* rows r, r + 1 from the low lane and rows r + 8, r + 9 from the high lane */
+#define DBK_STORE_4PEL_AVX(buf, stride, r, v) \
+{ \
+    __m128i lo_ = _mm256_castsi256_si128(v), hi_ = _mm256_extracti128_si256(v, 1); \
+    _mm_storel_epi64((__m128i*)((buf) + (r) * (stride)), lo_); \
+    _mm_storel_epi64((__m128i*)((buf) + ((r) + 1) * (stride)), _mm_srli_si128(lo_, 8)); \
+    _mm_storel_epi64((__m128i*)((buf) + ((r) + 8) * (stride)), hi_); \
+    _mm_storel_epi64((__m128i*)((buf) + ((r) + 9) * (stride)), _mm_srli_si128(hi_, 8)); \
+}
+
+#define DBK_STORE_2PEL_AVX(buf, v, idx) \
+{ \
+    int t_ = _mm_extract_epi32(v, idx); \
+    xeve_mcpy(buf, &t_, sizeof(int)); \
+}
+
+void xeve_dbk_luma_hor_avx(pel *buf, int stride, const s16 *st, int len, int bit_depth)
+{
+    __m256i A, B, C, D, vst, max;
+    pel * p;
+    int i;
+
+    if(bit_depth > DBK_MAX_BIT_DEPTH_AVX)
+    {
+        xeve_dbk_luma_hor(buf, stride, st, len, bit_depth);
+        return;
+    }
+
+    max = _mm256_set1_epi16((1 << bit_depth) - 1);
+
+    for(i = 0; i + 16 <= len; i += 16)
+    {
+        vst = _mm256_loadu_si256((__m256i*)(st + i));
+        if(_mm256_testz_si256(vst, vst))
+        {
+            continue;
+        }
+
+        p = buf + i;
+        A = _mm256_loadu_si256((__m256i*)(p - 2 * stride));
+        B = _mm256_loadu_si256((__m256i*)(p - stride));
+        C = _mm256_loadu_si256((__m256i*)(p));
+        D = _mm256_loadu_si256((__m256i*)(p + stride));
+
+        DBK_LUMA_AVX(A, B, C, D, vst, max);
+
+        _mm256_storeu_si256((__m256i*)(p - 2 * stride), A);
+        _mm256_storeu_si256((__m256i*)(p - stride), B);
+        _mm256_storeu_si256((__m256i*)(p), C);
+        _mm256_storeu_si256((__m256i*)(p + stride), D);
+    }
+
+    if(i < len)
+    {
+        xeve_dbk_luma_hor_sse(buf + i, stride, st + i, len - i, bit_depth);
+    }
+}
+
+void xeve_dbk_chroma_hor_avx(pel *buf, int stride, const s16 *st, int len, int bit_depth)
+{
+    __m256i A, B, C, D, vst, max;
+    pel * p;
+    int i;
+
+    if(bit_depth > DBK_MAX_BIT_DEPTH_AVX)
+    {
+        xeve_dbk_chroma_hor(buf, stride, st, len, bit_depth);
+        return;
+    }
+
+    max = _mm256_set1_epi16((1 << bit_depth) - 1);
+
+    for(i = 0; i + 16 <= len; i += 16)
+    {
+        vst = _mm256_loadu_si256((__m256i*)(st + i));
+        if(_mm256_testz_si256(vst, vst))
+        {
+            continue;
+        }
+
+        p = buf + i;
+        A = _mm256_loadu_si256((__m256i*)(p - 2 * stride));
+        B = _mm256_loadu_si256((__m256i*)(p - stride));
+        C = _mm256_loadu_si256((__m256i*)(p));
+        D = _mm256_loadu_si256((__m256i*)(p + stride));
+
+        DBK_CHROMA_AVX(A, B, C, D, vst, max);
+
+        _mm256_storeu_si256((__m256i*)(p - stride), B);
+        _mm256_storeu_si256((__m256i*)(p), C);
+    }
+
+    if(i < len)
+    {
+        xeve_dbk_chroma_hor_sse(buf + i, stride, st + i, len - i, bit_depth);
+    }
+}
+
+void xeve_dbk_luma_ver_avx(pel *buf, int stride, const s16 *st, int len, int bit_depth)
+{
+    __m256i A, B, C, D, vst, max;
+    __m256i t0, t1, t2, t3;
+    pel * p;
+    int i;
+
+    if(bit_depth > DBK_MAX_BIT_DEPTH_AVX)
+    {
+        xeve_dbk_luma_ver(buf, stride, st, len, bit_depth);
+        return;
+    }
+
+    max = _mm256_set1_epi16((1 << bit_depth) - 1);
+
+    for(i = 0; i + 16 <= len; i += 16)
+    {
+        vst = _mm256_loadu_si256((__m256i*)(st + i));
+        if(_mm256_testz_si256(vst, vst))
+        {
+            continue;
+        }
+
+        p = buf + i * stride;
+        DBK_LOAD_VER_AVX(p, stride, A, B, C, D);
+
+        DBK_LUMA_AVX(A, B, C, D, vst, max);
+
+        t0 = _mm256_unpacklo_epi16(A, B);
+        t1 = _mm256_unpackhi_epi16(A, B);
+        t2 = _mm256_unpacklo_epi16(C, D);
+        t3 = _mm256_unpackhi_epi16(C, D);
+
+        p -= 2;
+        DBK_STORE_4PEL_AVX(p, stride, 0, _mm256_unpacklo_epi32(t0, t2));
+        DBK_STORE_4PEL_AVX(p, stride, 2, _mm256_unpackhi_epi32(t0, t2));
+        DBK_STORE_4PEL_AVX(p, stride, 4, _mm256_unpacklo_epi32(t1, t3));
+        DBK_STORE_4PEL_AVX(p, stride, 6, _mm256_unpackhi_epi32(t1, t3));
+    }
+
+    if(i < len)
+    {
+        xeve_dbk_luma_ver_sse(buf + i * stride, stride, st + i, len - i, bit_depth);
+    }
+}
+
+void xeve_dbk_chroma_ver_avx(pel *buf, int stride, const s16 *st, int len, int bit_depth)
+{
+    __m256i A, B, C, D, vst, max;
+    __m128i bc[4];
+    pel * p;
+    int i, j;
+
+    if(bit_depth > DBK_MAX_BIT_DEPTH_AVX)
+    {
+        xeve_dbk_chroma_ver(buf, stride, st, len, bit_depth);
+        return;
+    }
+
+    max = _mm256_set1_epi16((1 << bit_depth) - 1);
+
+    for(i = 0; i + 16 <= len; i += 16)
+    {
+        vst = _mm256_loadu_si256((__m256i*)(st + i));
+        if(_mm256_testz_si256(vst, vst))
+        {
+            continue;
+        }
+
+        p = buf + i * stride;
+        DBK_LOAD_VER_AVX(p, stride, A, B, C, D);
+
+        DBK_CHROMA_AVX(A, B, C, D, vst, max);
+
+        /* only B and C are written back, neighbouring chroma edges are two samples apart */
+        A = _mm256_unpacklo_epi16(B, C);
+        D = _mm256_unpackhi_epi16(B, C);
+        bc[0] = _mm256_castsi256_si128(A);
+        bc[1] = _mm256_castsi256_si128(D);
+        bc[2] = _mm256_extracti128_si256(A, 1);
+        bc[3] = _mm256_extracti128_si256(D, 1);
+
+        p -= 1;
+        for(j = 0; j < 4; j++)
+        {
+            DBK_STORE_2PEL_AVX(p, bc[j], 0);
+            DBK_STORE_2PEL_AVX(p + stride, bc[j], 1);
+            DBK_STORE_2PEL_AVX(p + 2 * stride, bc[j], 2);
+            DBK_STORE_2PEL_AVX(p + 3 * stride, bc[j], 3);
+            p += 4 * stride;
+        }
+    }
+
+    if(i < len)
+    {
+        xeve_dbk_chroma_ver_sse(buf + i * stride, stride, st + i, len - i, bit_depth);
+    }
+}
+#endif /* X86_SSE */
@@ -29,6 +29,7 @@
 */
 
 #include "xeve_sad_avx.h"
+#include <math.h>
 
 #if X86_SSE
 static int sad_16b_avx_16nx2n(int w, int h, void * src1, void * src2, int s_src1, int s_src2, int bit_depth)
@@ -198,4 +199,292 @@ const XEVE_FN_SAD xeve_tbl_sad_16b_avx[8][8] =
     }
 };
 
+/* SATD **********************************************************************/
+/* the Hadamard kernels keep the differences in 32-bit lanes, one register per
+   row of 8 samples. the vertical butterflies run across the registers and
+   the horizontal ones after a transpose, the coefficient of the first
+   register and lane is the DC */
+#define AVX_HAD_BFLY(a, b) \
+    t = a; \
+    a = _mm256_add_epi32(t, b); \
+    b = _mm256_sub_epi32(t, b)
+
+static void had_8pt_avx(__m256i *x)
+{
+    __m256i t;
+
+    AVX_HAD_BFLY(x[0], x[4]);
+    AVX_HAD_BFLY(x[1], x[5]);
+    AVX_HAD_BFLY(x[2], x[6]);
+    AVX_HAD_BFLY(x[3], x[7]);
+
+    AVX_HAD_BFLY(x[0], x[2]);
+    AVX_HAD_BFLY(x[1], x[3]);
+    AVX_HAD_BFLY(x[4], x[6]);
+    AVX_HAD_BFLY(x[5], x[7]);
+
+    AVX_HAD_BFLY(x[0], x[1]);
+    AVX_HAD_BFLY(x[2], x[3]);
+    AVX_HAD_BFLY(x[4], x[5]);
+    AVX_HAD_BFLY(x[6], x[7]);
+}
+
+static void had_16pt_avx(__m256i *x)
+{
+    __m256i t;
+    int i;
+
+    for(i = 0; i < 8; i++)
+    {
+        AVX_HAD_BFLY(x[i], x[i + 8]);
+    }
+    had_8pt_avx(x);
+    had_8pt_avx(x + 8);
+}
+#undef AVX_HAD_BFLY
+
+static void transpose_8x8_epi32_avx(__m256i *x)
+{
+    __m256i t0, t1, t2, t3, t4, t5, t6, t7;
+    __m256i u0, u1, u2, u3, u4, u5, u6, u7;
+
+    t0 = _mm256_unpacklo_epi32(x[0], x[1]);
+    t1 = _mm256_unpackhi_epi32(x[0], x[1]);
+    t2 = _mm256_unpacklo_epi32(x[2], x[3]);
+    t3 = _mm256_unpackhi_epi32(x[2], x[3]);
+    t4 = _mm256_unpacklo_epi32(x[4], x[5]);
+    t5 = _mm256_unpackhi_epi32(x[4], x[5]);
+    t6 = _mm256_unpacklo_epi32(x[6], x[7]);
+    t7 = _mm256_unpackhi_epi32(x[6], x[7]);
+
+    u0 = _mm256_unpacklo_epi64(t0, t2);
+    u1 = _mm256_unpackhi_epi64(t0, t2);
+    u2 = _mm256_unpacklo_epi64(t1, t3);
+    u3 = _mm256_unpackhi_epi64(t1, t3);
+    u4 = _mm256_unpacklo_epi64(t4, t6);
+    u5 = _mm256_unpackhi_epi64(t4, t6);
+    u6 = _mm256_unpacklo_epi64(t5, t7);
+    u7 = _mm256_unpackhi_epi64(t5, t7);
+
+    x[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+    x[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+    x[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+    x[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+    x[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+    x[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+    x[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+    x[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+/* sum of absolute coefficients with the DC weighted by 1/4 */
+static int had_sum_avx(__m256i *x, int n)
+{
+    __m256i s;
+    __m128i s0;
+    int i, dc;
+
+    dc = XEVE_ABS(_mm_cvtsi128_si32(_mm256_castsi256_si128(x[0])));
+    s = _mm256_abs_epi32(x[0]);
+    for(i = 1; i < n; i++)
+    {
+        s = _mm256_add_epi32(s, _mm256_abs_epi32(x[i]));
+    }
+    s0 = _mm_add_epi32(_mm256_castsi256_si128(s), _mm256_extracti128_si256(s, 1));
+    s0 = _mm_hadd_epi32(s0, s0);
+    s0 = _mm_hadd_epi32(s0, s0);
+
+    return _mm_cvtsi128_si32(s0) - dc + (dc >> 2);
+}
+
+#define AVX_HAD_DIFF_ROW(org, cur) \
+    _mm256_cvtepi16_epi32(_mm_sub_epi16(_mm_loadu_si128((__m128i*)(org)), _mm_loadu_si128((__m128i*)(cur))))
+
+static int had_8x8_avx(pel *org, pel *cur, int s_org, int s_cur, int step, int bit_depth)
+{
+    __m256i x[8];
+    int i;
+
+    for(i = 0; i < 8; i++)
+    {
+        x[i] = AVX_HAD_DIFF_ROW(org + i * s_org, cur + i * s_cur);
+    }
+    had_8pt_avx(x);
+    transpose_8x8_epi32_avx(x);
+    had_8pt_avx(x);
+
+    return ((had_sum_avx(x, 8) + 2) >> 2);
+}
+
+/* the normalization of the rectangular kernels is written as in the SSE
+   kernels of the same bit depth range to keep the rounding identical */
+static int had_16x8_avx(pel *org, pel *cur, int s_org, int s_cur, int step, int bit_depth)
+{
+    __m256i x[16];
+    int i, satd;
+
+    for(i = 0; i < 8; i++)
+    {
+        x[i]     = AVX_HAD_DIFF_ROW(org + i * s_org, cur + i * s_cur);
+        x[i + 8] = AVX_HAD_DIFF_ROW(org + i * s_org + 8, cur + i * s_cur + 8);
+    }
+    had_8pt_avx(x);
+    had_8pt_avx(x + 8);
+    transpose_8x8_epi32_avx(x);
+    transpose_8x8_epi32_avx(x + 8);
+    had_16pt_avx(x);
+
+    satd = had_sum_avx(x, 16);
+    if(bit_depth <= 10)
+    {
+        return (int)(satd / sqrt(16.0 * 8) * 2);
+    }
+    return (int)(satd / (2.0 * sqrt(8.0)));
+}
+
+static int had_8x16_avx(pel *org, pel *cur, int s_org, int s_cur, int step, int bit_depth)
+{
+    __m256i x[16];
+    int i, satd;
+
+    for(i = 0; i < 16; i++)
+    {
+        x[i] = AVX_HAD_DIFF_ROW(org + i * s_org, cur + i * s_cur);
+    }
+    had_16pt_avx(x);
+    transpose_8x8_epi32_avx(x);
+    transpose_8x8_epi32_avx(x + 8);
+    had_8pt_avx(x);
+    had_8pt_avx(x + 8);
+
+    satd = had_sum_avx(x, 16);
+    if(bit_depth <= 10)
+    {
+        return (int)(satd / sqrt(16.0 * 8) * 2);
+    }
+    return (int)(satd / (2.0 * sqrt(8.0)));
+}
+#undef AVX_HAD_DIFF_ROW
+
+static int satd_16b_avx_8nx8n(int w, int h, void * o, void * c, int s_org, int s_cur, int bit_depth)
+{
+    if(bit_depth == 8)
+    {
+        /* keep the rounding of the dedicated 8-bit SSE path */
+        return xeve_had_sse(w, h, o, c, s_org, s_cur, bit_depth);
+    }
+    XEVE_SATD_16B_TILES(had_8x8_avx, 8, 8);
+}
+
+static int satd_16b_avx_16nx8n(int w, int h, void * o, void * c, int s_org, int s_cur, int bit_depth)
+{
+    if(bit_depth == 8)
+    {
+        /* keep the rounding of the dedicated 8-bit SSE path */
+        return xeve_had_sse(w, h, o, c, s_org, s_cur, bit_depth);
+    }
+    XEVE_SATD_16B_TILES(had_16x8_avx, 16, 8);
+}
+
+static int satd_16b_avx_8nx16n(int w, int h, void * o, void * c, int s_org, int s_cur, int bit_depth)
+{
+    if(bit_depth == 8)
+    {
+        /* keep the rounding of the dedicated 8-bit SSE path */
+        return xeve_had_sse(w, h, o, c, s_org, s_cur, bit_depth);
+    }
+    XEVE_SATD_16B_TILES(had_8x16_avx, 8, 16);
+}
+
+/* index: [log2 of width][log2 of height] */
+const XEVE_FN_SATD xeve_tbl_satd_16b_avx[8][8] =
+{
+    /* width == 1 */
+    {
+        xeve_had_sse, /* height == 1 */
+        xeve_had_sse, /* height == 2 */
+        xeve_had_sse, /* height == 4 */
+        xeve_had_sse, /* height == 8 */
+        xeve_had_sse, /* height == 16 */
+        xeve_had_sse, /* height == 32 */
+        xeve_had_sse, /* height == 64 */
+        xeve_had_sse, /* height == 128 */
+    },
+    /* width == 2 */
+    {
+        xeve_had_sse, /* height == 1 */
+        xeve_had_sse, /* height == 2 */
+        xeve_had_sse, /* height == 4 */
+        xeve_had_sse, /* height == 8 */
+        xeve_had_sse, /* height == 16 */
+        xeve_had_sse, /* height == 32 */
+        xeve_had_sse, /* height == 64 */
+        xeve_had_sse, /* height == 128 */
+    },
+    /* width == 4 */
+    {
+        xeve_had_sse,       /* height == 1 */
+        xeve_had_sse,       /* height == 2 */
+        satd_16b_sse_4nx4n, /* height == 4 */
+        satd_16b_sse_4nx8n, /* height == 8 */
+        satd_16b_sse_4nx8n, /* height == 16 */
+        satd_16b_sse_4nx8n, /* height == 32 */
+        satd_16b_sse_4nx8n, /* height == 64 */
+        satd_16b_sse_4nx8n, /* height == 128 */
+    },
+    /* width == 8 */
+    {
+        xeve_had_sse,        /* height == 1 */
+        xeve_had_sse,        /* height == 2 */
+        satd_16b_sse_8nx4n,  /* height == 4 */
+        satd_16b_avx_8nx8n,  /* height == 8 */
+        satd_16b_avx_8nx16n, /* height == 16 */
+        satd_16b_avx_8nx16n, /* height == 32 */
+        satd_16b_avx_8nx16n, /* height == 64 */
+        satd_16b_avx_8nx16n, /* height == 128 */
+    },
+    /* width == 16 */
+    {
+        xeve_had_sse,        /* height == 1 */
+        xeve_had_sse,        /* height == 2 */
+        satd_16b_sse_8nx4n,  /* height == 4 */
+        satd_16b_avx_16nx8n, /* height == 8 */
+        satd_16b_avx_8nx8n,  /* height == 16 */
+        satd_16b_avx_8nx16n, /* height == 32 */
+        satd_16b_avx_8nx16n, /* height == 64 */
+        satd_16b_avx_8nx16n, /* height == 128 */
+    },
+    /* width == 32 */
+    {
+        xeve_had_sse,        /* height == 1 */
+        xeve_had_sse,        /* height == 2 */
+        satd_16b_sse_8nx4n,  /* height == 4 */
+        satd_16b_avx_16nx8n, /* height == 8 */
+        satd_16b_avx_16nx8n, /* height == 16 */
+        satd_16b_avx_8nx8n,  /* height == 32 */
+        satd_16b_avx_8nx16n, /* height == 64 */
+        satd_16b_avx_8nx16n, /* height == 128 */
+    },
+    /* width == 64 */
+    {
+        xeve_had_sse,        /* height == 1 */
+        xeve_had_sse,        /* height == 2 */
+        satd_16b_sse_8nx4n,  /* height == 4 */
+        satd_16b_avx_16nx8n, /* height == 8 */
+        satd_16b_avx_16nx8n, /* height == 16 */
+        satd_16b_avx_16nx8n, /* height == 32 */
+        satd_16b_avx_8nx8n,  /* height == 64 */
+        satd_16b_avx_8nx16n, /* height == 128 */
+    },
+    /* width == 128 */
+    {
+        xeve_had_sse,        /* height == 1 */
+        xeve_had_sse,        /* height == 2 */
+        satd_16b_sse_8nx4n,  /* height == 4 */
+        satd_16b_avx_16nx8n, /* height == 8 */
+        satd_16b_avx_16nx8n, /* height == 16 */
+        satd_16b_avx_16nx8n, /* height == 32 */
+        satd_16b_avx_16nx8n, /* height == 64 */
+        satd_16b_avx_8nx8n,  /* height == 128 */
+    }
+};
 #endif
\ No newline at end of file
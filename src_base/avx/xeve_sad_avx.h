@@ -36,5 +36,6 @@
 
 #if X86_SSE
 extern const XEVE_FN_SAD xeve_tbl_sad_16b_avx[8][8];
+extern const XEVE_FN_SATD xeve_tbl_satd_16b_avx[8][8];
 #endif /* X86_SSE */
 #endif /* _XEVE_SAD_AVX_H_ */
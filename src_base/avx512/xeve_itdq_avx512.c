@@ -0,0 +1,135 @@
+/* Copyright (c) 2020, Samsung Electronics Co., Ltd.
+   All Rights Reserved. */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+   - Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+   - Neither the name of the copyright owner, nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+   POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "xeve_def.h"
+#include "xeve_tbl.h"
+#include "xeve_itdq_avx512.h"
+
+#if X86_SSE
+/* first stage of the inverse transform for 16 outputs per register. pairs of
+   input coefficients are broadcast and multiplied by the interleaved rows of
+   the transform matrix, the sums fit in 32 bits so ITX_CLIP_32 is not needed */
+static void itx_pb_step0_avx512(s16 *src, s32 *dst, const s8 *tm, int size, int shift, int line)
+{
+    __m512i cv[32][4], acc[4], p, r0;
+    __m512i add = _mm512_set1_epi32(shift == 0 ? 0 : 1 << (shift - 1));
+    __m512i idx = _mm512_set_epi16(31, 15, 30, 14, 29, 13, 28, 12, 27, 11, 26, 10, 25, 9, 24, 8,
+                                   23,  7, 22,  6, 21,  5, 20,  4, 19,  3, 18,  2, 17, 1, 16, 0);
+    int npair = size >> 1;
+    int nvec = size >> 4;
+    int j, m, v;
+
+    for(m = 0; m < npair; m++)
+    {
+        for(v = 0; v < nvec; v++)
+        {
+            r0 = _mm512_inserti64x4(_mm512_castsi256_si512(_mm256_cvtepi8_epi16(_mm_loadu_si128((__m128i*)(tm + 2 * m * size + v * 16)))),
+                                    _mm256_cvtepi8_epi16(_mm_loadu_si128((__m128i*)(tm + (2 * m + 1) * size + v * 16))), 1);
+            cv[m][v] = _mm512_permutexvar_epi16(idx, r0);
+        }
+    }
+
+    for(j = 0; j < line; j++)
+    {
+        for(v = 0; v < nvec; v++)
+        {
+            acc[v] = add;
+        }
+        for(m = 0; m < npair; m++)
+        {
+            p = _mm512_set1_epi32((src[2 * m * line + j] & 0xFFFF) | ((u32)src[(2 * m + 1) * line + j] << 16));
+            for(v = 0; v < nvec; v++)
+            {
+                acc[v] = _mm512_add_epi32(acc[v], _mm512_madd_epi16(p, cv[m][v]));
+            }
+        }
+        for(v = 0; v < nvec; v++)
+        {
+            _mm512_storeu_si512((__m512i*)(dst + j * size + v * 16), _mm512_srai_epi32(acc[v], shift));
+        }
+    }
+}
+
+static void itx_pb4b_avx512(void *src, void *dst, int shift, int line, int step)
+{
+    xeve_tbl_itxb_avx[1](src, dst, shift, line, step);
+}
+
+static void itx_pb8b_avx512(void *src, void *dst, int shift, int line, int step)
+{
+    xeve_tbl_itxb_avx[2](src, dst, shift, line, step);
+}
+
+static void itx_pb16b_avx512(void *src, void *dst, int shift, int line, int step)
+{
+    if(step == 0)
+    {
+        itx_pb_step0_avx512((s16*)src, (s32*)dst, xeve_tbl_tm16[0], 16, shift, line);
+    }
+    else
+    {
+        xeve_tbl_itxb_avx[3](src, dst, shift, line, step);
+    }
+}
+
+static void itx_pb32b_avx512(void *src, void *dst, int shift, int line, int step)
+{
+    if(step == 0)
+    {
+        itx_pb_step0_avx512((s16*)src, (s32*)dst, xeve_tbl_tm32[0], 32, shift, line);
+    }
+    else
+    {
+        xeve_tbl_itxb_avx[4](src, dst, shift, line, step);
+    }
+}
+
+static void itx_pb64b_avx512(void *src, void *dst, int shift, int line, int step)
+{
+    if(step == 0)
+    {
+        itx_pb_step0_avx512((s16*)src, (s32*)dst, xeve_tbl_tm64[0], 64, shift, line);
+    }
+    else
+    {
+        xeve_tbl_itxb_avx[5](src, dst, shift, line, step);
+    }
+}
+
+const XEVE_ITXB xeve_tbl_itxb_avx512[MAX_TR_LOG2] =
+{
+    xeve_itx_pb2b,
+    itx_pb4b_avx512,
+    itx_pb8b_avx512,
+    itx_pb16b_avx512,
+    itx_pb32b_avx512,
+    itx_pb64b_avx512
+};
+#endif /* X86_SSE */
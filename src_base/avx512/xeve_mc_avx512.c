@@ -0,0 +1,253 @@
+/* Copyright (c) 2020, Samsung Electronics Co., Ltd.
+   All Rights Reserved. */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+   
+   - Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+   
+   - Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+   
+   - Neither the name of the copyright owner, nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+   
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+   POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "xeve_mc_avx512.h"
+
+#if X86_SSE
+
+/* horizontal n-tap filter for widths of multiple of 16. the output samples
+   are computed in 32-bit lanes, each lane gathering its pairs of input
+   samples from one row load with a word permutation */
+static void mc_filter_horz_avx512(s16 *ref, int s_ref, s16 *pred, int s_pred, const s16 *coeff, int ntap
+                                , int width, int height, int max_val, int offset, int shift, int is_last)
+{
+    __m512i idx[4], c[4], r0, acc;
+    __m512i mn = _mm512_setzero_si512();
+    __m512i mx = _mm512_set1_epi32(max_val);
+    __m512i off = _mm512_set1_epi32(offset);
+    __m512i idx0 = _mm512_set_epi16(16, 15, 15, 14, 14, 13, 13, 12, 12, 11, 11, 10, 10, 9, 9, 8,
+                                     8,  7,  7,  6,  6,  5,  5,  4,  4,  3,  3,  2,  2, 1, 1, 0);
+    __mmask32 ld = (__mmask32)((1u << (15 + ntap)) - 1);
+    int i, j, t;
+
+    for(t = 0; t < (ntap >> 1); t++)
+    {
+        idx[t] = _mm512_add_epi16(idx0, _mm512_set1_epi16(t << 1));
+        c[t] = _mm512_set1_epi32((coeff[2 * t] & 0xFFFF) | ((u32)coeff[2 * t + 1] << 16));
+    }
+
+    for(i = 0; i < height; i++)
+    {
+        for(j = 0; j < width; j += 16)
+        {
+            r0 = _mm512_maskz_loadu_epi16(ld, ref + j);
+            acc = _mm512_madd_epi16(_mm512_permutexvar_epi16(idx[0], r0), c[0]);
+            for(t = 1; t < (ntap >> 1); t++)
+            {
+                acc = _mm512_add_epi32(acc, _mm512_madd_epi16(_mm512_permutexvar_epi16(idx[t], r0), c[t]));
+            }
+            acc = _mm512_srai_epi32(_mm512_add_epi32(acc, off), shift);
+            if(is_last)
+            {
+                acc = _mm512_min_epi32(_mm512_max_epi32(acc, mn), mx);
+            }
+            _mm256_storeu_si256((__m256i*)(pred + j), _mm512_cvtepi32_epi16(acc));
+        }
+        ref += s_ref;
+        pred += s_pred;
+    }
+}
+
+/* vertical n-tap filter with clipping for widths of multiple of 16. two
+   rows are interleaved into one register to be multiplied by a pair of
+   filter taps */
+static void mc_filter_vert_avx512(s16 *ref, int s_ref, s16 *pred, int s_pred, const s16 *coeff, int ntap
+                                , int width, int height, int max_val, int offset, int shift)
+{
+    __m512i c[4], r0, acc;
+    __m512i mn = _mm512_setzero_si512();
+    __m512i mx = _mm512_set1_epi32(max_val);
+    __m512i off = _mm512_set1_epi32(offset);
+    __m512i idx = _mm512_set_epi16(31, 15, 30, 14, 29, 13, 28, 12, 27, 11, 26, 10, 25, 9, 24, 8,
+                                   23,  7, 22,  6, 21,  5, 20,  4, 19,  3, 18,  2, 17, 1, 16, 0);
+    s16 *r;
+    int i, j, t;
+
+    for(t = 0; t < (ntap >> 1); t++)
+    {
+        c[t] = _mm512_set1_epi32((coeff[2 * t] & 0xFFFF) | ((u32)coeff[2 * t + 1] << 16));
+    }
+
+    for(i = 0; i < height; i++)
+    {
+        for(j = 0; j < width; j += 16)
+        {
+            r = ref + j;
+            acc = off;
+            for(t = 0; t < (ntap >> 1); t++)
+            {
+                r0 = _mm512_inserti64x4(_mm512_castsi256_si512(_mm256_loadu_si256((__m256i*)r)), _mm256_loadu_si256((__m256i*)(r + s_ref)), 1);
+                acc = _mm512_add_epi32(acc, _mm512_madd_epi16(_mm512_permutexvar_epi16(idx, r0), c[t]));
+                r += s_ref * 2;
+            }
+            acc = _mm512_srai_epi32(acc, shift);
+            acc = _mm512_min_epi32(_mm512_max_epi32(acc, mn), mx);
+            _mm256_storeu_si256((__m256i*)(pred + j), _mm512_cvtepi32_epi16(acc));
+        }
+        ref += s_ref;
+        pred += s_pred;
+    }
+}
+
+/****************************************************************************
+ * motion compensation for luma
+ ****************************************************************************/
+static void mc_l_n0_avx512(pel *ref, int gmv_x, int gmv_y, int s_ref, int s_pred, pel *pred, int w, int h, int bit_depth, const s16(*mc_l_coeff)[8])
+{
+    if(w & 15)
+    {
+        xeve_tbl_mc_l_avx[1][0](ref, gmv_x, gmv_y, s_ref, s_pred, pred, w, h, bit_depth, mc_l_coeff);
+        return;
+    }
+
+    int dx = gmv_x & 15;
+    ref += (gmv_y >> 4) * s_ref + (gmv_x >> 4) - 3;
+
+    mc_filter_horz_avx512(ref, s_ref, pred, s_pred, mc_l_coeff[dx], 8, w, h, (1 << bit_depth) - 1, MAC_ADD_N0, MAC_SFT_N0, 1);
+}
+
+static void mc_l_0n_avx512(pel *ref, int gmv_x, int gmv_y, int s_ref, int s_pred, pel *pred, int w, int h, int bit_depth, const s16(*mc_l_coeff)[8])
+{
+    if(w & 15)
+    {
+        xeve_tbl_mc_l_avx[0][1](ref, gmv_x, gmv_y, s_ref, s_pred, pred, w, h, bit_depth, mc_l_coeff);
+        return;
+    }
+
+    int dy = gmv_y & 15;
+    ref += ((gmv_y >> 4) - 3) * s_ref + (gmv_x >> 4);
+
+    mc_filter_vert_avx512(ref, s_ref, pred, s_pred, mc_l_coeff[dy], 8, w, h, (1 << bit_depth) - 1, MAC_ADD_0N, MAC_SFT_0N);
+}
+
+static void mc_l_nn_avx512(s16 *ref, int gmv_x, int gmv_y, int s_ref, int s_pred, s16 *pred, int w, int h, int bit_depth, const s16(*mc_l_coeff)[8])
+{
+    if(w & 15)
+    {
+        xeve_tbl_mc_l_avx[1][1](ref, gmv_x, gmv_y, s_ref, s_pred, pred, w, h, bit_depth, mc_l_coeff);
+        return;
+    }
+
+    s16         buf[(MAX_CU_SIZE + MC_IBUF_PAD_L)*(MAX_CU_SIZE + MC_IBUF_PAD_L)];
+    int         dx, dy;
+
+    dx = gmv_x & 15;
+    dy = gmv_y & 15;
+    ref += ((gmv_y >> 4) - 3) * s_ref + (gmv_x >> 4) - 3;
+
+    int shift1 = XEVE_MIN(4, bit_depth - 8);
+    int shift2 = XEVE_MAX(8, 20 - bit_depth);
+    int offset1 = 0;
+    int offset2 = (1 << (shift2 - 1));
+
+    mc_filter_horz_avx512(ref, s_ref, buf, w, mc_l_coeff[dx], 8, w, h + 7, 0, offset1, shift1, 0);
+    mc_filter_vert_avx512(buf, w, pred, s_pred, mc_l_coeff[dy], 8, w, h, (1 << bit_depth) - 1, offset2, shift2);
+}
+
+/****************************************************************************
+ * motion compensation for chroma
+ ****************************************************************************/
+static void mc_c_n0_avx512(s16 *ref, int gmv_x, int gmv_y, int s_ref, int s_pred, s16 *pred, int w, int h, int bit_depth, const s16(*mc_c_coeff)[4])
+{
+    if(w & 15)
+    {
+        xeve_tbl_mc_c_avx[1][0](ref, gmv_x, gmv_y, s_ref, s_pred, pred, w, h, bit_depth, mc_c_coeff);
+        return;
+    }
+
+    int dx = gmv_x & 31;
+    ref += (gmv_y >> 5) * s_ref + (gmv_x >> 5) - 1;
+
+    mc_filter_horz_avx512(ref, s_ref, pred, s_pred, mc_c_coeff[dx], 4, w, h, (1 << bit_depth) - 1, MAC_ADD_N0, MAC_SFT_N0, 1);
+}
+
+static void mc_c_0n_avx512(s16 *ref, int gmv_x, int gmv_y, int s_ref, int s_pred, s16 *pred, int w, int h, int bit_depth, const s16(*mc_c_coeff)[4])
+{
+    if(w & 15)
+    {
+        xeve_tbl_mc_c_avx[0][1](ref, gmv_x, gmv_y, s_ref, s_pred, pred, w, h, bit_depth, mc_c_coeff);
+        return;
+    }
+
+    int dy = gmv_y & 31;
+    ref += ((gmv_y >> 5) - 1) * s_ref + (gmv_x >> 5);
+
+    mc_filter_vert_avx512(ref, s_ref, pred, s_pred, mc_c_coeff[dy], 4, w, h, (1 << bit_depth) - 1, MAC_ADD_0N, MAC_SFT_0N);
+}
+
+static void mc_c_nn_avx512(s16 *ref, int gmv_x, int gmv_y, int s_ref, int s_pred, s16 *pred, int w, int h, int bit_depth, const s16(*mc_c_coeff)[4])
+{
+    if(w & 15)
+    {
+        xeve_tbl_mc_c_avx[1][1](ref, gmv_x, gmv_y, s_ref, s_pred, pred, w, h, bit_depth, mc_c_coeff);
+        return;
+    }
+
+    s16 buf[(MAX_CU_SIZE + MC_IBUF_PAD_C)*MAX_CU_SIZE];
+    int dx, dy;
+
+    dx = gmv_x & 31;
+    dy = gmv_y & 31;
+    ref += ((gmv_y >> 5) - 1) * s_ref + (gmv_x >> 5) - 1;
+
+    int shift1 = XEVE_MIN(4, bit_depth - 8);
+    int shift2 = XEVE_MAX(8, 20 - bit_depth);
+    int offset1 = 0;
+    int offset2 = (1 << (shift2 - 1));
+
+    mc_filter_horz_avx512(ref, s_ref, buf, w, mc_c_coeff[dx], 4, w, h + 3, 0, offset1, shift1, 0);
+    mc_filter_vert_avx512(buf, w, pred, s_pred, mc_c_coeff[dy], 4, w, h, (1 << bit_depth) - 1, offset2, shift2);
+}
+
+const XEVE_MC_L xeve_tbl_mc_l_avx512[2][2] =
+{
+    {
+        xeve_mc_l_00,    /* dx == 0 && dy == 0 */
+        mc_l_0n_avx512   /* dx == 0 && dy != 0 */
+    },
+    {
+        mc_l_n0_avx512,  /* dx != 0 && dy == 0 */
+        mc_l_nn_avx512   /* dx != 0 && dy != 0 */
+    }
+};
+
+const XEVE_MC_C xeve_tbl_mc_c_avx512[2][2] =
+{
+    {
+        xeve_mc_c_00,    /* dx == 0 && dy == 0 */
+        mc_c_0n_avx512   /* dx == 0 && dy != 0 */
+    },
+    {
+        mc_c_n0_avx512,  /* dx != 0 && dy == 0 */
+        mc_c_nn_avx512   /* dx != 0 && dy != 0 */
+    }
+};
+
+#endif /* X86_SSE */
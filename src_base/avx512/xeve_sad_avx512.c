@@ -0,0 +1,479 @@
+/* Copyright (c) 2020, Samsung Electronics Co., Ltd.
+   All Rights Reserved. */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+   
+   - Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+   
+   - Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+   
+   - Neither the name of the copyright owner, nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+   
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+   POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "xeve_sad_avx512.h"
+
+#if X86_SSE
+/* SAD for 16-bit samples, the width is a multiple of 16. a trailing
+   16-sample column is loaded with a mask */
+static int sad_16b_avx512_16nx1n(int w, int h, void * src1, void * src2, int s_src1, int s_src2, int bit_depth)
+{
+    s16 * s1;
+    s16 * s2;
+    __m512i s00, s01, sac0;
+    __m512i one = _mm512_set1_epi16(1);
+    __mmask32 tail = (w & 16) ? 0xFFFF : 0;
+    int w32 = w & ~31;
+    int i, j;
+
+    assert(!(w & 15));
+
+    s1 = (s16 *)src1;
+    s2 = (s16 *)src2;
+
+    sac0 = _mm512_setzero_si512();
+
+    for(i = 0; i < h; i++)
+    {
+        for(j = 0; j < w32; j += 32)
+        {
+            s00 = _mm512_loadu_si512((__m512i*)(s1 + j));
+            s01 = _mm512_loadu_si512((__m512i*)(s2 + j));
+            s00 = _mm512_abs_epi16(_mm512_sub_epi16(s00, s01));
+            sac0 = _mm512_add_epi32(sac0, _mm512_madd_epi16(s00, one));
+        }
+        if(tail)
+        {
+            s00 = _mm512_maskz_loadu_epi16(tail, s1 + w32);
+            s01 = _mm512_maskz_loadu_epi16(tail, s2 + w32);
+            s00 = _mm512_abs_epi16(_mm512_sub_epi16(s00, s01));
+            sac0 = _mm512_add_epi32(sac0, _mm512_madd_epi16(s00, one));
+        }
+        s1 += s_src1;
+        s2 += s_src2;
+    }
+
+    return (_mm512_reduce_add_epi32(sac0) >> (bit_depth - 8));
+}
+
+/* SAD for 16-bit samples of 16-wide blocks, two rows per register */
+static int sad_16b_avx512_16x2n(int w, int h, void * src1, void * src2, int s_src1, int s_src2, int bit_depth)
+{
+    s16 * s1;
+    s16 * s2;
+    __m512i s00, s01, sac0;
+    __m512i one = _mm512_set1_epi16(1);
+    int i;
+
+    assert(w == 16 && !(h & 1));
+
+    s1 = (s16 *)src1;
+    s2 = (s16 *)src2;
+
+    sac0 = _mm512_setzero_si512();
+
+    for(i = 0; i < h; i += 2)
+    {
+        s00 = _mm512_inserti64x4(_mm512_castsi256_si512(_mm256_loadu_si256((__m256i*)s1)), _mm256_loadu_si256((__m256i*)(s1 + s_src1)), 1);
+        s01 = _mm512_inserti64x4(_mm512_castsi256_si512(_mm256_loadu_si256((__m256i*)s2)), _mm256_loadu_si256((__m256i*)(s2 + s_src2)), 1);
+        s00 = _mm512_abs_epi16(_mm512_sub_epi16(s00, s01));
+        sac0 = _mm512_add_epi32(sac0, _mm512_madd_epi16(s00, one));
+        s1 += s_src1 * 2;
+        s2 += s_src2 * 2;
+    }
+
+    return (_mm512_reduce_add_epi32(sac0) >> (bit_depth - 8));
+}
+
+/* SSD **********************************************************************/
+/* the squares are shifted one by one as in ssd_16b(), so the even and odd
+   samples of a register are squared separately */
+static s64 ssd_16b_avx512_16nx1n(int w, int h, void * src1, void * src2, int s_src1, int s_src2, int bit_depth)
+{
+    s16 * s1;
+    s16 * s2;
+    const int shift = (bit_depth - 8) << 1;
+    __m512i s00, s01, s02, sac0;
+    __m512i lo = _mm512_set1_epi32(0xFFFF);
+    __mmask32 tail = (w & 16) ? 0xFFFF : 0;
+    int w32 = w & ~31;
+    int i, j;
+
+    assert(!(w & 15));
+
+    s1 = (s16 *)src1;
+    s2 = (s16 *)src2;
+
+    sac0 = _mm512_setzero_si512();
+
+#define AVX512_SSD_16B_32PEL(s00, s01) \
+    s00 = _mm512_sub_epi16(s00, s01); \
+    s01 = _mm512_and_si512(s00, lo); \
+    s02 = _mm512_srli_epi32(s00, 16); \
+    s01 = _mm512_srli_epi32(_mm512_madd_epi16(s01, s01), shift); \
+    s02 = _mm512_srli_epi32(_mm512_madd_epi16(s02, s02), shift); \
+    sac0 = _mm512_add_epi32(sac0, _mm512_add_epi32(s01, s02))
+
+    for(i = 0; i < h; i++)
+    {
+        for(j = 0; j < w32; j += 32)
+        {
+            s00 = _mm512_loadu_si512((__m512i*)(s1 + j));
+            s01 = _mm512_loadu_si512((__m512i*)(s2 + j));
+            AVX512_SSD_16B_32PEL(s00, s01);
+        }
+        if(tail)
+        {
+            s00 = _mm512_maskz_loadu_epi16(tail, s1 + w32);
+            s01 = _mm512_maskz_loadu_epi16(tail, s2 + w32);
+            AVX512_SSD_16B_32PEL(s00, s01);
+        }
+        s1 += s_src1;
+        s2 += s_src2;
+    }
+#undef AVX512_SSD_16B_32PEL
+
+    return (s64)(u32)_mm512_reduce_add_epi32(sac0);
+}
+
+static s64 ssd_16b_avx512_sse(int w, int h, void * src1, void * src2, int s_src1, int s_src2, int bit_depth)
+{
+    return xeve_tbl_ssd_16b_sse[XEVE_LOG2(w)][XEVE_LOG2(h)](w, h, src1, src2, s_src1, s_src2, bit_depth);
+}
+
+/* DIFF **********************************************************************/
+static void diff_16b_avx512_16nx1n(int w, int h, void * src1, void * src2, int s_src1, int s_src2, int s_diff, s16 * diff, int bit_depth)
+{
+    s16 * s1;
+    s16 * s2;
+    __m512i s00, s01;
+    __mmask32 tail = (w & 16) ? 0xFFFF : 0;
+    int w32 = w & ~31;
+    int i, j;
+
+    assert(!(w & 15));
+
+    s1 = (s16 *)src1;
+    s2 = (s16 *)src2;
+
+    for(i = 0; i < h; i++)
+    {
+        for(j = 0; j < w32; j += 32)
+        {
+            s00 = _mm512_loadu_si512((__m512i*)(s1 + j));
+            s01 = _mm512_loadu_si512((__m512i*)(s2 + j));
+            _mm512_storeu_si512((__m512i*)(diff + j), _mm512_sub_epi16(s00, s01));
+        }
+        if(tail)
+        {
+            s00 = _mm512_maskz_loadu_epi16(tail, s1 + w32);
+            s01 = _mm512_maskz_loadu_epi16(tail, s2 + w32);
+            _mm512_mask_storeu_epi16(diff + w32, tail, _mm512_sub_epi16(s00, s01));
+        }
+        s1 += s_src1;
+        s2 += s_src2;
+        diff += s_diff;
+    }
+}
+
+static void diff_16b_avx512_sse(int w, int h, void * src1, void * src2, int s_src1, int s_src2, int s_diff, s16 * diff, int bit_depth)
+{
+    xeve_tbl_diff_16b_sse[XEVE_LOG2(w)][XEVE_LOG2(h)](w, h, src1, src2, s_src1, s_src2, s_diff, diff, bit_depth);
+}
+
+/* index: [log2 of width][log2 of height] */
+const XEVE_FN_SAD xeve_tbl_sad_16b_avx512[8][8] =
+{
+    /* width == 1 */
+    {
+        sad_16b, /* height == 1 */
+        sad_16b, /* height == 2 */
+        sad_16b, /* height == 4 */
+        sad_16b, /* height == 8 */
+        sad_16b, /* height == 16 */
+        sad_16b, /* height == 32 */
+        sad_16b, /* height == 64 */
+        sad_16b, /* height == 128 */
+    },
+    /* width == 2 */
+    {
+        sad_16b, /* height == 1 */
+        sad_16b, /* height == 2 */
+        sad_16b, /* height == 4 */
+        sad_16b, /* height == 8 */
+        sad_16b, /* height == 16 */
+        sad_16b, /* height == 32 */
+        sad_16b, /* height == 64 */
+        sad_16b, /* height == 128 */
+    },
+    /* width == 4 */
+    {
+        sad_16b,          /* height == 1 */
+        sad_16b_sse_4x2,  /* height == 2 */
+        sad_16b_sse_4x4,  /* height == 4 */
+        sad_16b_sse_4x2n, /* height == 8 */
+        sad_16b_sse_4x2n, /* height == 16 */
+        sad_16b_sse_4x2n, /* height == 32 */
+        sad_16b_sse_4x2n, /* height == 64 */
+        sad_16b_sse_4x2n, /* height == 128 */
+    },
+    /* width == 8 */
+    {
+        sad_16b,          /* height == 1 */
+        sad_16b_sse_8x2n, /* height == 2 */
+        sad_16b_sse_8x2n, /* height == 4 */
+        sad_16b_sse_8x2n, /* height == 8 */
+        sad_16b_sse_8x2n, /* height == 16 */
+        sad_16b_sse_8x2n, /* height == 32 */
+        sad_16b_sse_8x2n, /* height == 64 */
+        sad_16b_sse_8x2n, /* height == 128 */
+    },
+    /* width == 16 */
+    {
+        sad_16b_avx512_16nx1n, /* height == 1 */
+        sad_16b_avx512_16x2n,  /* height == 2 */
+        sad_16b_avx512_16x2n,  /* height == 4 */
+        sad_16b_avx512_16x2n,  /* height == 8 */
+        sad_16b_avx512_16x2n,  /* height == 16 */
+        sad_16b_avx512_16x2n,  /* height == 32 */
+        sad_16b_avx512_16x2n,  /* height == 64 */
+        sad_16b_avx512_16x2n,  /* height == 128 */
+    },
+    /* width == 32 */
+    {
+        sad_16b_avx512_16nx1n, /* height == 1 */
+        sad_16b_avx512_16nx1n, /* height == 2 */
+        sad_16b_avx512_16nx1n, /* height == 4 */
+        sad_16b_avx512_16nx1n, /* height == 8 */
+        sad_16b_avx512_16nx1n, /* height == 16 */
+        sad_16b_avx512_16nx1n, /* height == 32 */
+        sad_16b_avx512_16nx1n, /* height == 64 */
+        sad_16b_avx512_16nx1n, /* height == 128 */
+    },
+    /* width == 64 */
+    {
+        sad_16b_avx512_16nx1n, /* height == 1 */
+        sad_16b_avx512_16nx1n, /* height == 2 */
+        sad_16b_avx512_16nx1n, /* height == 4 */
+        sad_16b_avx512_16nx1n, /* height == 8 */
+        sad_16b_avx512_16nx1n, /* height == 16 */
+        sad_16b_avx512_16nx1n, /* height == 32 */
+        sad_16b_avx512_16nx1n, /* height == 64 */
+        sad_16b_avx512_16nx1n, /* height == 128 */
+    },
+    /* width == 128 */
+    {
+        sad_16b_avx512_16nx1n, /* height == 1 */
+        sad_16b_avx512_16nx1n, /* height == 2 */
+        sad_16b_avx512_16nx1n, /* height == 4 */
+        sad_16b_avx512_16nx1n, /* height == 8 */
+        sad_16b_avx512_16nx1n, /* height == 16 */
+        sad_16b_avx512_16nx1n, /* height == 32 */
+        sad_16b_avx512_16nx1n, /* height == 64 */
+        sad_16b_avx512_16nx1n, /* height == 128 */
+    }
+};
+
+/* index: [log2 of width][log2 of height] */
+const XEVE_FN_SSD xeve_tbl_ssd_16b_avx512[8][8] =
+{
+    /* width == 1 */
+    {
+        ssd_16b_avx512_sse, /* height == 1 */
+        ssd_16b_avx512_sse, /* height == 2 */
+        ssd_16b_avx512_sse, /* height == 4 */
+        ssd_16b_avx512_sse, /* height == 8 */
+        ssd_16b_avx512_sse, /* height == 16 */
+        ssd_16b_avx512_sse, /* height == 32 */
+        ssd_16b_avx512_sse, /* height == 64 */
+        ssd_16b_avx512_sse, /* height == 128 */
+    },
+    /* width == 2 */
+    {
+        ssd_16b_avx512_sse, /* height == 1 */
+        ssd_16b_avx512_sse, /* height == 2 */
+        ssd_16b_avx512_sse, /* height == 4 */
+        ssd_16b_avx512_sse, /* height == 8 */
+        ssd_16b_avx512_sse, /* height == 16 */
+        ssd_16b_avx512_sse, /* height == 32 */
+        ssd_16b_avx512_sse, /* height == 64 */
+        ssd_16b_avx512_sse, /* height == 128 */
+    },
+    /* width == 4 */
+    {
+        ssd_16b_avx512_sse, /* height == 1 */
+        ssd_16b_avx512_sse, /* height == 2 */
+        ssd_16b_avx512_sse, /* height == 4 */
+        ssd_16b_avx512_sse, /* height == 8 */
+        ssd_16b_avx512_sse, /* height == 16 */
+        ssd_16b_avx512_sse, /* height == 32 */
+        ssd_16b_avx512_sse, /* height == 64 */
+        ssd_16b_avx512_sse, /* height == 128 */
+    },
+    /* width == 8 */
+    {
+        ssd_16b_avx512_sse, /* height == 1 */
+        ssd_16b_avx512_sse, /* height == 2 */
+        ssd_16b_avx512_sse, /* height == 4 */
+        ssd_16b_avx512_sse, /* height == 8 */
+        ssd_16b_avx512_sse, /* height == 16 */
+        ssd_16b_avx512_sse, /* height == 32 */
+        ssd_16b_avx512_sse, /* height == 64 */
+        ssd_16b_avx512_sse, /* height == 128 */
+    },
+    /* width == 16 */
+    {
+        ssd_16b_avx512_16nx1n, /* height == 1 */
+        ssd_16b_avx512_16nx1n, /* height == 2 */
+        ssd_16b_avx512_16nx1n, /* height == 4 */
+        ssd_16b_avx512_16nx1n, /* height == 8 */
+        ssd_16b_avx512_16nx1n, /* height == 16 */
+        ssd_16b_avx512_16nx1n, /* height == 32 */
+        ssd_16b_avx512_16nx1n, /* height == 64 */
+        ssd_16b_avx512_16nx1n, /* height == 128 */
+    },
+    /* width == 32 */
+    {
+        ssd_16b_avx512_16nx1n, /* height == 1 */
+        ssd_16b_avx512_16nx1n, /* height == 2 */
+        ssd_16b_avx512_16nx1n, /* height == 4 */
+        ssd_16b_avx512_16nx1n, /* height == 8 */
+        ssd_16b_avx512_16nx1n, /* height == 16 */
+        ssd_16b_avx512_16nx1n, /* height == 32 */
+        ssd_16b_avx512_16nx1n, /* height == 64 */
+        ssd_16b_avx512_16nx1n, /* height == 128 */
+    },
+    /* width == 64 */
+    {
+        ssd_16b_avx512_16nx1n, /* height == 1 */
+        ssd_16b_avx512_16nx1n, /* height == 2 */
+        ssd_16b_avx512_16nx1n, /* height == 4 */
+        ssd_16b_avx512_16nx1n, /* height == 8 */
+        ssd_16b_avx512_16nx1n, /* height == 16 */
+        ssd_16b_avx512_16nx1n, /* height == 32 */
+        ssd_16b_avx512_16nx1n, /* height == 64 */
+        ssd_16b_avx512_16nx1n, /* height == 128 */
+    },
+    /* width == 128 */
+    {
+        ssd_16b_avx512_16nx1n, /* height == 1 */
+        ssd_16b_avx512_16nx1n, /* height == 2 */
+        ssd_16b_avx512_16nx1n, /* height == 4 */
+        ssd_16b_avx512_16nx1n, /* height == 8 */
+        ssd_16b_avx512_16nx1n, /* height == 16 */
+        ssd_16b_avx512_16nx1n, /* height == 32 */
+        ssd_16b_avx512_16nx1n, /* height == 64 */
+        ssd_16b_avx512_16nx1n, /* height == 128 */
+    }
+};
+
+/* index: [log2 of width][log2 of height] */
+const XEVE_FN_DIFF xeve_tbl_diff_16b_avx512[8][8] =
+{
+    /* width == 1 */
+    {
+        diff_16b_avx512_sse, /* height == 1 */
+        diff_16b_avx512_sse, /* height == 2 */
+        diff_16b_avx512_sse, /* height == 4 */
+        diff_16b_avx512_sse, /* height == 8 */
+        diff_16b_avx512_sse, /* height == 16 */
+        diff_16b_avx512_sse, /* height == 32 */
+        diff_16b_avx512_sse, /* height == 64 */
+        diff_16b_avx512_sse, /* height == 128 */
+    },
+    /* width == 2 */
+    {
+        diff_16b_avx512_sse, /* height == 1 */
+        diff_16b_avx512_sse, /* height == 2 */
+        diff_16b_avx512_sse, /* height == 4 */
+        diff_16b_avx512_sse, /* height == 8 */
+        diff_16b_avx512_sse, /* height == 16 */
+        diff_16b_avx512_sse, /* height == 32 */
+        diff_16b_avx512_sse, /* height == 64 */
+        diff_16b_avx512_sse, /* height == 128 */
+    },
+    /* width == 4 */
+    {
+        diff_16b_avx512_sse, /* height == 1 */
+        diff_16b_avx512_sse, /* height == 2 */
+        diff_16b_avx512_sse, /* height == 4 */
+        diff_16b_avx512_sse, /* height == 8 */
+        diff_16b_avx512_sse, /* height == 16 */
+        diff_16b_avx512_sse, /* height == 32 */
+        diff_16b_avx512_sse, /* height == 64 */
+        diff_16b_avx512_sse, /* height == 128 */
+    },
+    /* width == 8 */
+    {
+        diff_16b_avx512_sse, /* height == 1 */
+        diff_16b_avx512_sse, /* height == 2 */
+        diff_16b_avx512_sse, /* height == 4 */
+        diff_16b_avx512_sse, /* height == 8 */
+        diff_16b_avx512_sse, /* height == 16 */
+        diff_16b_avx512_sse, /* height == 32 */
+        diff_16b_avx512_sse, /* height == 64 */
+        diff_16b_avx512_sse, /* height == 128 */
+    },
+    /* width == 16 */
+    {
+        diff_16b_avx512_16nx1n, /* height == 1 */
+        diff_16b_avx512_16nx1n, /* height == 2 */
+        diff_16b_avx512_16nx1n, /* height == 4 */
+        diff_16b_avx512_16nx1n, /* height == 8 */
+        diff_16b_avx512_16nx1n, /* height == 16 */
+        diff_16b_avx512_16nx1n, /* height == 32 */
+        diff_16b_avx512_16nx1n, /* height == 64 */
+        diff_16b_avx512_16nx1n, /* height == 128 */
+    },
+    /* width == 32 */
+    {
+        diff_16b_avx512_16nx1n, /* height == 1 */
+        diff_16b_avx512_16nx1n, /* height == 2 */
+        diff_16b_avx512_16nx1n, /* height == 4 */
+        diff_16b_avx512_16nx1n, /* height == 8 */
+        diff_16b_avx512_16nx1n, /* height == 16 */
+        diff_16b_avx512_16nx1n, /* height == 32 */
+        diff_16b_avx512_16nx1n, /* height == 64 */
+        diff_16b_avx512_16nx1n, /* height == 128 */
+    },
+    /* width == 64 */
+    {
+        diff_16b_avx512_16nx1n, /* height == 1 */
+        diff_16b_avx512_16nx1n, /* height == 2 */
+        diff_16b_avx512_16nx1n, /* height == 4 */
+        diff_16b_avx512_16nx1n, /* height == 8 */
+        diff_16b_avx512_16nx1n, /* height == 16 */
+        diff_16b_avx512_16nx1n, /* height == 32 */
+        diff_16b_avx512_16nx1n, /* height == 64 */
+        diff_16b_avx512_16nx1n, /* height == 128 */
+    },
+    /* width == 128 */
+    {
+        diff_16b_avx512_16nx1n, /* height == 1 */
+        diff_16b_avx512_16nx1n, /* height == 2 */
+        diff_16b_avx512_16nx1n, /* height == 4 */
+        diff_16b_avx512_16nx1n, /* height == 8 */
+        diff_16b_avx512_16nx1n, /* height == 16 */
+        diff_16b_avx512_16nx1n, /* height == 32 */
+        diff_16b_avx512_16nx1n, /* height == 64 */
+        diff_16b_avx512_16nx1n, /* height == 128 */
+    }
+};
+#endif /* X86_SSE */
@@ -0,0 +1,171 @@
+/* Copyright (c) 2020, Samsung Electronics Co., Ltd.
+   All Rights Reserved. */
+   /*
+      Redistribution and use in source and binary forms, with or without
+      modification, are permitted provided that the following conditions are met:
+
+      - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+      - Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+      - Neither the name of the copyright owner, nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+      AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+      IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+      ARE DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+      LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+      CONSEQUENTIAL DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+      SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+      INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+      CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+      ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+      POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#include "xeve_def.h"
+#include "xeve_tq_avx512.h"
+
+#if X86_SSE
+/* transpose a 16x16 block of 32-bit words */
+static void transpose_16x16_epi32_avx512(__m512i *r)
+{
+    __m512i t[16], u[16], v0, v1, v2, v3;
+    int i, q;
+
+    for(i = 0; i < 8; i++)
+    {
+        t[2 * i]     = _mm512_unpacklo_epi32(r[2 * i], r[2 * i + 1]);
+        t[2 * i + 1] = _mm512_unpackhi_epi32(r[2 * i], r[2 * i + 1]);
+    }
+    for(i = 0; i < 4; i++)
+    {
+        u[4 * i]     = _mm512_unpacklo_epi64(t[4 * i], t[4 * i + 2]);
+        u[4 * i + 1] = _mm512_unpackhi_epi64(t[4 * i], t[4 * i + 2]);
+        u[4 * i + 2] = _mm512_unpacklo_epi64(t[4 * i + 1], t[4 * i + 3]);
+        u[4 * i + 3] = _mm512_unpackhi_epi64(t[4 * i + 1], t[4 * i + 3]);
+    }
+    for(q = 0; q < 4; q++)
+    {
+        v0 = _mm512_shuffle_i32x4(u[q], u[4 + q], 0x88);
+        v1 = _mm512_shuffle_i32x4(u[q], u[4 + q], 0xDD);
+        v2 = _mm512_shuffle_i32x4(u[8 + q], u[12 + q], 0x88);
+        v3 = _mm512_shuffle_i32x4(u[8 + q], u[12 + q], 0xDD);
+        r[q]      = _mm512_shuffle_i32x4(v0, v2, 0x88);
+        r[4 + q]  = _mm512_shuffle_i32x4(v1, v3, 0x88);
+        r[8 + q]  = _mm512_shuffle_i32x4(v0, v2, 0xDD);
+        r[12 + q] = _mm512_shuffle_i32x4(v1, v3, 0xDD);
+    }
+}
+
+/* first stage of the forward transform as a matrix product over 16 lines at
+   a time. a line holds size/2 pairs of residual samples, the lines are
+   transposed so that every pair is multiplied by a broadcast pair of
+   transform coefficients. the 64-point transform keeps the lower 32
+   coefficients only, like tx_pb64b() */
+static void tx_pb_step0_avx512(s16 *src, s32 *dst, const s8 *tm, int size, int shift, int line)
+{
+    __m512i col[32], acc;
+    __m512i add = _mm512_set1_epi32(shift == 0 ? 0 : 1 << (shift - 1));
+    s32 cp[32 * 32];
+    int npair = size >> 1;
+    int nout = XEVE_MIN(size, 32);
+    int j, k, m, b;
+
+    for(k = 0; k < nout; k++)
+    {
+        for(m = 0; m < npair; m++)
+        {
+            cp[k * npair + m] = ((s16)tm[k * size + 2 * m] & 0xFFFF) | ((u32)(s16)tm[k * size + 2 * m + 1] << 16);
+        }
+    }
+
+    for(j = 0; j < line; j += 16)
+    {
+        for(b = 0; b < npair; b += 16)
+        {
+            for(k = 0; k < 16; k++)
+            {
+                col[b + k] = _mm512_maskz_loadu_epi32((__mmask16)((1u << XEVE_MIN(npair, 16)) - 1), src + (j + k) * size + b * 2);
+            }
+            transpose_16x16_epi32_avx512(col + b);
+        }
+        for(k = 0; k < nout; k++)
+        {
+            acc = add;
+            for(m = 0; m < npair; m++)
+            {
+                acc = _mm512_add_epi32(acc, _mm512_madd_epi16(col[m], _mm512_set1_epi32(cp[k * npair + m])));
+            }
+            _mm512_storeu_si512((__m512i*)(dst + k * line + j), _mm512_srai_epi32(acc, shift));
+        }
+        for(; k < size; k++)
+        {
+            _mm512_storeu_si512((__m512i*)(dst + k * line + j), _mm512_setzero_si512());
+        }
+    }
+}
+
+static void tx_pb8b_avx512(void* src, void* dst, int shift, int line, int step)
+{
+    if((line & 15) || step == 1)
+    {
+        xeve_tbl_txb_avx[2](src, dst, shift, line, step);
+    }
+    else
+    {
+        tx_pb_step0_avx512((s16*)src, (s32*)dst, xeve_tbl_tm8[0], 8, shift, line);
+    }
+}
+
+static void tx_pb16b_avx512(void* src, void* dst, int shift, int line, int step)
+{
+    if((line & 15) || step == 1)
+    {
+        xeve_tbl_txb_avx[3](src, dst, shift, line, step);
+    }
+    else
+    {
+        tx_pb_step0_avx512((s16*)src, (s32*)dst, xeve_tbl_tm16[0], 16, shift, line);
+    }
+}
+
+static void tx_pb32b_avx512(void* src, void* dst, int shift, int line, int step)
+{
+    if((line & 15) || step == 1)
+    {
+        xeve_tbl_txb_avx[4](src, dst, shift, line, step);
+    }
+    else
+    {
+        tx_pb_step0_avx512((s16*)src, (s32*)dst, xeve_tbl_tm32[0], 32, shift, line);
+    }
+}
+
+static void tx_pb64b_avx512(void* src, void* dst, int shift, int line, int step)
+{
+    if((line & 15) || step == 1)
+    {
+        xeve_tbl_txb_avx[5](src, dst, shift, line, step);
+    }
+    else
+    {
+        tx_pb_step0_avx512((s16*)src, (s32*)dst, xeve_tbl_tm64[0], 64, shift, line);
+    }
+}
+
+const XEVE_TXB xeve_tbl_txb_avx512[MAX_TR_LOG2] =
+{
+    tx_pb2b,
+    tx_pb4b,
+    tx_pb8b_avx512,
+    tx_pb16b_avx512,
+    tx_pb32b_avx512,
+    tx_pb64b_avx512
+};
+#endif /* X86_SSE */
@@ -0,0 +1,290 @@
+/* The copyright in this software is being made available under the BSD
+   License, included below. This software may be subject to contributor and
+   other third party rights, including patent rights, and no such rights are
+   granted under this license.
+
+   Copyright (c) 2020, Samsung Electronics Co., Ltd.
+   All Rights Reserved. */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+   
+   - Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+   
+   - Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+   
+   - Neither the name of the copyright owner, nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+   
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+   POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "xeve_type.h"
+
+#if X86_SSE
+
+/* 16-bit lanes stay exact up to 10-bit samples, deeper content goes to C */
+#define DBK_MAX_BIT_DEPTH_SSE   10
+
+/* signed division truncating toward zero, as done by C for s16 values */
+#define DBK_DIV_SSE(x, shift) \
+    _mm_srai_epi16(_mm_add_epi16(x, _mm_and_si128(_mm_srai_epi16(x, 15), _mm_set1_epi16((1 << (shift)) - 1))), shift)
+
+#define DBK_CLIP_SSE(x, max) \
+    _mm_min_epi16(_mm_max_epi16(x, _mm_setzero_si128()), max)
+
+/* d1 correction of B and C for each lane, zero where st is zero */
+#define DBK_D1_SSE(A, B, C, D, st, d, d1, clip) \
+{ \
+    __m128i abs_, t16_; \
+    d = _mm_add_epi16(_mm_sub_epi16(A, D), _mm_slli_epi16(_mm_sub_epi16(C, B), 2)); \
+    d = DBK_DIV_SSE(d, 3); \
+    abs_ = _mm_abs_epi16(d); \
+    t16_ = _mm_max_epi16(_mm_slli_epi16(_mm_sub_epi16(abs_, st), 1), _mm_setzero_si128()); \
+    clip = _mm_max_epi16(_mm_sub_epi16(abs_, t16_), _mm_setzero_si128()); \
+    d1 = _mm_sign_epi16(clip, d); \
+}
+
+#define DBK_LUMA_SSE(A, B, C, D, st, max) \
+{ \
+    __m128i d_, d1_, d2_, clip_; \
+    DBK_D1_SSE(A, B, C, D, st, d_, d1_, clip_); \
+    clip_ = _mm_srai_epi16(clip_, 1); \
+    d2_ = DBK_DIV_SSE(_mm_sub_epi16(A, D), 2); \
+    d2_ = _mm_min_epi16(_mm_max_epi16(d2_, _mm_sub_epi16(_mm_setzero_si128(), clip_)), clip_); \
+    A = DBK_CLIP_SSE(_mm_sub_epi16(A, d2_), max); \
+    B = DBK_CLIP_SSE(_mm_add_epi16(B, d1_), max); \
+    C = DBK_CLIP_SSE(_mm_sub_epi16(C, d1_), max); \
+    D = DBK_CLIP_SSE(_mm_add_epi16(D, d2_), max); \
+}
+
+#define DBK_CHROMA_SSE(A, B, C, D, st, max) \
+{ \
+    __m128i d_, d1_, clip_; \
+    DBK_D1_SSE(A, B, C, D, st, d_, d1_, clip_); \
+    B = DBK_CLIP_SSE(_mm_add_epi16(B, d1_), max); \
+    C = DBK_CLIP_SSE(_mm_sub_epi16(C, d1_), max); \
+}
+
+/* 8 rows of 4 samples around a vertical edge into A, B, C, D columns */
+#define DBK_LOAD_VER_SSE(buf, stride, A, B, C, D) \
+{ \
+    __m128i r0_, r1_, r2_, r3_, t0_, t1_, t2_, t3_; \
+    r0_ = _mm_unpacklo_epi16(_mm_loadl_epi64((__m128i*)((buf) - 2)), _mm_loadl_epi64((__m128i*)((buf) + (stride) - 2))); \
+    r1_ = _mm_unpacklo_epi16(_mm_loadl_epi64((__m128i*)((buf) + 2 * (stride) - 2)), _mm_loadl_epi64((__m128i*)((buf) + 3 * (stride) - 2))); \
+    r2_ = _mm_unpacklo_epi16(_mm_loadl_epi64((__m128i*)((buf) + 4 * (stride) - 2)), _mm_loadl_epi64((__m128i*)((buf) + 5 * (stride) - 2))); \
+    r3_ = _mm_unpacklo_epi16(_mm_loadl_epi64((__m128i*)((buf) + 6 * (stride) - 2)), _mm_loadl_epi64((__m128i*)((buf) + 7 * (stride) - 2))); \
+    t0_ = _mm_unpacklo_epi32(r0_, r1_); \
+    t1_ = _mm_unpackhi_epi32(r0_, r1_); \
+    t2_ = _mm_unpacklo_epi32(r2_, r3_); \
+    t3_ = _mm_unpackhi_epi32(r2_, r3_); \
+    A = _mm_unpacklo_epi64(t0_, t2_); \
+    B = _mm_unpackhi_epi64(t0_, t2_); \
+    C = _mm_unpacklo_epi64(t1_, t3_); \
+    D = _mm_unpackhi_epi64(t1_, t3_); \
+}
+
+#define DBK_STORE_4PEL_SSE(buf, stride, v) \
+    _mm_storel_epi64((__m128i*)(buf), v); \
+    _mm_storel_epi64((__m128i*)((buf) + (stride)), _mm_srli_si128(v, 8));
+
+#define DBK_STORE_2PEL_SSE(buf, v, idx) \
+{ \
+    int t_ = _mm_extract_epi32(v, idx); \
+    xeve_mcpy(buf, &t_, sizeof(int)); \
+}
+
+void xeve_dbk_luma_hor_sse(pel *buf, int stride, const s16 *st, int len, int bit_depth)
+{
+    __m128i A, B, C, D, vst, max;
+    pel * p;
+    int i;
+
+    if(bit_depth > DBK_MAX_BIT_DEPTH_SSE)
+    {
+        xeve_dbk_luma_hor(buf, stride, st, len, bit_depth);
+        return;
+    }
+
+    max = _mm_set1_epi16((1 << bit_depth) - 1);
+
+    for(i = 0; i + 8 <= len; i += 8)
+    {
+        vst = _mm_loadu_si128((__m128i*)(st + i));
+        if(_mm_testz_si128(vst, vst))
+        {
+            continue;
+        }
+
+        p = buf + i;
+        A = _mm_loadu_si128((__m128i*)(p - 2 * stride));
+        B = _mm_loadu_si128((__m128i*)(p - stride));
+        C = _mm_loadu_si128((__m128i*)(p));
+        D = _mm_loadu_si128((__m128i*)(p + stride));
+
+        DBK_LUMA_SSE(A, B, C, D, vst, max);
+
+        _mm_storeu_si128((__m128i*)(p - 2 * stride), A);
+        _mm_storeu_si128((__m128i*)(p - stride), B);
+        _mm_storeu_si128((__m128i*)(p), C);
+        _mm_storeu_si128((__m128i*)(p + stride), D);
+    }
+
+    if(i < len)
+    {
+        xeve_dbk_luma_hor(buf + i, stride, st + i, len - i, bit_depth);
+    }
+}
+
+void xeve_dbk_chroma_hor_sse(pel *buf, int stride, const s16 *st, int len, int bit_depth)
+{
+    __m128i A, B, C, D, vst, max;
+    pel * p;
+    int i;
+
+    if(bit_depth > DBK_MAX_BIT_DEPTH_SSE)
+    {
+        xeve_dbk_chroma_hor(buf, stride, st, len, bit_depth);
+        return;
+    }
+
+    max = _mm_set1_epi16((1 << bit_depth) - 1);
+
+    for(i = 0; i + 8 <= len; i += 8)
+    {
+        vst = _mm_loadu_si128((__m128i*)(st + i));
+        if(_mm_testz_si128(vst, vst))
+        {
+            continue;
+        }
+
+        p = buf + i;
+        A = _mm_loadu_si128((__m128i*)(p - 2 * stride));
+        B = _mm_loadu_si128((__m128i*)(p - stride));
+        C = _mm_loadu_si128((__m128i*)(p));
+        D = _mm_loadu_si128((__m128i*)(p + stride));
+
+        DBK_CHROMA_SSE(A, B, C, D, vst, max);
+
+        _mm_storeu_si128((__m128i*)(p - stride), B);
+        _mm_storeu_si128((__m128i*)(p), C);
+    }
+
+    if(i < len)
+    {
+        xeve_dbk_chroma_hor(buf + i, stride, st + i, len - i, bit_depth);
+    }
+}
+
+void xeve_dbk_luma_ver_sse(pel *buf, int stride, const s16 *st, int len, int bit_depth)
+{
+    __m128i A, B, C, D, vst, max;
+    __m128i t0, t1, t2, t3;
+    pel * p;
+    int i;
+
+    if(bit_depth > DBK_MAX_BIT_DEPTH_SSE)
+    {
+        xeve_dbk_luma_ver(buf, stride, st, len, bit_depth);
+        return;
+    }
+
+    max = _mm_set1_epi16((1 << bit_depth) - 1);
+
+    for(i = 0; i + 8 <= len; i += 8)
+    {
+        vst = _mm_loadu_si128((__m128i*)(st + i));
+        if(_mm_testz_si128(vst, vst))
+        {
+            continue;
+        }
+
+        p = buf + i * stride;
+        DBK_LOAD_VER_SSE(p, stride, A, B, C, D);
+
+        DBK_LUMA_SSE(A, B, C, D, vst, max);
+
+        t0 = _mm_unpacklo_epi16(A, B);
+        t1 = _mm_unpackhi_epi16(A, B);
+        t2 = _mm_unpacklo_epi16(C, D);
+        t3 = _mm_unpackhi_epi16(C, D);
+
+        p -= 2;
+        DBK_STORE_4PEL_SSE(p, stride, _mm_unpacklo_epi32(t0, t2));
+        p += 2 * stride;
+        DBK_STORE_4PEL_SSE(p, stride, _mm_unpackhi_epi32(t0, t2));
+        p += 2 * stride;
+        DBK_STORE_4PEL_SSE(p, stride, _mm_unpacklo_epi32(t1, t3));
+        p += 2 * stride;
+        DBK_STORE_4PEL_SSE(p, stride, _mm_unpackhi_epi32(t1, t3));
+    }
+
+    if(i < len)
+    {
+        xeve_dbk_luma_ver(buf + i * stride, stride, st + i, len - i, bit_depth);
+    }
+}
+
+void xeve_dbk_chroma_ver_sse(pel *buf, int stride, const s16 *st, int len, int bit_depth)
+{
+    __m128i A, B, C, D, vst, max, bc;
+    pel * p;
+    int i;
+
+    if(bit_depth > DBK_MAX_BIT_DEPTH_SSE)
+    {
+        xeve_dbk_chroma_ver(buf, stride, st, len, bit_depth);
+        return;
+    }
+
+    max = _mm_set1_epi16((1 << bit_depth) - 1);
+
+    for(i = 0; i + 8 <= len; i += 8)
+    {
+        vst = _mm_loadu_si128((__m128i*)(st + i));
+        if(_mm_testz_si128(vst, vst))
+        {
+            continue;
+        }
+
+        p = buf + i * stride;
+        DBK_LOAD_VER_SSE(p, stride, A, B, C, D);
+
+        DBK_CHROMA_SSE(A, B, C, D, vst, max);
+
+        /* only B and C are written back, neighbouring chroma edges are two samples apart */
+        p -= 1;
+        bc = _mm_unpacklo_epi16(B, C);
+        DBK_STORE_2PEL_SSE(p, bc, 0);
+        DBK_STORE_2PEL_SSE(p + stride, bc, 1);
+        DBK_STORE_2PEL_SSE(p + 2 * stride, bc, 2);
+        DBK_STORE_2PEL_SSE(p + 3 * stride, bc, 3);
+        p += 4 * stride;
+        bc = _mm_unpackhi_epi16(B, C);
+        DBK_STORE_2PEL_SSE(p, bc, 0);
+        DBK_STORE_2PEL_SSE(p + stride, bc, 1);
+        DBK_STORE_2PEL_SSE(p + 2 * stride, bc, 2);
+        DBK_STORE_2PEL_SSE(p + 3 * stride, bc, 3);
+    }
+
+    if(i < len)
+    {
+        xeve_dbk_chroma_ver(buf + i * stride, stride, st + i, len - i, bit_depth);
+    }
+}
+#endif /* X86_SSE */
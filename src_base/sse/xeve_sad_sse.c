@@ -4739,9 +4739,127 @@ int xeve_had_sse(int w, int h, void *o, void *c, int s_org, int s_cur, int bit_d
     return (sum >> (bit_depth - 8));
 }
 
-const XEVE_FN_SATD xeve_tbl_satd_16b_sse[1] =
+int satd_16b_sse_4nx4n(int w, int h, void * o, void * c, int s_org, int s_cur, int bit_depth)
 {
-    xeve_had_sse,
+    XEVE_SATD_16B_TILES(xeve_had_4x4_sse, 4, 4);
+}
+
+int satd_16b_sse_8nx4n(int w, int h, void * o, void * c, int s_org, int s_cur, int bit_depth)
+{
+    XEVE_SATD_16B_TILES(xeve_had_8x4_sse, 8, 4);
+}
+
+int satd_16b_sse_4nx8n(int w, int h, void * o, void * c, int s_org, int s_cur, int bit_depth)
+{
+    XEVE_SATD_16B_TILES(xeve_had_4x8_sse, 4, 8);
+}
+
+static int satd_16b_sse_8nx8n(int w, int h, void * o, void * c, int s_org, int s_cur, int bit_depth)
+{
+    XEVE_SATD_16B_TILES(xeve_had_8x8_sse, 8, 8);
+}
+
+static int satd_16b_sse_16nx8n(int w, int h, void * o, void * c, int s_org, int s_cur, int bit_depth)
+{
+    XEVE_SATD_16B_TILES(xeve_had_16x8_sse, 16, 8);
+}
+
+static int satd_16b_sse_8nx16n(int w, int h, void * o, void * c, int s_org, int s_cur, int bit_depth)
+{
+    XEVE_SATD_16B_TILES(xeve_had_8x16_sse, 8, 16);
+}
+
+/* index: [log2 of width][log2 of height] */
+const XEVE_FN_SATD xeve_tbl_satd_16b_sse[8][8] =
+{
+    /* width == 1 */
+    {
+        xeve_had_sse, /* height == 1 */
+        xeve_had_sse, /* height == 2 */
+        xeve_had_sse, /* height == 4 */
+        xeve_had_sse, /* height == 8 */
+        xeve_had_sse, /* height == 16 */
+        xeve_had_sse, /* height == 32 */
+        xeve_had_sse, /* height == 64 */
+        xeve_had_sse, /* height == 128 */
+    },
+    /* width == 2 */
+    {
+        xeve_had_sse, /* height == 1 */
+        xeve_had_sse, /* height == 2 */
+        xeve_had_sse, /* height == 4 */
+        xeve_had_sse, /* height == 8 */
+        xeve_had_sse, /* height == 16 */
+        xeve_had_sse, /* height == 32 */
+        xeve_had_sse, /* height == 64 */
+        xeve_had_sse, /* height == 128 */
+    },
+    /* width == 4 */
+    {
+        xeve_had_sse,       /* height == 1 */
+        xeve_had_sse,       /* height == 2 */
+        satd_16b_sse_4nx4n, /* height == 4 */
+        satd_16b_sse_4nx8n, /* height == 8 */
+        satd_16b_sse_4nx8n, /* height == 16 */
+        satd_16b_sse_4nx8n, /* height == 32 */
+        satd_16b_sse_4nx8n, /* height == 64 */
+        satd_16b_sse_4nx8n, /* height == 128 */
+    },
+    /* width == 8 */
+    {
+        xeve_had_sse,        /* height == 1 */
+        xeve_had_sse,        /* height == 2 */
+        satd_16b_sse_8nx4n,  /* height == 4 */
+        satd_16b_sse_8nx8n,  /* height == 8 */
+        satd_16b_sse_8nx16n, /* height == 16 */
+        satd_16b_sse_8nx16n, /* height == 32 */
+        satd_16b_sse_8nx16n, /* height == 64 */
+        satd_16b_sse_8nx16n, /* height == 128 */
+    },
+    /* width == 16 */
+    {
+        xeve_had_sse,        /* height == 1 */
+        xeve_had_sse,        /* height == 2 */
+        satd_16b_sse_8nx4n,  /* height == 4 */
+        satd_16b_sse_16nx8n, /* height == 8 */
+        satd_16b_sse_8nx8n,  /* height == 16 */
+        satd_16b_sse_8nx16n, /* height == 32 */
+        satd_16b_sse_8nx16n, /* height == 64 */
+        satd_16b_sse_8nx16n, /* height == 128 */
+    },
+    /* width == 32 */
+    {
+        xeve_had_sse,        /* height == 1 */
+        xeve_had_sse,        /* height == 2 */
+        satd_16b_sse_8nx4n,  /* height == 4 */
+        satd_16b_sse_16nx8n, /* height == 8 */
+        satd_16b_sse_16nx8n, /* height == 16 */
+        satd_16b_sse_8nx8n,  /* height == 32 */
+        satd_16b_sse_8nx16n, /* height == 64 */
+        satd_16b_sse_8nx16n, /* height == 128 */
+    },
+    /* width == 64 */
+    {
+        xeve_had_sse,        /* height == 1 */
+        xeve_had_sse,        /* height == 2 */
+        satd_16b_sse_8nx4n,  /* height == 4 */
+        satd_16b_sse_16nx8n, /* height == 8 */
+        satd_16b_sse_16nx8n, /* height == 16 */
+        satd_16b_sse_16nx8n, /* height == 32 */
+        satd_16b_sse_8nx8n,  /* height == 64 */
+        satd_16b_sse_8nx16n, /* height == 128 */
+    },
+    /* width == 128 */
+    {
+        xeve_had_sse,        /* height == 1 */
+        xeve_had_sse,        /* height == 2 */
+        satd_16b_sse_8nx4n,  /* height == 4 */
+        satd_16b_sse_16nx8n, /* height == 8 */
+        satd_16b_sse_16nx8n, /* height == 16 */
+        satd_16b_sse_16nx8n, /* height == 32 */
+        satd_16b_sse_16nx8n, /* height == 64 */
+        satd_16b_sse_8nx8n,  /* height == 128 */
+    }
 };
 
 #endif /* X86_SSE */
\ No newline at end of file
@@ -37,13 +37,34 @@
 extern const XEVE_FN_SAD xeve_tbl_sad_16b_sse[8][8];
 extern const XEVE_FN_SSD xeve_tbl_ssd_16b_sse[8][8];
 extern const XEVE_FN_DIFF xeve_tbl_diff_16b_sse[8][8];
-extern const XEVE_FN_SATD xeve_tbl_satd_16b_sse[1];
+extern const XEVE_FN_SATD xeve_tbl_satd_16b_sse[8][8];
 
 int sad_16b_sse_4x2(int w, int h, void * src1, void * src2, int s_src1, int s_src2, int bit_depth);
 int sad_16b_sse_4x2n(int w, int h, void * src1, void * src2, int s_src1, int s_src2, int bit_depth);
 int sad_16b_sse_4x4(int w, int h, void * src1, void * src2, int s_src1, int s_src2, int bit_depth);
 int sad_16b_sse_8x2n(int w, int h, void * src1, void * src2, int s_src1, int s_src2, int bit_depth);
 int sad_16b_sse_16nx1n(int w, int h, void * src1, void * src2, int s_src1, int s_src2, int bit_depth);
+int satd_16b_sse_4nx4n(int w, int h, void * o, void * c, int s_org, int s_cur, int bit_depth);
+int satd_16b_sse_8nx4n(int w, int h, void * o, void * c, int s_org, int s_cur, int bit_depth);
+int satd_16b_sse_4nx8n(int w, int h, void * o, void * c, int s_org, int s_cur, int bit_depth);
+int xeve_had_sse(int w, int h, void * o, void * c, int s_org, int s_cur, int bit_depth);
+
+/* SATD of a block tiled with (bw)x(bh) Hadamard kernels, the tiling follows
+   xeve_had() so that the result does not depend on the kernel set */
+#define XEVE_SATD_16B_TILES(had, bw, bh) \
+    pel *org = o; \
+    pel *cur = c; \
+    int x, y, sum = 0; \
+    for(y = 0; y < h; y += (bh)) \
+    { \
+        for(x = 0; x < w; x += (bw)) \
+        { \
+            sum += had(&org[x], &cur[x], s_org, s_cur, 1, bit_depth); \
+        } \
+        org += s_org * (bh); \
+        cur += s_cur * (bh); \
+    } \
+    return (sum >> (bit_depth - 8))
 
 #endif /* X86_SSE */
 #endif /* _XEVE_SAD_SSE_H_ */
@@ -110,6 +110,7 @@ static int ctu_mt_core(void * arg)
     xeve_update_core_loc_param_mt(ctx, core);
 
     int bef_cu_qp = ctx->tile[i].qp_prev_eco[core->thread_cnt];
+    long long ctu_start;
 
     /* LCU encoding loop */
     while (ctx->tile[i].f_ctb > 0)
@@ -117,8 +118,13 @@ static int ctu_mt_core(void * arg)
         if (core->y_lcu != sp_y_lcu && core->x_lcu < (sp_x_lcu + ctx->tile[core->tile_idx].w_ctb - 1))
         {
             /* up-right CTB */
-            spinlock_wait(&ctx->sync_flag[core->lcu_num - ctx->w_lcu + 1], THREAD_TERMINATED);
+            spinlock_wait(ctx->sync_block, &ctx->sync_flag[core->lcu_num - ctx->w_lcu + 1], THREAD_TERMINATED, &core->sync_wait_time);
         }
+        if (core->x_lcu == sp_x_lcu)
+        {
+            xeve_mt_row_state_load(ctx, core, GET_SBAC_ENC(bs), &bef_cu_qp);
+        }
+        ctu_start = get_time_us();
 
         /* initialize structures *****************************************/
         ret = ctx->fn_mode_init_lcu(ctx, core);
@@ -142,10 +148,18 @@ static int ctu_mt_core(void * arg)
 
         xeve_assert_rv(ret == XEVE_OK, ret);
 
-        threadsafe_assign(&ctx->sync_flag[core->lcu_num], THREAD_TERMINATED);
+        xeve_mt_row_state_store(ctx, core, GET_SBAC_ENC(bs), bef_cu_qp);
+        ctx->map_ctu_time[core->lcu_num] = (s32)(get_time_us() - ctu_start);
+        threadsafe_assign(ctx->sync_block, &ctx->sync_flag[core->lcu_num], THREAD_TERMINATED);
         threadsafe_decrement(ctx->sync_block, (volatile s32 *)&ctx->tile[i].f_ctb);
 
-        core->lcu_num = xeve_mt_get_next_ctu_num(ctx, core, ctx->parallel_rows);
+        if (core->x_lcu == sp_x_lcu + ctb_cnt_in_row - 1)
+        {
+            /* loop filtering behind the wavefront */
+            xeve_mt_deblock_rows(ctx, core);
+        }
+
+        core->lcu_num = xeve_mt_get_next_ctu_num(ctx, core);
         if (core->lcu_num == -1)
             break;
     }
@@ -247,16 +261,16 @@ int xeve_pic(XEVE_CTX * ctx, XEVE_BITB * bitb, XEVE_STAT * stat)
         core->dqp_curr_best[ctx->log2_max_cuwh - 2][ctx->log2_max_cuwh - 2].curr_qp = ctx->sh->qp;
         core->dqp_curr_best[ctx->log2_max_cuwh - 2][ctx->log2_max_cuwh - 2].prev_qp = ctx->sh->qp;
 
+        xeve_mt_deblock_init(ctx);
+
         /* Tile wise encoding with in a slice */
         u32 k = 0;
         total_tiles_in_slice = sh->num_tiles_in_slice;
-        THREAD_CONTROLLER * tc;
+        TASK_GROUP grp;
         int res;
         i = 0;
-        tc = ctx->tc;
         int parallel_task = 1;
-        int thread_cnt = 0, thread_cnt1 = 0;;
-        int task_completed = 0;
+        int thread_cnt = 0;
         int tile_cnt = 0;
 
         //Code for CTU parallel encoding
@@ -266,9 +280,12 @@ int xeve_pic(XEVE_CTX * ctx, XEVE_BITB * bitb, XEVE_STAT * stat)
             i = tiles_in_slice[tile_cnt++];
             int temp_store_total_ctb = ctx->tile[i].f_ctb;
             parallel_task = (ctx->param.threads > ctx->tile[i].h_ctb) ? ctx->tile[i].h_ctb : ctx->param.threads;
-            ctx->parallel_rows = parallel_task;
+            ctx->tile[i].parallel_rows = parallel_task;
+            /* the first rows are given to the threads, the others are taken on completion */
+            ctx->tile[i].row_next = parallel_task;
             ctx->tile[i].qp = ctx->sh->qp;
 
+            task_group_init(&grp);
             for (thread_cnt = 1; (thread_cnt < parallel_task); thread_cnt++)
             {
                 ctx->tile[i].qp_prev_eco[thread_cnt] = ctx->sh->qp;
@@ -279,7 +296,8 @@ int xeve_pic(XEVE_CTX * ctx, XEVE_BITB * bitb, XEVE_STAT * stat)
                 xeve_init_core_mt(ctx, i, core, thread_cnt);
 
                 ctx->core[thread_cnt]->thread_cnt = thread_cnt;
-                tc->run(ctx->thread_pool[thread_cnt], ctu_mt_core, (void*)ctx->core[thread_cnt]);
+                ret = task_submit(ctx->ts, &grp, ctu_mt_core, (void*)ctx->core[thread_cnt]);
+                xeve_assert_rv(ret == THREAD_SUCCESS, XEVE_ERR_UNKNOWN);
             }
 
             ctx->tile[i].qp = ctx->sh->qp;
@@ -290,16 +308,10 @@ int xeve_pic(XEVE_CTX * ctx, XEVE_BITB * bitb, XEVE_STAT * stat)
             xeve_init_core_mt(ctx, i, core, 0);
 
             ctx->core[0]->thread_cnt = 0;
-            ctu_mt_core((void*)ctx->core[0]);
-
-             for (thread_cnt1 = 1; thread_cnt1 < parallel_task; thread_cnt1++)
-            {
-                tc->join(ctx->thread_pool[thread_cnt1], &res);
-                if (XEVE_FAILED(res))
-                {
-                    ret = res;
-                }
-            }
+            ret = ctu_mt_core((void*)ctx->core[0]);
+            res = task_group_wait(ctx->ts, &grp);
+            xeve_assert_rv(ret == XEVE_OK, ret);
+            xeve_assert_rv(res == XEVE_OK, res);
 
             ctx->tile[i].f_ctb = temp_store_total_ctb;
 
@@ -523,6 +535,8 @@ int xeve_pic(XEVE_CTX * ctx, XEVE_BITB * bitb, XEVE_STAT * stat)
 #endif
         /* Bit-stream re-writing (END) */
 
+        ret = xeve_nalu_out(ctx, 0);
+        xeve_assert_rv(ret == XEVE_OK, ret);
     }  // End of slice loop
 
     return XEVE_OK;
@@ -553,6 +567,8 @@ XEVE xeve_create(XEVE_CDSC * cdsc, int * err)
     ret = xeve_set_init_param(ctx, &ctx->param);
     xeve_assert_g(ret == XEVE_OK, ERR);
     xeve_assert_g(ctx->param.profile == XEVE_PROFILE_BASELINE, ERR);
+    /* the baseline encoder codes a picture as a single tile */
+    xeve_assert_gv(ctx->param.tile_columns * ctx->param.tile_rows == 1, ret, XEVE_ERR_UNSUPPORTED, ERR);
 
     ret = xeve_platform_init(ctx);
     xeve_assert_g(ret == XEVE_OK, ERR);
@@ -578,8 +594,8 @@ XEVE xeve_create(XEVE_CDSC * cdsc, int * err)
 ERR:
     if(ctx)
     {
-        xeve_platform_deinit(ctx);
         xeve_delete_bs_buf(ctx);
+        xeve_platform_deinit(ctx);
         xeve_ctx_free(ctx);
     }
     if(err) *err = ret;
@@ -601,14 +617,15 @@ void xeve_delete(XEVE id)
         ctx->fn_flush(ctx);
     }
 
-    xeve_platform_deinit(ctx);
     xeve_delete_bs_buf(ctx);
+    xeve_platform_deinit(ctx);
     xeve_ctx_free(ctx);
 }
 
 int xeve_encode(XEVE id, XEVE_BITB * bitb, XEVE_STAT * stat)
 {
     XEVE_CTX * ctx;
+    int        ret;
 
     XEVE_ID_TO_CTX_RV(id, ctx, XEVE_ERR_INVALID_ARGUMENT);
     xeve_assert_rv(ctx->fn_enc, XEVE_ERR_UNEXPECTED);
@@ -622,7 +639,8 @@ int xeve_encode(XEVE id, XEVE_BITB * bitb, XEVE_STAT * stat)
     {
         if (ctx->param.use_fcst)
         {
-            xeve_forecast_fixed_gop(ctx);
+            ret = xeve_forecast_submit(ctx, ctx->pico);
+            xeve_assert_rv(ret == XEVE_OK, ret);
         }
     }
     /* store input picture and return if needed */
@@ -630,6 +648,13 @@ int xeve_encode(XEVE id, XEVE_BITB * bitb, XEVE_STAT * stat)
     {
         return XEVE_OK_OUT_NOT_AVAILABLE;
     }
+    /* forecast results of the pictures to be encoded */
+    ret = xeve_forecast_sync(ctx);
+    xeve_assert_rv(ret == XEVE_OK, ret);
+    if (ctx->param.rc_pass_fast)
+    {
+        return xeve_rc_fast_pass(ctx);
+    }
 
     /* update BSB */
     bitb->err = 0;
@@ -666,6 +691,11 @@ int xeve_config(XEVE id, int cfg, void * buf, int * size)
             ctx->pic_ticnt = ctx->pic_icnt;
             break;
 
+        case XEVE_CFG_SET_NALU_OUT:
+            xeve_assert_rv(*size == sizeof(XEVE_NALU_OUT), XEVE_ERR_INVALID_ARGUMENT);
+            xeve_mcpy(&ctx->nalu_out, buf, sizeof(XEVE_NALU_OUT));
+            break;
+
         case XEVE_CFG_SET_FINTRA:
             xeve_assert_rv(*size == sizeof(int), XEVE_ERR_INVALID_ARGUMENT);
             t0 = *((int *)buf);
@@ -796,6 +826,10 @@ int xeve_config(XEVE id, int cfg, void * buf, int * size)
             xeve_assert_rv(*size == sizeof(int), XEVE_ERR_INVALID_ARGUMENT);
             *((int *)buf) = XEVE_PROFILE_BASELINE;
             break;
+        case XEVE_CFG_GET_SYNC_WAIT_TIME:
+            return xeve_get_sync_wait_time(ctx, (long long *)buf, size);
+        case XEVE_CFG_GET_ROW_TIME:
+            return xeve_get_row_time(ctx, (long long *)buf, size);
         default:
             xeve_trace("unknown config value (%d)\n", cfg);
             xeve_assert_rv(0, XEVE_ERR_UNSUPPORTED);
@@ -243,4 +243,35 @@ void xeve_bsw_write_se(XEVE_BSW * bs, int val)
 {
     xeve_bsw_write_ue(bs, val <= 0 ? (-val * 2) : (val * 2 - 1));
 }
-#endif
\ No newline at end of file
+#endif
+
+/* write size bytes of byte aligned data, bs shall be byte aligned */
+int xeve_bsw_write_bytes(XEVE_BSW * bs, const u8 * buf, int size)
+{
+    int n;
+
+    xeve_assert_rv(XEVE_BSW_IS_BYTE_ALIGN(bs), -1);
+
+    /* complete the current code word */
+    while(size > 0 && bs->leftbits != 32)
+    {
+        xeve_bsw_write(bs, buf[0], 8);
+        buf++;
+        size--;
+    }
+
+    n = size & ~3;
+    xeve_assert_rv(bs->cur + n <= bs->end, -1);
+    xeve_mcpy(bs->cur, buf, n);
+    bs->cur += n;
+    buf += n;
+    size -= n;
+
+    while(size > 0)
+    {
+        xeve_bsw_write(bs, buf[0], 8);
+        buf++;
+        size--;
+    }
+    return 0;
+}
@@ -90,5 +90,6 @@ int xeve_bsw_write(XEVE_BSW * bs, u32 val, int len);
 void xeve_bsw_write_ue(XEVE_BSW * bs, u32 val);
 void xeve_bsw_write_se(XEVE_BSW * bs, int val);
 #endif
+int xeve_bsw_write_bytes(XEVE_BSW * bs, const u8 * buf, int size);
 
 #endif /* _XEVE_BSW_H_ */
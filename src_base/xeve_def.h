@@ -379,6 +379,16 @@ extern int fp_trace_started;
 #define PIC_PAD_SIZE_L                     (MAX_CU_SIZE + 16)
 #define PIC_PAD_SIZE_C                     (PIC_PAD_SIZE_L >> 1)
 
+/* number of downscaled levels of the motion search pyramid (1/2, 1/4) */
+#define XEVE_ME_PYR_LEVEL                  2
+/* log2 size of the blocks of the motion field found by the pyramid search */
+#define XEVE_ME_PYR_LOG2_BLK               4
+/* number of the blocks of the pyramid motion field in a row of a CTU */
+#define XEVE_ME_PYR_W                     (MAX_CU_SIZE >> XEVE_ME_PYR_LOG2_BLK)
+/* maximum search range at the coarsest level of the pyramid, the pyramid
+   covers the motion up to 4 times this range plus the refinement */
+#define XEVE_ME_PYR_RANGE                  32
+
 /* number of MVP candidates */
 #define MAX_NUM_MVP_SMALL_CU               4
 #define MAX_NUM_MVP                        6
@@ -565,6 +575,14 @@ typedef enum _TRANS_TYPE
 #define REFI_IS_VALID(refi)               ((refi) >= 0)
 #define SET_REFI(refi, idx0, idx1)        (refi)[REFP_0] = (idx0); (refi)[REFP_1] = (idx1)
 
+/*****************************************************************************
+ * intra refresh
+ *****************************************************************************/
+/* pixels at the end of the refreshed area changed by the loop filters */
+#define REFRESH_LF_MARGIN                  8
+/* pixels right of a block read by the interpolation filters and DMVR */
+#define REFRESH_MC_MARGIN                  8
+
  /*****************************************************************************
  * macros for CU map
 
@@ -865,6 +883,13 @@ typedef struct _XEVE_PIC
     int              pad_l;
     /* padding size of chroma */
     int              pad_c;
+    /* Address of downscaled Y buffers of the motion search pyramid (include
+       padding), level l is downscaled by 2^(l+1), NULL if not used */
+    pel             *buf_pyr[XEVE_ME_PYR_LEVEL];
+    /* Start address of downscaled Y components (except padding) */
+    pel             *pyr[XEVE_ME_PYR_LEVEL];
+    /* Stride of downscaled Y components */
+    int              s_pyr[XEVE_ME_PYR_LEVEL];
     /* image buffer */
     XEVE_IMGB       * imgb;
     /* presentation temporal reference of this picture */
@@ -885,6 +910,10 @@ typedef struct _XEVE_PIC
     int              pic_qp_u_offset;
     int              pic_qp_v_offset;
     u8               digest[N_C][16];
+    /* intra refresh cycle of the picture and the width of its area
+       refreshed in the cycle which can be referenced by the refreshed area */
+    int              refresh_id;
+    int              refresh_w;
 } XEVE_PIC;
 
 /*****************************************************************************
@@ -911,6 +940,8 @@ struct _PICBUF_ALLOCATOR
     void            *pdata[4];
     int              bit_depth;
     int              chroma_format_idc;
+    /* allocate downscaled luma for the motion search pyramid */
+    int              me_pyramid;
 };
 
 /*****************************************************************************
@@ -1277,7 +1308,19 @@ typedef struct _XEVE_TILE
     /* first ctb address in raster scan order */
     u16              ctba_rs_first;
     u8               qp;
-    u8               qp_prev_eco[XEVE_MAX_THREADS];
+    /* previous qp for each thread (param.threads entries) */
+    u8             * qp_prev_eco;
+    /* tile data coded to a separate bitstream buffer */
+    u8             * bs_data;
+    /* byte size of bs_data */
+    int              bs_size;
+    /* number of bins coded in the tile */
+    u32              bin_cnt;
+    /* number of threads sharing the CTU rows of the tile */
+    int              parallel_rows;
+    /* next CTU row of the tile (from the first row of the tile) to be taken
+       by the thread completing its current row */
+    volatile s32     row_next;
 } XEVE_TILE;
 
 /*****************************************************************************/
@@ -1442,6 +1485,7 @@ enum TQC_RUN {
 #include "xeve_mc.h"
 #include "xeve_mc_sse.h"
 #include "xeve_mc_avx.h"
+#include "xeve_mc_avx512.h"
 #include "xeve_type.h"
 
 #endif /* _XEVE_DEF_H_ */
@@ -97,163 +97,130 @@ static const u8 * get_tbl_qp_to_st(u32 mcu0, u32 mcu1, s8 *refi0, s8 *refi1, s16
     return xeve_tbl_df_st[idx];
 }
 
-static void deblock_scu_hor(pel *buf, int qp, int stride, int is_luma, const u8 *tbl_qp_to_st, int bit_depth_minus8)
+XEVE_DBK xeve_func_dbk_luma_hor;
+XEVE_DBK xeve_func_dbk_luma_ver;
+XEVE_DBK xeve_func_dbk_chroma_hor;
+XEVE_DBK xeve_func_dbk_chroma_ver;
+
+static void deblock_line_luma(pel *buf, int offset, s16 st, int max_val)
 {
     s16 A, B, C, D, d, d1, d2;
-    s16 abs, t16, clip, sign, st;
-    int i, size;
+    s16 abs, t16, clip, sign;
 
-    st = tbl_qp_to_st[qp] << bit_depth_minus8;
-    size = MIN_CU_SIZE;
+    A = buf[-2 * offset];
+    B = buf[-offset];
+    C = buf[0];
+    D = buf[offset];
 
-    if(st)
-    {
-        for(i = 0; i < size; i++)
-        {
-            A = buf[-2 * stride];
-            B = buf[-stride];
-            C = buf[0];
-            D = buf[stride];
-
-            d = (A - (B << 2) + (C << 2) - D) / 8;
-
-            abs = XEVE_ABS16(d);
-            sign = XEVE_SIGN_GET(d);
-
-            t16 = XEVE_MAX(0, ((abs - st) << 1));
-            clip = XEVE_MAX(0, (abs - t16));
-            d1 = XEVE_SIGN_SET(clip, sign);
-            clip >>= 1;
-            d2 = XEVE_CLIP3(-clip, clip, ((A - D) / 4));
-
-            A -= d2;
-            B += d1;
-            C -= d1;
-            D += d2;
-
-            buf[-2 * stride] = XEVE_CLIP3(0, (1 << (bit_depth_minus8+8)) - 1, A);
-            buf[-stride] = XEVE_CLIP3(0, (1 << (bit_depth_minus8 + 8)) - 1, B);
-            buf[0] = XEVE_CLIP3(0, (1 << (bit_depth_minus8 + 8)) - 1, C);
-            buf[stride] = XEVE_CLIP3(0, (1 << (bit_depth_minus8 + 8)) - 1, D);
-            buf++;
-        }
-    }
+    d = (A - (B << 2) + (C << 2) - D) / 8;
+
+    abs = XEVE_ABS16(d);
+    sign = XEVE_SIGN_GET(d);
+
+    t16 = XEVE_MAX(0, ((abs - st) << 1));
+    clip = XEVE_MAX(0, (abs - t16));
+    d1 = XEVE_SIGN_SET(clip, sign);
+    clip >>= 1;
+    d2 = XEVE_CLIP3(-clip, clip, ((A - D) / 4));
+
+    A -= d2;
+    B += d1;
+    C -= d1;
+    D += d2;
+
+    buf[-2 * offset] = XEVE_CLIP3(0, max_val, A);
+    buf[-offset] = XEVE_CLIP3(0, max_val, B);
+    buf[0] = XEVE_CLIP3(0, max_val, C);
+    buf[offset] = XEVE_CLIP3(0, max_val, D);
 }
 
-static void deblock_scu_hor_chroma(pel *buf, int qp, int stride, int is_luma, const u8 *tbl_qp_to_st, int bit_depth_minus8, int chroma_format_idc)
+static void deblock_line_chroma(pel *buf, int offset, s16 st, int max_val)
 {
     s16 A, B, C, D, d, d1;
-    s16 abs, t16, clip, sign, st;
-    int i, size;
+    s16 abs, t16, clip, sign;
 
-    st = tbl_qp_to_st[qp] << bit_depth_minus8;
-    size = (is_luma ? MIN_CU_SIZE : (MIN_CU_SIZE >> (XEVE_GET_CHROMA_W_SHIFT(chroma_format_idc))));
+    A = buf[-2 * offset];
+    B = buf[-offset];
+    C = buf[0];
+    D = buf[offset];
 
-    if(st)
-    {
-        for(i = 0; i < size; i++)
-        {
-            A = buf[-2 * stride];
-            B = buf[-stride];
-            C = buf[0];
-            D = buf[stride];
+    d = (A - (B << 2) + (C << 2) - D) / 8;
+
+    abs = XEVE_ABS16(d);
+    sign = XEVE_SIGN_GET(d);
 
-            d = (A - (B << 2) + (C << 2) - D) / 8;
+    t16 = XEVE_MAX(0, ((abs - st) << 1));
+    clip = XEVE_MAX(0, (abs - t16));
+    d1 = XEVE_SIGN_SET(clip, sign);
 
-            abs = XEVE_ABS16(d);
-            sign = XEVE_SIGN_GET(d);
+    B += d1;
+    C -= d1;
 
-            t16 = XEVE_MAX(0, ((abs - st) << 1));
-            clip = XEVE_MAX(0, (abs - t16));
-            d1 = XEVE_SIGN_SET(clip, sign);
+    buf[-offset] = XEVE_CLIP3(0, max_val, B);
+    buf[0] = XEVE_CLIP3(0, max_val, C);
+}
 
-            B += d1;
-            C -= d1;
+/* edge filters: buf points to the first sample below (hor) or right of (ver)
+   the edge, st holds the filter strength of each of the len lines crossing it */
+void xeve_dbk_luma_hor(pel *buf, int stride, const s16 *st, int len, int bit_depth)
+{
+    int i, max_val = (1 << bit_depth) - 1;
 
-            buf[-stride] = XEVE_CLIP3(0, (1 << (bit_depth_minus8 + 8)) - 1, B);
-            buf[0] = XEVE_CLIP3(0, (1 << (bit_depth_minus8 + 8)) - 1, C);
-            buf++;
+    for(i = 0; i < len; i++)
+    {
+        if(st[i])
+        {
+            deblock_line_luma(buf + i, stride, st[i], max_val);
         }
     }
 }
 
-static void deblock_scu_ver(pel *buf, int qp, int stride, int is_luma, const u8 *tbl_qp_to_st, int bit_depth_minus8)
+void xeve_dbk_luma_ver(pel *buf, int stride, const s16 *st, int len, int bit_depth)
 {
-    s16 A, B, C, D, d, d1, d2;
-    s16 abs, t16, clip, sign, st;
-    int i, size;
+    int i, max_val = (1 << bit_depth) - 1;
 
-    st = tbl_qp_to_st[qp] << bit_depth_minus8;
-    size = MIN_CU_SIZE;
-
-    if(st)
+    for(i = 0; i < len; i++)
     {
-        for(i = 0; i < size; i++)
+        if(st[i])
         {
-            A = buf[-2];
-            B = buf[-1];
-            C = buf[0];
-            D = buf[1];
-
-            d = (A - (B << 2) + (C << 2) - D) / 8;
-
-            abs = XEVE_ABS16(d);
-            sign = XEVE_SIGN_GET(d);
-
-            t16 = XEVE_MAX(0, ((abs - st) << 1));
-            clip = XEVE_MAX(0, (abs - t16));
-            d1 = XEVE_SIGN_SET(clip, sign);
-            clip >>= 1;
-            d2 = XEVE_CLIP3(-clip, clip, ((A - D) / 4));
-
-            A -= d2;
-            B += d1;
-            C -= d1;
-            D += d2;
-
-            buf[-2] = XEVE_CLIP3(0, (1 << (bit_depth_minus8 + 8)) - 1, A);
-            buf[-1] = XEVE_CLIP3(0, (1 << (bit_depth_minus8 + 8)) - 1, B);
-            buf[0] = XEVE_CLIP3(0, (1 << (bit_depth_minus8 + 8)) - 1, C);
-            buf[1] = XEVE_CLIP3(0, (1 << (bit_depth_minus8 + 8)) - 1, D);
-            buf += stride;
+            deblock_line_luma(buf + i * stride, 1, st[i], max_val);
         }
     }
 }
 
-static void deblock_scu_ver_chroma(pel *buf, int qp, int stride, int is_luma, const u8 *tbl_qp_to_st, int bit_depth_minus8, int chroma_format_idc)
+void xeve_dbk_chroma_hor(pel *buf, int stride, const s16 *st, int len, int bit_depth)
 {
-    s16 A, B, C, D, d, d1;
-    s16 abs, t16, clip, sign, st;
-    int i, size;
-
-    st = tbl_qp_to_st[qp] << bit_depth_minus8;
-    size = (is_luma ? MIN_CU_SIZE : (MIN_CU_SIZE >> (XEVE_GET_CHROMA_H_SHIFT(chroma_format_idc))));
+    int i, max_val = (1 << bit_depth) - 1;
 
-    if(st)
+    for(i = 0; i < len; i++)
     {
-        for(i = 0; i < size; i++)
+        if(st[i])
         {
-            A = buf[-2];
-            B = buf[-1];
-            C = buf[0];
-            D = buf[1];
-
-            d = (A - (B << 2) + (C << 2) - D) / 8;
+            deblock_line_chroma(buf + i, stride, st[i], max_val);
+        }
+    }
+}
 
-            abs = XEVE_ABS16(d);
-            sign = XEVE_SIGN_GET(d);
+void xeve_dbk_chroma_ver(pel *buf, int stride, const s16 *st, int len, int bit_depth)
+{
+    int i, max_val = (1 << bit_depth) - 1;
 
-            t16 = XEVE_MAX(0, ((abs - st) << 1));
-            clip = XEVE_MAX(0, (abs - t16));
-            d1 = XEVE_SIGN_SET(clip, sign);
+    for(i = 0; i < len; i++)
+    {
+        if(st[i])
+        {
+            deblock_line_chroma(buf + i * stride, 1, st[i], max_val);
+        }
+    }
+}
 
-            B += d1;
-            C -= d1;
+static void deblock_set_st(s16 *st, int size, s16 val)
+{
+    int i;
 
-            buf[-1] = XEVE_CLIP3(0, (1 << (bit_depth_minus8+8)) - 1, B);
-            buf[0] = XEVE_CLIP3(0, (1 << (bit_depth_minus8 + 8)) - 1, C);
-            buf += stride;
-        }
+    for(i = 0; i < size; i++)
+    {
+        st[i] = val;
     }
 }
 
@@ -270,6 +237,8 @@ void xeve_deblock_cu_hor(XEVE_PIC *pic, int x_pel, int y_pel, int cuw, int cuh,
     int         t1, t_copy;
     int         w_shift = XEVE_GET_CHROMA_W_SHIFT(chroma_format_idc);
     int         h_shift = XEVE_GET_CHROMA_H_SHIFT(chroma_format_idc);
+    int         size_c = MIN_CU_SIZE >> w_shift;
+    s16         st_l[MAX_CU_SIZE], st_u[MAX_CU_SIZE], st_v[MAX_CU_SIZE];
 
     t = (x_pel >> MIN_CU_LOG2) + (y_pel >> MIN_CU_LOG2) * w_scu;
     t_copy = t;
@@ -295,27 +264,34 @@ void xeve_deblock_cu_hor(XEVE_PIC *pic, int x_pel, int y_pel, int cuw, int cuh,
     /* horizontal filtering */
     if(y_pel > 0 && (no_boundary))
     {
-        for(i = 0; i < (cuw >> MIN_CU_LOG2); i++)
+        /* strengths of the whole edge are gathered first so that the
+           filter kernels can work on several SCUs at once */
+        for(i = 0; i < w; i++)
         {
             tbl_qp_to_st = get_tbl_qp_to_st(map_scu[i], map_scu[i - w_scu], map_refi[i], map_refi[i - w_scu], map_mv[i], map_mv[i - w_scu]);
-
             qp = MCU_GET_QP(map_scu[i]);
-            t = (i << MIN_CU_LOG2);
 
-            if (xeve_check_luma(tree_cons))
-            {
-                deblock_scu_hor(y + t, qp, s_l, 1, tbl_qp_to_st, bit_depth_luma - 8);
-            }
+            deblock_set_st(st_l + (i << MIN_CU_LOG2), MIN_CU_SIZE, tbl_qp_to_st[qp] << (bit_depth_luma - 8));
 
-            if(xeve_check_chroma(tree_cons) && chroma_format_idc)
+            if(chroma_format_idc)
             {
-                t = t >> w_shift;
                 int qp_u = XEVE_CLIP3(-6 * (bit_depth_chroma - 8), 57, qp + pic->pic_qp_u_offset);
                 int qp_v = XEVE_CLIP3(-6 * (bit_depth_chroma - 8), 57, qp + pic->pic_qp_v_offset);
-                deblock_scu_hor_chroma(u + t, qp_chroma_dynamic[0][qp_u], s_c, 0, tbl_qp_to_st, bit_depth_chroma - 8, chroma_format_idc);
-                deblock_scu_hor_chroma(v + t, qp_chroma_dynamic[1][qp_v], s_c, 0, tbl_qp_to_st, bit_depth_chroma - 8, chroma_format_idc);
+                deblock_set_st(st_u + i * size_c, size_c, tbl_qp_to_st[qp_chroma_dynamic[0][qp_u]] << (bit_depth_chroma - 8));
+                deblock_set_st(st_v + i * size_c, size_c, tbl_qp_to_st[qp_chroma_dynamic[1][qp_v]] << (bit_depth_chroma - 8));
             }
         }
+
+        if (xeve_check_luma(tree_cons))
+        {
+            xeve_func_dbk_luma_hor(y, s_l, st_l, cuw, bit_depth_luma);
+        }
+
+        if(xeve_check_chroma(tree_cons) && chroma_format_idc)
+        {
+            xeve_func_dbk_chroma_hor(u, s_c, st_u, w * size_c, bit_depth_chroma);
+            xeve_func_dbk_chroma_hor(v, s_c, st_v, w * size_c, bit_depth_chroma);
+        }
     }
 
     map_scu = map_scu_tmp;
@@ -329,18 +305,69 @@ void xeve_deblock_cu_hor(XEVE_PIC *pic, int x_pel, int y_pel, int cuw, int cuh,
     }
 }
 
+static void deblock_cu_ver_edge(XEVE_PIC *pic, pel *y, pel *u, pel *v, int h, u32 *map_scu, s8(*map_refi)[REFP_NUM], s16(*map_mv)[REFP_NUM][MV_D], int w_scu
+                              , TREE_CONS tree_cons, int bit_depth_luma, int bit_depth_chroma, int chroma_format_idc, int* qp_chroma_dynamic[2])
+{
+    const u8  * tbl_qp_to_st;
+    int         i, qp;
+    int         w_shift = XEVE_GET_CHROMA_W_SHIFT(chroma_format_idc);
+    int         h_shift = XEVE_GET_CHROMA_H_SHIFT(chroma_format_idc);
+    int         size_c = MIN_CU_SIZE >> h_shift;
+    int         step_c = MIN_CU_SIZE >> w_shift;
+    s16         st_l[MAX_CU_SIZE], st_u[MAX_CU_SIZE], st_v[MAX_CU_SIZE];
+
+    for(i = 0; i < h; i++)
+    {
+        tbl_qp_to_st = get_tbl_qp_to_st(map_scu[0], map_scu[-1], map_refi[0], map_refi[-1], map_mv[0], map_mv[-1]);
+        qp = MCU_GET_QP(map_scu[0]);
+
+        deblock_set_st(st_l + (i << MIN_CU_LOG2), MIN_CU_SIZE, tbl_qp_to_st[qp] << (bit_depth_luma - 8));
+
+        if(chroma_format_idc)
+        {
+            int qp_u = XEVE_CLIP3(-6 * (bit_depth_chroma - 8), 57, qp + pic->pic_qp_u_offset);
+            int qp_v = XEVE_CLIP3(-6 * (bit_depth_chroma - 8), 57, qp + pic->pic_qp_v_offset);
+            deblock_set_st(st_u + i * size_c, size_c, tbl_qp_to_st[qp_chroma_dynamic[0][qp_u]] << (bit_depth_chroma - 8));
+            deblock_set_st(st_v + i * size_c, size_c, tbl_qp_to_st[qp_chroma_dynamic[1][qp_v]] << (bit_depth_chroma - 8));
+        }
+
+        map_scu += w_scu;
+        map_refi += w_scu;
+        map_mv += w_scu;
+    }
+
+    if(xeve_check_luma(tree_cons))
+    {
+        xeve_func_dbk_luma_ver(y, pic->s_l, st_l, h << MIN_CU_LOG2, bit_depth_luma);
+    }
+
+    if(xeve_check_chroma(tree_cons) && chroma_format_idc)
+    {
+        if(size_c == step_c)
+        {
+            xeve_func_dbk_chroma_ver(u, pic->s_c, st_u, h * size_c, bit_depth_chroma);
+            xeve_func_dbk_chroma_ver(v, pic->s_c, st_v, h * size_c, bit_depth_chroma);
+        }
+        else
+        {
+            /* SCUs overlap in chroma rows, keep their filtering order */
+            for(i = 0; i < h; i++)
+            {
+                xeve_func_dbk_chroma_ver(u + i * step_c * pic->s_c, pic->s_c, st_u + i * size_c, size_c, bit_depth_chroma);
+                xeve_func_dbk_chroma_ver(v + i * step_c * pic->s_c, pic->s_c, st_v + i * size_c, size_c, bit_depth_chroma);
+            }
+        }
+    }
+}
+
 void xeve_deblock_cu_ver(XEVE_PIC *pic, int x_pel, int y_pel, int cuw, int cuh, u32 *map_scu, s8(*map_refi)[REFP_NUM], s16(*map_mv)[REFP_NUM][MV_D], int w_scu
                        , u32  *map_cu, TREE_CONS tree_cons, u8* map_tidx, int boundary_filtering, int bit_depth_luma, int bit_depth_chroma, int chroma_format_idc, int* qp_chroma_dynamic[2])
 {
     pel       * y, *u, *v;
-    const u8  * tbl_qp_to_st;
-    int         i, t, qp, s_l, s_c;
+    int         i, t, s_l, s_c;
     int         w = cuw >> MIN_CU_LOG2;
     int         h = cuh >> MIN_CU_LOG2;
     int         j;
-    u32       * map_scu_tmp;
-    s8       (* map_refi_tmp)[REFP_NUM];
-    s16      (* map_mv_tmp)[REFP_NUM][MV_D];
     int         t1, t2, t_copy; // Next row scu number
     int         w_shift = XEVE_GET_CHROMA_W_SHIFT(chroma_format_idc);
     int         h_shift = XEVE_GET_CHROMA_H_SHIFT(chroma_format_idc);
@@ -361,10 +388,6 @@ void xeve_deblock_cu_ver(XEVE_PIC *pic, int x_pel, int y_pel, int cuw, int cuh,
     u = pic->u + t;
     v = pic->v + t;
 
-    map_scu_tmp = map_scu;
-    map_refi_tmp = map_refi;
-    map_mv_tmp = map_mv;
-
     int no_boundary = 0;
     if (x_pel > 0)
     {
@@ -373,33 +396,8 @@ void xeve_deblock_cu_ver(XEVE_PIC *pic, int x_pel, int y_pel, int cuw, int cuh,
     /* vertical filtering */
     if(x_pel > 0 && MCU_GET_COD(map_scu[-1]) && (no_boundary))
     {
-        for(i = 0; i < (cuh >> MIN_CU_LOG2); i++)
-        {
-            tbl_qp_to_st = get_tbl_qp_to_st(map_scu[0], map_scu[-1], \
-                                            map_refi[0], map_refi[-1], map_mv[0], map_mv[-1]);
-            qp = MCU_GET_QP(map_scu[0]);
-
-            if (xeve_check_luma(tree_cons))
-            {
-                deblock_scu_ver(y, qp, s_l, 1, tbl_qp_to_st, bit_depth_luma - 8);
-            }
-
-            if (xeve_check_chroma(tree_cons) && chroma_format_idc)
-            {
-                int qp_u = XEVE_CLIP3(-6 * (bit_depth_chroma - 8), 57, qp + pic->pic_qp_u_offset);
-                int qp_v = XEVE_CLIP3(-6 * (bit_depth_chroma - 8), 57, qp + pic->pic_qp_v_offset);
-                deblock_scu_ver_chroma(u, qp_chroma_dynamic[0][qp_u], s_c, 0, tbl_qp_to_st, bit_depth_chroma - 8, chroma_format_idc);
-                deblock_scu_ver_chroma(v, qp_chroma_dynamic[1][qp_v], s_c, 0, tbl_qp_to_st, bit_depth_chroma - 8, chroma_format_idc);
-            }
-
-            y += (s_l << MIN_CU_LOG2);
-            u += (s_c << (MIN_CU_LOG2 - w_shift));
-            v += (s_c << (MIN_CU_LOG2 - w_shift));
-
-            map_scu += w_scu;
-            map_refi += w_scu;
-            map_mv += w_scu;
-        }
+        deblock_cu_ver_edge(pic, y, u, v, h, map_scu, map_refi, map_mv, w_scu, tree_cons
+                          , bit_depth_luma, bit_depth_chroma, chroma_format_idc, qp_chroma_dynamic);
     }
 
     no_boundary = 0;
@@ -408,48 +406,12 @@ void xeve_deblock_cu_ver(XEVE_PIC *pic, int x_pel, int y_pel, int cuw, int cuh,
         no_boundary = (map_tidx[t_copy] == map_tidx[t2]) || boundary_filtering;
     }
 
-    map_scu = map_scu_tmp;
-    map_refi = map_refi_tmp;
-    map_mv = map_mv_tmp;
     if(x_pel + cuw < pic->w_l && MCU_GET_COD(map_scu[w]) && (no_boundary))
     {
-        y = pic->y + x_pel + y_pel * s_l;
-        u = pic->u + t;
-        v = pic->v + t;
-
-        y += cuw;
-
-        u += (cuw >> w_shift);
-        v += (cuw >> w_shift);
-
-        for(i = 0; i < (cuh >> MIN_CU_LOG2); i++)
-        {
-            tbl_qp_to_st = get_tbl_qp_to_st(map_scu[w], map_scu[w - 1], map_refi[w], map_refi[w - 1], map_mv[w], map_mv[w - 1]);
-            qp = MCU_GET_QP(map_scu[w]);
-
-            if(xeve_check_luma(tree_cons))
-            {
-                deblock_scu_ver(y, qp, s_l, 1, tbl_qp_to_st, bit_depth_luma - 8);
-            }
-            if(xeve_check_chroma(tree_cons) && chroma_format_idc)
-            {
-                int qp_u = XEVE_CLIP3(-6 * (bit_depth_chroma - 8), 57, qp + pic->pic_qp_u_offset);
-                int qp_v = XEVE_CLIP3(-6 * (bit_depth_chroma - 8), 57, qp + pic->pic_qp_v_offset);
-                deblock_scu_ver_chroma(u, qp_chroma_dynamic[0][qp_u], s_c, 0, tbl_qp_to_st, bit_depth_chroma - 8, chroma_format_idc);
-                deblock_scu_ver_chroma(v, qp_chroma_dynamic[1][qp_v], s_c, 0, tbl_qp_to_st, bit_depth_chroma - 8, chroma_format_idc);
-            }
-
-            y += (s_l << MIN_CU_LOG2);
-            u += (s_c << (MIN_CU_LOG2 - w_shift));
-            v += (s_c << (MIN_CU_LOG2 - w_shift));
-
-            map_scu += w_scu;
-            map_refi += w_scu;
-            map_mv += w_scu;
-        }
+        deblock_cu_ver_edge(pic, y + cuw, u + (cuw >> w_shift), v + (cuw >> w_shift), h, map_scu + w, map_refi + w, map_mv + w, w_scu, tree_cons
+                          , bit_depth_luma, bit_depth_chroma, chroma_format_idc, qp_chroma_dynamic);
     }
 
-    map_scu = map_scu_tmp;
     for(i = 0; i < h; i++)
     {
         for(j = 0; j < w; j++)
@@ -31,6 +31,18 @@
 #ifndef _XEVE_DF_H_
 #define _XEVE_DF_H_
 
+typedef void (*XEVE_DBK)(pel *buf, int stride, const s16 *st, int len, int bit_depth);
+
+extern XEVE_DBK xeve_func_dbk_luma_hor;
+extern XEVE_DBK xeve_func_dbk_luma_ver;
+extern XEVE_DBK xeve_func_dbk_chroma_hor;
+extern XEVE_DBK xeve_func_dbk_chroma_ver;
+
+void xeve_dbk_luma_hor(pel *buf, int stride, const s16 *st, int len, int bit_depth);
+void xeve_dbk_luma_ver(pel *buf, int stride, const s16 *st, int len, int bit_depth);
+void xeve_dbk_chroma_hor(pel *buf, int stride, const s16 *st, int len, int bit_depth);
+void xeve_dbk_chroma_ver(pel *buf, int stride, const s16 *st, int len, int bit_depth);
+
 int  xeve_deblock(XEVE_CTX * ctx, XEVE_PIC * pic, int tile_idx, int filter_across_boundary, XEVE_CORE * core);
 void xeve_deblock_unit(XEVE_CTX * ctx, XEVE_PIC * pic, int x, int y, int cuw, int cuh, int is_hor_edge, XEVE_CORE * core, int boundary_filtering);
 void xeve_deblock_cu_hor(XEVE_PIC *pic, int x_pel, int y_pel, int cuw, int cuh, u32 *map_scu, s8 (*map_refi)[REFP_NUM], s16 (*map_mv)[REFP_NUM][MV_D]
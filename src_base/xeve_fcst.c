@@ -293,7 +293,7 @@ u64 get_lcu_var(XEVE_CTX * ctx, void * pic, int log2_w_max, int log2_h_max,
 
 
 
-static void adaptive_quantization(XEVE_CTX * ctx)
+static void adaptive_quantization(XEVE_CTX * ctx, XEVE_PICO * pico)
 {
     int         blk_size, blk_num, x, y, x_blk, y_blk, log2_cuwh;
     XEVE_FCST * fcst = &ctx->fcst;
@@ -313,15 +313,15 @@ static void adaptive_quantization(XEVE_CTX * ctx)
     y_blk        = 0;
     log2_cuwh    = fcst->log2_fcst_blk_spic +1; /* fcst block (subpic) + 1 for fullpic */
     blk_size     = 1 << log2_cuwh;
-    qp_offset = ctx->pico->sinfo.map_qp_blk;
+    qp_offset = pico->sinfo.map_qp_blk;
 
     h_blk = fcst->h_blk;
     w_blk = fcst->w_blk;
     f_blk = fcst->f_blk;
 
     aq_bd_const  = (ctx->sps.bit_depth_luma_minus8 + 7.2135) * 2;
-    s_l = ctx->pico->pic.s_l;
-    s_c = ctx->pico->pic.s_c;
+    s_l = pico->pic.s_l;
+    s_c = pico->pic.s_c;
 
     while(1)
     {
@@ -334,12 +334,12 @@ static void adaptive_quantization(XEVE_CTX * ctx)
         }
         else
         {
-            var  = get_lcu_var(ctx, ctx->pico->pic.buf_y, log2_cuwh,
+            var  = get_lcu_var(ctx, pico->pic.buf_y, log2_cuwh,
                 log2_cuwh, x, y, s_l);
             if(ctx->sps.chroma_format_idc)
             {
-                var += get_lcu_var(ctx, ctx->pico->pic.buf_u, log2_cuwh - w_shift, log2_cuwh - h_shift, (x >> w_shift), (y >> h_shift), s_c);
-                var += get_lcu_var(ctx, ctx->pico->pic.buf_v, log2_cuwh - w_shift, log2_cuwh - h_shift, (x >> w_shift), (y >> h_shift), s_c);
+                var += get_lcu_var(ctx, pico->pic.buf_u, log2_cuwh - w_shift, log2_cuwh - h_shift, (x >> w_shift), (y >> h_shift), s_c);
+                var += get_lcu_var(ctx, pico->pic.buf_v, log2_cuwh - w_shift, log2_cuwh - h_shift, (x >> w_shift), (y >> h_shift), s_c);
             }
         }
 
@@ -671,7 +671,7 @@ void fill_blk_scu_frm(XEVE_CTX* ctx,XEVE_PICO * pico, int log2_cuwh)
     }
 
 }
-static void blk_tree_fixed_gop(XEVE_CTX * ctx)
+static void blk_tree_fixed_gop(XEVE_CTX * ctx, XEVE_PICO * pico_anchor)
 {
     int          i,  bframes, pic_idx;
     XEVE_PICO  * pico, * pico_l0, * pico_l1;
@@ -681,7 +681,7 @@ static void blk_tree_fixed_gop(XEVE_CTX * ctx)
     s32        * qp_offset;
 
     bframes       = 0;
-    pic_icnt_last = ctx->pico->pic_icnt;
+    pic_icnt_last = pico_anchor->pic_icnt;
     gop_size = ctx->param.bframes + 1;
 
     max_depth = 0;
@@ -703,6 +703,8 @@ static void blk_tree_fixed_gop(XEVE_CTX * ctx)
             pic_idx = XEVE_MOD_IDX(pic_icnt_last - i, ctx->pico_max_cnt);
             pico = ctx->pico_buf[pic_idx];
             if (pico->sinfo.slice_depth != depth) continue;
+            /* nothing is transferred across a scene cut */
+            if (pico->sinfo.scene_cut) continue;
 
             pico_l0 = ctx->pico_buf[XEVE_MOD_IDX(pic_idx - pico->sinfo.ref_pic[REFP_0], ctx->pico_max_cnt)];
             pico_l1 = ctx->pico_buf[XEVE_MOD_IDX(pic_idx - pico->sinfo.ref_pic[REFP_1], ctx->pico_max_cnt)];
@@ -911,13 +913,13 @@ static void fcst_mc_bi_avg_l(pel pred[][4096], s32 cuw, s32 cuh, s32 cuwh, pel *
     }
 }
 
-static s32 xeve_est_intra_cost(XEVE_CTX * ctx, s32 x0, s32 y0)
+static s32 xeve_est_intra_cost(XEVE_CTX * ctx, XEVE_PICO * pico, s32 x0, s32 y0)
 {
     s32        x, y, i, mode, cuwh, log2_cuwh, s_o;
     s32        cost, cost_best, tot_cost, intra_penalty;
     u8         temp_avil[5] = { 0 };
     pel      * org;
-    XEVE_PIC * spic = ctx->pico->spic;
+    XEVE_PIC * spic = pico->spic;
     pel      * pred = ctx->rcore->pred;
     pel        buf_le0[65];
     pel        buf_up0[65 + 1];
@@ -1251,7 +1253,7 @@ void uni_direction_cost_estimation(XEVE_CTX * ctx, XEVE_PICO * pico_cur, XEVE_PI
     {
         if (intra_cost_compute)
         {
-            map_lcu_cost[lcu_num][INTRA] = xeve_est_intra_cost(ctx, x_lcu << log2_cuwh, y_lcu << log2_cuwh) +
+            map_lcu_cost[lcu_num][INTRA] = xeve_est_intra_cost(ctx, pico_cur, x_lcu << log2_cuwh, y_lcu << log2_cuwh) +
                                            ctx->rc->param->sub_pic_penalty;
             pico_cur->sinfo.uni_est_cost[INTRA] += map_lcu_cost[lcu_num][INTRA];
         }
@@ -1484,6 +1486,7 @@ void set_subpic(XEVE_CTX * ctx, XEVE_PICO* pico, int is_intra_pic)
     int gop_idx, gop_pos, pic_icnt = pico->pic_icnt;
     int gop_size = ctx->param.bframes + 1;
     pico->sinfo.scene_type = xeve_fcst_get_scene_type(ctx, pico);
+    pico->sinfo.scene_cut = 0;
 
     if (is_intra_pic)
     {
@@ -1523,18 +1526,18 @@ void set_subpic(XEVE_CTX * ctx, XEVE_PICO* pico, int is_intra_pic)
 
 }
 
-void get_fcost_fixed_gop(XEVE_CTX * ctx, int is_intra_pic)
+void get_fcost_fixed_gop(XEVE_CTX * ctx, XEVE_PICO * pico_anchor, int is_intra_pic)
 {
     XEVE_PICO* pico, * pico_ref, * pico_l0, * pico_l1;
     int           pico_ridx, pic_icnt;
     int        i, pic_icnt_last, depth, refp_l0, refp_l1, gop_size;
 
-    pic_icnt_last = ctx->pico->pic_icnt;
+    pic_icnt_last = pico_anchor->pic_icnt;
     gop_size = ctx->param.bframes + 1;
 
     if (ctx->param.gop_size == 1 && ctx->param.keyint != 1) //LD case
     {
-         pic_icnt = XEVE_MOD_IDX(ctx->pico->pic_icnt, ctx->pico_max_cnt);
+         pic_icnt = XEVE_MOD_IDX(pic_icnt_last, ctx->pico_max_cnt);
          pico = ctx->pico_buf[pic_icnt];
          refp_l0 = pico->sinfo.ref_pic[REFP_0];
          pico_ridx = XEVE_MOD_IDX(pic_icnt - refp_l0, ctx->pico_max_cnt);
@@ -1584,14 +1587,63 @@ void get_fcost_fixed_gop(XEVE_CTX * ctx, int is_intra_pic)
     }
 }
 
-int xeve_forecast_fixed_gop(XEVE_CTX* ctx)
+static int is_scene_cut(XEVE_CTX * ctx, XEVE_PICO * pico)
+{
+    s32 (* map_lcost)[4];
+    s64    cost_intra, cost_inter;
+    double bias;
+    int    blk_num, dist;
+
+    map_lcost = pico->sinfo.map_uni_lcost;
+    cost_intra = cost_inter = 0;
+
+    for (blk_num = 0; blk_num < ctx->fcst.f_blk; blk_num++)
+    {
+        cost_intra += map_lcost[blk_num][INTRA];
+        cost_inter += XEVE_MIN(map_lcost[blk_num][INTRA], map_lcost[blk_num][INTER_UNI0]);
+    }
+
+    /* farther reference pictures predict worse without a cut,
+       so the threshold is loosened by the distance weight */
+    dist = XEVE_CLIP3(1, 8, pico->sinfo.ref_pic[REFP_0]);
+    bias = (ctx->param.scenecut / 100.0) / tbl_rpic_dist_wt[dist - 1];
+
+    return cost_inter >= (1.0 - bias) * cost_intra;
+}
+
+/* code the anchor of the analyzed mini-GOP as an I-picture
+   when any of its pictures cannot be predicted from the past */
+static void set_scene_cut(XEVE_CTX * ctx, XEVE_PICO * pico_anchor)
 {
     XEVE_PICO * pico;
+    int         i, pic_icnt_last, gop_size;
+
+    pic_icnt_last = pico_anchor->pic_icnt;
+    gop_size      = ctx->param.bframes + 1;
+
+    if (pico_anchor->sinfo.slice_type == SLICE_I) return;
+
+    for (i = 0; i < gop_size; i++)
+    {
+        pico = ctx->pico_buf[XEVE_MOD_IDX(pic_icnt_last - i, ctx->pico_max_cnt)];
+
+        if (pico->sinfo.slice_type == SLICE_I) break;
+        if (is_scene_cut(ctx, pico))
+        {
+            pico_anchor->sinfo.slice_type  = SLICE_I;
+            pico_anchor->sinfo.slice_depth = FRM_DEPTH_0;
+            pico_anchor->sinfo.scene_cut   = 1;
+            break;
+        }
+    }
+}
+
+int xeve_forecast_fixed_gop(XEVE_CTX* ctx, XEVE_PICO * pico)
+{
     int        i_period, is_intra_pic = 0;
     int        pic_icnt;
 
-    pico      = ctx->pico;
-    pic_icnt  = ctx->pico->pic_icnt;
+    pic_icnt  = pico->pic_icnt;
     i_period  = ctx->param.keyint;
     int gop_size = ctx->param.bframes + 1;
 
@@ -1605,19 +1657,125 @@ int xeve_forecast_fixed_gop(XEVE_CTX* ctx)
 
     if (((pic_icnt % gop_size == 0) && (pic_icnt != 0) && ctx->param.use_fcst) || gop_size == 1)
     {
-        get_fcost_fixed_gop(ctx, is_intra_pic);
+        get_fcost_fixed_gop(ctx, pico, is_intra_pic);
+
+        if (ctx->param.scenecut)
+        {
+            set_scene_cut(ctx, pico);
+        }
     }
 
     if (ctx->param.aq_mode != 0)
     {
-        adaptive_quantization(ctx);
+        adaptive_quantization(ctx, pico);
     }
 
     if ((pic_icnt % gop_size == 0) && (pic_icnt != 0) && \
         (ctx->param.cutree != 0))
     {
-        blk_tree_fixed_gop(ctx);
+        blk_tree_fixed_gop(ctx, pico);
     }
     return XEVE_OK;
 }
 
+/* analyze the submitted pictures in input order until none is left, a
+   picture uses the results of the previous ones */
+static int forecast_task(void * arg)
+{
+    XEVE_CTX  * ctx = (XEVE_CTX *)arg;
+    XEVE_FCST * fcst = &ctx->fcst;
+    int         ret;
+
+    do
+    {
+        ret = xeve_forecast_fixed_gop(ctx, ctx->pico_buf[fcst->done_cnt % ctx->pico_max_cnt]);
+        if (ret != XEVE_OK)
+        {
+            /* release the waiting encoder, the error is in the task group */
+            threadsafe_assign(ctx->sync_block, &fcst->done_cnt, INT_MAX);
+            return ret;
+        }
+        threadsafe_assign(ctx->sync_block, &fcst->done_cnt, fcst->done_cnt + 1);
+    } while (threadsafe_fetch_add(&fcst->queued, -1) > 1);
+
+    return XEVE_OK;
+}
+
+/* wait until the first cnt submitted pictures are analyzed */
+static int forecast_wait_cnt(XEVE_CTX * ctx, int cnt)
+{
+    XEVE_FCST * fcst = &ctx->fcst;
+
+    cnt = XEVE_MIN(cnt, fcst->sub_cnt);
+    if (fcst->done_cnt < cnt)
+    {
+        spinlock_wait_progress(ctx->sync_block, &fcst->done_cnt, cnt, NULL);
+    }
+    if (fcst->done_cnt == INT_MAX)
+    {
+        /* the task failed, its result is set once it returned */
+        return task_group_wait(ctx->ts, &fcst->grp);
+    }
+    return fcst->grp.result;
+}
+
+int xeve_forecast_wait(XEVE_CTX * ctx)
+{
+    if (ctx->fcst.sub_cnt == 0)
+    {
+        return XEVE_OK;
+    }
+    return task_group_wait(ctx->ts, &ctx->fcst.grp);
+}
+
+int xeve_forecast_submit(XEVE_CTX * ctx, XEVE_PICO * pico)
+{
+    XEVE_FCST * fcst = &ctx->fcst;
+    int         ret;
+
+    xeve_assert_rv(pico->pic_icnt == fcst->sub_cnt, XEVE_ERR_UNEXPECTED);
+    fcst->sub_cnt++;
+
+    if (ctx->param.threads <= 1)
+    {
+        /* no worker would take the task before the encoder waits for it */
+        ret = xeve_forecast_fixed_gop(ctx, pico);
+        fcst->done_cnt = fcst->sub_cnt;
+        return ret;
+    }
+
+    /* start the task unless it is running and takes the picture itself */
+    if (threadsafe_fetch_add(&fcst->queued, 1) == 0)
+    {
+        if (task_submit(ctx->ts, &fcst->grp, forecast_task, (void *)ctx) != THREAD_SUCCESS)
+        {
+            forecast_task((void *)ctx);
+        }
+    }
+
+    /* the next pushed picture reuses the pico_buf[] entry of an earlier
+       picture, which the analysis of the pictures up to a GOP after it reads */
+    return forecast_wait_cnt(ctx, pico->pic_icnt + 3 + ctx->param.gop_size - ctx->pico_max_cnt);
+}
+
+int xeve_forecast_sync(XEVE_CTX * ctx)
+{
+    int pic_need, t0;
+
+    if (FORCE_OUT(ctx))
+    {
+        return forecast_wait_cnt(ctx, INT_MAX);
+    }
+
+    /* latest picture decided by decide_slice_type(), the analysis of its
+       mini-GOP anchor also updates the qp map of the first picture */
+    pic_need = ctx->pic_cnt + ctx->param.bframes + (ctx->pic_cnt == 0 ? 1 : 0);
+    if (ctx->param.rc_type != 0)
+    {
+        /* rate control reads the future buffer over the lookahead window
+           and the scene changes shortly after the coded picture */
+        t0 = XEVE_MIN(ctx->param.fps, ctx->param.keyint) >> 3;
+        pic_need += XEVE_MAX(ctx->param.lookahead - ctx->param.bframes - 1, t0 - 1);
+    }
+    return forecast_wait_cnt(ctx, pic_need + 1);
+}
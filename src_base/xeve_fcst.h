@@ -90,7 +90,13 @@ enum QPA_TYPE
 #define B_PIC_ENABLED(ctx)           (ctx->param.bframes > 0)
 /* complexity threthold */
 
-int  xeve_forecast_fixed_gop(XEVE_CTX* ctx);
+int  xeve_forecast_fixed_gop(XEVE_CTX* ctx, XEVE_PICO * pico);
+/* queue the forecast of a pushed picture on the task scheduler */
+int  xeve_forecast_submit(XEVE_CTX * ctx, XEVE_PICO * pico);
+/* wait for the forecast results needed to encode the next picture */
+int  xeve_forecast_sync(XEVE_CTX * ctx);
+/* wait for the queued forecast */
+int  xeve_forecast_wait(XEVE_CTX * ctx);
 void xeve_gen_subpic(pel* src_y, pel* dst_y, int w, int h, int s_s, int d_s, int bit_depth);
 s32  xeve_fcst_get_scene_type(XEVE_CTX * ctx, XEVE_PICO * pico);
 
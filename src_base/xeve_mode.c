@@ -896,11 +896,11 @@ void copy_to_cu_data(XEVE_CTX *ctx, XEVE_CORE *core, XEVE_MODE *mi, s16 coef_src
             MCU_CLR_QP(cu_data->map_scu[idx + i]);
             if (ctx->pps.cu_qp_delta_enabled_flag)
             {
-                MCU_SET_IF_COD_SN_QP(cu_data->map_scu[idx + i], core->cu_mode == MODE_INTRA, ctx->slice_num, core->qp);
+                MCU_SET_IF_COD_SN_QP(cu_data->map_scu[idx + i], core->cu_mode == MODE_INTRA, ctx->tile_to_slice_map[core->tile_idx], core->qp);
             }
             else
             {
-                MCU_SET_IF_COD_SN_QP(cu_data->map_scu[idx + i], core->cu_mode == MODE_INTRA, ctx->slice_num, ctx->tile[core->tile_idx].qp);
+                MCU_SET_IF_COD_SN_QP(cu_data->map_scu[idx + i], core->cu_mode == MODE_INTRA, ctx->tile_to_slice_map[core->tile_idx], ctx->tile[core->tile_idx].qp);
             }
 
             if(cu_data->skip_flag[idx + i])
@@ -1186,10 +1186,15 @@ double mode_check_inter(XEVE_CTX *ctx, XEVE_CORE *core, int x, int y, int log2_c
     int end_comp = xeve_check_chroma(core->tree_cons) ? N_C : U_C;
     int     i, s_rec[N_C];
 
-    if (ctx->slice_type != SLICE_I && (ctx->sps.tool_admvp == 0 || !(log2_cuw <= MIN_CU_LOG2 && log2_cuh <= MIN_CU_LOG2)) && (!xeve_check_only_intra(core->tree_cons)))
+    if (ctx->slice_type != SLICE_I && (ctx->sps.tool_admvp == 0 || !(log2_cuw <= MIN_CU_LOG2 && log2_cuh <= MIN_CU_LOG2)) && (!xeve_check_only_intra(core->tree_cons))
+        && !xeve_refresh_is_intra(ctx, x, 1 << log2_cuw))
     {
         core->avail_cu = xeve_get_avail_inter(core->x_scu, core->y_scu, ctx->w_scu, ctx->h_scu, core->scup, core->cuw, core->cuh, ctx->map_scu, ctx->map_tidx);
         cost = ctx->fn_pinter_analyze_cu(ctx, core, x, y, log2_cuw, log2_cuh, mi, coef, rec, s_rec);
+        if (!xeve_refresh_check_mv(ctx, mi, x, 1 << log2_cuw))
+        {
+            cost = MAX_COST;
+        }
 
         if (cost < cost_best)
         {
@@ -1670,8 +1675,6 @@ void calc_delta_dist_filter_boundary(XEVE_CTX* ctx, XEVE_PIC *pic_rec, XEVE_PIC
     /********************************* filter the pred/rec **************************************/
     if(do_filter)
     {
-        pic_dbk->pic_deblock_alpha_offset = ctx->param.deblock_alpha_offset;
-        pic_dbk->pic_deblock_beta_offset = ctx->param.deblock_beta_offset;
         int w_scu = cuw >> MIN_CU_LOG2;
         int h_scu = cuh >> MIN_CU_LOG2;
         int ind, k;
@@ -1910,8 +1913,7 @@ static double mode_coding_tree(XEVE_CTX *ctx, XEVE_CORE *core, int x0, int y0, i
         cost_temp = 0.0;
         init_cu_data(&core->cu_data_temp[log2_cuw - 2][log2_cuh - 2], log2_cuw, log2_cuh, ctx->qp, ctx->qp, ctx->qp);
 
-        ctx->sh->qp_prev_mode = core->dqp_data[log2_cuw - 2][log2_cuh - 2].prev_qp;
-        best_dqp = ctx->sh->qp_prev_mode;
+        best_dqp = core->dqp_data[log2_cuw - 2][log2_cuh - 2].prev_qp;
         split_mode = NO_SPLIT;
         if(split_allow[split_mode] && (cuw <= check_max_cu && cuh <= check_max_cu))
         {
@@ -2505,11 +2507,25 @@ static void picbuf_expand(pel *a, int s, int w, int h, int exp)
 void xeve_pic_expand(XEVE_CTX *ctx, XEVE_PIC *pic)
 {
     xeve_picbuf_expand(pic, pic->pad_l, pic->pad_c, ctx->sps.chroma_format_idc);
+
+    if(pic->buf_pyr[0] != NULL)
+    {
+        xeve_picbuf_gen_pyr(pic->y, pic->s_l, pic->pyr, pic->s_pyr, pic->w_l, pic->h_l, pic->pad_l);
+    }
 }
 
 XEVE_PIC * xeve_pic_alloc(PICBUF_ALLOCATOR * pa, int * ret)
 {
-    return xeve_picbuf_alloc(pa->w, pa->h, pa->pad_l, pa->pad_c, pa->bit_depth, ret, pa->chroma_format_idc);
+    XEVE_PIC * pic;
+
+    pic = xeve_picbuf_alloc(pa->w, pa->h, pa->pad_l, pa->pad_c, pa->bit_depth, ret, pa->chroma_format_idc);
+    if(pic != NULL && pa->me_pyramid && xeve_picbuf_alloc_pyr(pic->buf_pyr, pic->pyr, pic->s_pyr, pic->w_l, pic->h_l, pic->pad_l) != XEVE_OK)
+    {
+        xeve_picbuf_free(pic);
+        if(ret) *ret = XEVE_ERR_OUT_OF_MEMORY;
+        return NULL;
+    }
+    return pic;
 }
 
 void xeve_pic_free(PICBUF_ALLOCATOR *pa, XEVE_PIC *pic)
@@ -730,7 +730,38 @@ static u32 pinter_me_epzs(XEVE_PINTER * pi, int x, int y, int log2_cuw, int log2
         }
     }
 
-    if(bi == BI_NON && beststep > RASTER_SEARCH_THD  && pi->me_complexity > 1)
+    if(bi != BI_NORMAL && xeve_pinter_pyr_mv(pi, x, y, log2_cuw, log2_cuh, lidx, ri, mvt))
+    {
+        s16 range_pyr[MV_RANGE_DIM][MV_D];
+
+        /* search also around the motion found on the pyramid */
+        mvc[MV_X] = XEVE_CLIP3(pi->min_clip[MV_X], pi->max_clip[MV_X], x + mvt[MV_X]);
+        mvc[MV_Y] = XEVE_CLIP3(pi->min_clip[MV_Y], pi->max_clip[MV_Y], y + mvt[MV_Y]);
+        mvi[MV_X] = mvc[MV_X] << 2;
+        mvi[MV_Y] = mvc[MV_Y] << 2;
+
+        get_range_ipel(pi, mvc, range_pyr, 0, ri, lidx);
+
+        cost = me_ipel_diamond(pi, x, y, log2_cuw, log2_cuh, ri, lidx, range_pyr, gmvp, mvi, mvt, bi, &tmpstep, MAX_REFINE_SEARCH_STEP, bit_depth_luma);
+        if(cost < cost_best)
+        {
+            cost_best = cost;
+            mv[MV_X] = mvt[MV_X];
+            mv[MV_Y] = mvt[MV_Y];
+            if(abs(mvp[MV_X] - mv[MV_X]) < 2 && abs(mvp[MV_Y] - mv[MV_Y]) < 2)
+            {
+                beststep = 0;
+            }
+            else
+            {
+                beststep = tmpstep;
+            }
+        }
+    }
+
+    /* the raster search is replaced by the pyramid search when the pyramid
+       covers the search range */
+    if(bi == BI_NON && beststep > RASTER_SEARCH_THD  && pi->me_complexity > 1 && !xeve_pinter_pyr_covers(pi, x, y, lidx, ri, range))
     {
         cost = me_raster(pi, x, y, log2_cuw, log2_cuh, ri, lidx, range, gmvp, mvt, bit_depth_luma);
 
@@ -1582,6 +1613,161 @@ static int pinter_init_mt(XEVE_CTX *ctx, int thread_idx)
     return XEVE_OK;
 }
 
+/* SAD search of a block of a pyramid level around the center motion within
+   the range, the motion is kept inside the padded reference */
+static void pinter_pyr_search_blk(XEVE_PIC *pic_o, XEVE_PIC *pic_r, int lev, int x, int y, int log2_blk,
+                                  int range, s16 mvc[MV_D], s16 mv[MV_D], int bit_depth)
+{
+    int s_o = pic_o->s_pyr[lev];
+    int s_r = pic_r->s_pyr[lev];
+    int pad = pic_r->pad_l >> (lev + 1);
+    int w = (pic_r->w_l + (2 << lev) - 1) >> (lev + 1);
+    int h = (pic_r->h_l + (2 << lev) - 1) >> (lev + 1);
+    int blk = 1 << log2_blk;
+    int min_x, max_x, min_y, max_y, mx, my;
+    pel *org, *ref;
+    u32 sad, sad_best;
+
+    min_x = XEVE_MAX(mvc[MV_X] - range, -pad - x);
+    max_x = XEVE_MIN(mvc[MV_X] + range, w + pad - blk - x);
+    min_y = XEVE_MAX(mvc[MV_Y] - range, -pad - y);
+    max_y = XEVE_MIN(mvc[MV_Y] + range, h + pad - blk - y);
+
+    org = pic_o->pyr[lev] + y * s_o + x;
+    ref = pic_r->pyr[lev] + y * s_r + x;
+
+    /* the zero motion is kept unless a position is strictly better */
+    mv[MV_X] = mv[MV_Y] = 0;
+    sad_best = xeve_sad_16b(log2_blk, log2_blk, org, ref, s_o, s_r, bit_depth);
+
+    for(my = min_y; my <= max_y; my++)
+    {
+        for(mx = min_x; mx <= max_x; mx++)
+        {
+            sad = xeve_sad_16b(log2_blk, log2_blk, org, ref + my * s_r + mx, s_o, s_r, bit_depth);
+            if(sad < sad_best)
+            {
+                sad_best = sad;
+                mv[MV_X] = mx;
+                mv[MV_Y] = my;
+            }
+        }
+    }
+}
+
+/* hierarchical motion pre-search of the current CTU: full search at 1/4
+   resolution on blocks of twice the size of the motion field blocks, then
+   refinement at 1/2 resolution on each block of the motion field. the range
+   at 1/4 resolution follows the integer-pel search range of the reference */
+static void pinter_pyr_search(XEVE_CTX *ctx, XEVE_CORE *core, XEVE_PINTER *pi)
+{
+    XEVE_PIC *pic_o = pi->pic_o;
+    XEVE_PIC *pic_r;
+    int lidx, refi, i, j, k, x, y, xs, ys, range, offset;
+    int num_lidx = (ctx->slice_type == SLICE_B) ? REFP_NUM : 1;
+    int log2_blk = XEVE_ME_PYR_LOG2_BLK - 1;
+    int blk = 1 << XEVE_ME_PYR_LOG2_BLK;
+    int bit_depth = ctx->param.codec_bit_depth;
+    s16 zero[MV_D] = {0, 0};
+    s16 mv2[MV_D], mvc[MV_D], mv1[MV_D];
+
+    offset = pi->gop_size >> 1;
+
+    for(lidx = 0; lidx < num_lidx; lidx++)
+    {
+        for(refi = 0; refi < ctx->rpm.num_refp[lidx]; refi++)
+        {
+            pic_r = pi->refp[refi][lidx].pic;
+            if(pic_r == NULL || pic_r->pyr[0] == NULL)
+            {
+                xeve_mset(pi->pyr_mv[lidx][refi], 0, sizeof(pi->pyr_mv[lidx][refi]));
+                pi->pyr_cover[lidx][refi] = 0;
+                continue;
+            }
+
+            /* same scaling by the POC distance as get_range_ipel() */
+            range = XEVE_CLIP3(pi->max_search_range >> 2, pi->max_search_range, (pi->max_search_range * XEVE_ABS(pi->poc - (int)pi->refp[refi][lidx].poc) + offset) / pi->gop_size);
+            range = XEVE_CLIP3(1, XEVE_ME_PYR_RANGE, (range + 3) >> 2);
+            /* 1/4 resolution search and +-2 refinement at 1/2 resolution */
+            pi->pyr_cover[lidx][refi] = (range << 2) + 4;
+
+            for(i = 0; i < ctx->max_cuwh; i += blk << 1)
+            {
+                for(j = 0; j < ctx->max_cuwh; j += blk << 1)
+                {
+                    x = core->x_pel + j;
+                    y = core->y_pel + i;
+                    if(x >= pic_o->w_l || y >= pic_o->h_l)
+                    {
+                        continue;
+                    }
+
+                    pinter_pyr_search_blk(pic_o, pic_r, 1, x >> 2, y >> 2, log2_blk, range, zero, mv2, bit_depth);
+
+                    mvc[MV_X] = mv2[MV_X] << 1;
+                    mvc[MV_Y] = mv2[MV_Y] << 1;
+
+                    for(k = 0; k < 4; k++)
+                    {
+                        xs = x + (k & 1) * blk;
+                        ys = y + (k >> 1) * blk;
+                        if(xs < pic_o->w_l && ys < pic_o->h_l)
+                        {
+                            pinter_pyr_search_blk(pic_o, pic_r, 0, xs >> 1, ys >> 1, log2_blk, 2, mvc, mv1, bit_depth);
+                        }
+                        else
+                        {
+                            mv1[MV_X] = mvc[MV_X];
+                            mv1[MV_Y] = mvc[MV_Y];
+                        }
+                        xs = (j >> XEVE_ME_PYR_LOG2_BLK) + (k & 1);
+                        ys = (i >> XEVE_ME_PYR_LOG2_BLK) + (k >> 1);
+                        pi->pyr_mv[lidx][refi][ys * XEVE_ME_PYR_W + xs][MV_X] = mv1[MV_X] << 1;
+                        pi->pyr_mv[lidx][refi][ys * XEVE_ME_PYR_W + xs][MV_Y] = mv1[MV_Y] << 1;
+                    }
+                }
+            }
+        }
+    }
+}
+
+/* integer-pel motion found by the pyramid search for the block of the motion
+   field covering the center of the CU, return 0 if not searched */
+int xeve_pinter_pyr_mv(XEVE_PINTER *pi, int x, int y, int log2_cuw, int log2_cuh, int lidx, int refi, s16 mv[MV_D])
+{
+    int idx;
+
+    if(!pi->pyr_on)
+    {
+        return 0;
+    }
+
+    x += (1 << log2_cuw) >> 1;
+    y += (1 << log2_cuh) >> 1;
+    idx = ((y - pi->pyr_y) >> XEVE_ME_PYR_LOG2_BLK) * XEVE_ME_PYR_W + ((x - pi->pyr_x) >> XEVE_ME_PYR_LOG2_BLK);
+
+    mv[MV_X] = pi->pyr_mv[lidx][refi][idx][MV_X];
+    mv[MV_Y] = pi->pyr_mv[lidx][refi][idx][MV_Y];
+    return 1;
+}
+
+/* check if the integer-pel search range of a CU at (x, y) lies inside the
+   motion covered by the pyramid search, so that the raster search can be
+   skipped */
+int xeve_pinter_pyr_covers(XEVE_PINTER *pi, int x, int y, int lidx, int refi, s16 range[MV_RANGE_DIM][MV_D])
+{
+    int cover;
+
+    if(!pi->pyr_on)
+    {
+        return 0;
+    }
+
+    cover = pi->pyr_cover[lidx][refi];
+    return range[MV_RANGE_MIN][MV_X] >= x - cover && range[MV_RANGE_MAX][MV_X] <= x + cover &&
+           range[MV_RANGE_MIN][MV_Y] >= y - cover && range[MV_RANGE_MAX][MV_Y] <= y + cover;
+}
+
 int xeve_pinter_init_lcu(XEVE_CTX *ctx, XEVE_CORE *core)
 {
     XEVE_PINTER *pi = &ctx->pinter[core->thread_cnt];
@@ -1593,6 +1779,14 @@ int xeve_pinter_init_lcu(XEVE_CTX *ctx, XEVE_CORE *core)
     pi->poc       = ctx->poc.poc_val;
     pi->gop_size  = ctx->param.gop_size;
 
+    pi->pyr_on    = ctx->param.me_pyramid && ctx->slice_type != SLICE_I && pi->pic_o->pyr[0] != NULL;
+    if(pi->pyr_on)
+    {
+        pi->pyr_x = core->x_pel;
+        pi->pyr_y = core->y_pel;
+        pinter_pyr_search(ctx, core, pi);
+    }
+
     return XEVE_OK;
 }
 
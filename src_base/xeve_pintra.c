@@ -63,9 +63,48 @@ int xeve_pintra_init_mt(XEVE_CTX * ctx, int tile_idx)
 
 int xeve_pintra_analyze_lcu(XEVE_CTX * ctx, XEVE_CORE * core)
 {
+    XEVE_PINTRA * pi = &ctx->pintra[core->thread_cnt];
+
+    /* cached costs were measured against the original of the previous CTU */
+    pi->cache_gen++;
+
     return XEVE_OK;
 }
 
+XEVE_PINTRA_CACHE * xeve_pintra_cache_get(XEVE_PINTRA * pi, XEVE_CORE * core, int log2_cuw, int log2_cuh, int * hit)
+{
+    XEVE_PINTRA_CACHE * cache;
+    const int cuw = 1 << log2_cuw;
+    const int cuh = 1 << log2_cuh;
+    /* neighbour samples written by get_nbr for the luma block */
+    const int len_le = cuw + cuh + 2;
+    const int len_up = cuw + (cuh << 1);
+    u32 key;
+
+    key = ((u32)core->x_scu << 16) ^ ((u32)core->y_scu << 6) ^ (log2_cuw << 3) ^ log2_cuh;
+    cache = &pi->cache[(key * 2654435761u) >> (32 - XEVE_PINTRA_CACHE_LOG2)];
+
+    *hit = cache->gen == pi->cache_gen && cache->x_scu == core->x_scu && cache->y_scu == core->y_scu
+        && cache->log2_cuw == log2_cuw && cache->log2_cuh == log2_cuh && cache->avail_lr == core->avail_lr
+        && !xeve_mcmp(cache->nb[0], core->nb[Y_C][0], len_le * sizeof(pel))
+        && !xeve_mcmp(cache->nb[1], core->nb[Y_C][1], len_up * sizeof(pel))
+        && !xeve_mcmp(cache->nb[2], core->nb[Y_C][2], len_le * sizeof(pel));
+
+    if(!*hit)
+    {
+        cache->gen = pi->cache_gen;
+        cache->x_scu = core->x_scu;
+        cache->y_scu = core->y_scu;
+        cache->log2_cuw = log2_cuw;
+        cache->log2_cuh = log2_cuh;
+        cache->avail_lr = core->avail_lr;
+        xeve_mcpy(cache->nb[0], core->nb[Y_C][0], len_le * sizeof(pel));
+        xeve_mcpy(cache->nb[1], core->nb[Y_C][1], len_up * sizeof(pel));
+        xeve_mcpy(cache->nb[2], core->nb[Y_C][2], len_le * sizeof(pel));
+    }
+    return cache;
+}
+
 static double pintra_residue_rdo(XEVE_CTX *ctx, XEVE_CORE *core, pel *org_luma, pel *org_cb, pel *org_cr, int s_org, int s_org_c, int log2_cuw
                                , int log2_cuh, s16 coef[N_C][MAX_CU_DIM], s32 *dist, int mode, int x, int y)
 {
@@ -179,6 +218,10 @@ static double make_ipred_list_simple(XEVE_CTX * ctx, XEVE_CORE * core, int log2_
     {
         pel * pred_buf = NULL;
 
+        if (!xeve_refresh_check_ipm(ctx, core->x_scu << MIN_CU_LOG2, cuw, i, 0))
+        {
+            continue;
+        }
         pred_buf = pi->pred_cache[i];
 
         pintra_ipred(ctx, core, pred_buf, i, cuw, cuh);
@@ -200,7 +243,8 @@ static double make_ipred_list_simple(XEVE_CTX * ctx, XEVE_CORE * core, int log2_
 static int make_ipred_list(XEVE_CTX * ctx, XEVE_CORE * core, int log2_cuw, int log2_cuh, pel * org, int s_org, int * ipred_list)
 {
     XEVE_PINTRA *pi = &ctx->pintra[core->thread_cnt];
-    int cuw, cuh, pred_cnt, i, j;
+    XEVE_PINTRA_CACHE *cache;
+    int cuw, cuh, pred_cnt, i, j, hit;
     double cost, cand_cost[IPD_RDO_CNT];
     u32 cand_satd_cost[IPD_RDO_CNT];
     u32 cost_satd;
@@ -217,17 +261,26 @@ static int make_ipred_list(XEVE_CTX * ctx, XEVE_CORE * core, int log2_cuw, int l
     }
 
     pred_cnt = IPD_CNT_B;
+    cache = xeve_pintra_cache_get(pi, core, log2_cuw, log2_cuh, &hit);
 
     for (i = 0; i < pred_cnt; i++)
     {
         int bit_cnt, shift = 0;
         pel * pred_buf = NULL;
 
-        pred_buf = pi->pred_cache[i];
+        if (!xeve_refresh_check_ipm(ctx, core->x_scu << MIN_CU_LOG2, cuw, i, 0))
+        {
+            continue;
+        }
+        if (!hit)
+        {
+            pred_buf = pi->pred_cache[i];
 
-        pintra_ipred(ctx, core, pred_buf, i, cuw, cuh);
+            pintra_ipred(ctx, core, pred_buf, i, cuw, cuh);
 
-        cost_satd = xeve_satd_16b(log2_cuw, log2_cuh, org, pred_buf, s_org, cuw, ctx->sps.bit_depth_luma_minus8+8);
+            cache->satd[i] = xeve_satd_16b(log2_cuw, log2_cuh, org, pred_buf, s_org, cuw, ctx->sps.bit_depth_luma_minus8+8);
+        }
+        cost_satd = cache->satd[i];
         cost = (double)cost_satd;
         SBAC_LOAD(core->s_temp_run, core->s_curr_best[log2_cuw - 2][log2_cuh - 2]);
         xeve_sbac_bit_reset(&core->s_temp_run);
@@ -269,6 +322,15 @@ static int make_ipred_list(XEVE_CTX * ctx, XEVE_CORE * core, int log2_cuw, int l
         }
     }
 
+    if(hit)
+    {
+        /* only the surviving candidates need a prediction for full RDO */
+        for(i = 0; i < XEVE_MIN(pred_cnt, ipd_rdo_cnt); i++)
+        {
+            pintra_ipred(ctx, core, pi->pred_cache[ipred_list[i]], ipred_list[i], cuw, cuh);
+        }
+    }
+
     return XEVE_MIN(pred_cnt, ipd_rdo_cnt);
 }
 
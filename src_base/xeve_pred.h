@@ -38,9 +38,12 @@ int xeve_pintra_create(XEVE_CTX * ctx, int complexity);
 int xeve_pintra_set_complexity(XEVE_CTX * ctx, int complexity);
 int xeve_pintra_init_mt(XEVE_CTX * ctx, int tile_idx);
 int xeve_pintra_analyze_lcu(XEVE_CTX * ctx, XEVE_CORE * core);
+XEVE_PINTRA_CACHE * xeve_pintra_cache_get(XEVE_PINTRA * pi, XEVE_CORE * core, int log2_cuw, int log2_cuh, int * hit);
 double xeve_pinter_analyze_cu(XEVE_CTX *ctx, XEVE_CORE *core, int x, int y, int log2_cuw, int log2_cuh, XEVE_MODE *mi, s16 coef[N_C][MAX_CU_DIM], pel *rec[N_C], int s_rec[N_C]);
 double xeve_pintra_analyze_cu_simple(XEVE_CTX* ctx, XEVE_CORE* core, int x, int y, int log2_cuw, int log2_cuh, s16 coef[N_C][MAX_CU_DIM]);
 int    xeve_pinter_init_lcu(XEVE_CTX *ctx, XEVE_CORE *core);
+int    xeve_pinter_pyr_mv(XEVE_PINTER *pi, int x, int y, int log2_cuw, int log2_cuh, int lidx, int refi, s16 mv[MV_D]);
+int    xeve_pinter_pyr_covers(XEVE_PINTER *pi, int x, int y, int lidx, int refi, s16 range[MV_RANGE_DIM][MV_D]);
 
 /* Inter prediction */
 extern const XEVE_PRED_INTER_COMP tbl_inter_pred_comp[2];
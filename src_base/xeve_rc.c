@@ -38,7 +38,7 @@
 const static XEVE_RC_PARAM tbl_rc_param =
 {
     32, 0, 1, 28, 1.3F, 1.13F, 0.4F, 1.4983F, 0.95F, 0.5F, 0.4F, 0.4F, 0.6F, 0.1F,
-    0.15F, 0.3F, 1.85F, 26, 14, 38, 0.04F, 0.5F, 4, 1.0397F, 4, 1.5F, 1.5F
+    0.15F, 0.3F, 1.85F, 26, 14, 38, 0.04F, 0.5F, 4, 1.0397F, 4, 1.5F, 1.5F, 0.6F
 };
 
 const static s32 tbl_ref_gop[4][32][2] =
@@ -100,6 +100,231 @@ __inline static double qf_to_qp(double qf)
     return 21.0 + 4.2 * log(qf / 0.85) * 2.88538;
 }
 
+/* complexity of a picture used by the model of its slice type */
+static s32 get_pico_cpx(XEVE_CTX * ctx, XEVE_PICO * pico, int stype)
+{
+    if (stype == SLICE_I)
+    {
+        return pico->sinfo.uni_est_cost[INTRA];
+    }
+    else if (stype == SLICE_P || (ctx->param.gop_size == 1 && ctx->param.keyint != 1))
+    {
+        return (ctx->param.bframes > 0) ? pico->sinfo.uni_est_cost[INTER_UNI2] : pico->sinfo.uni_est_cost[INTER_UNI0];
+    }
+    return pico->sinfo.bi_fcost;
+}
+
+static int rc_cmp_tex(const void * a, const void * b)
+{
+    double d = *(const double *)a - *(const double *)b;
+
+    return (d > 0) - (d < 0);
+}
+
+/* median of the complexities of the pictures of depth d0 to d1, of intra
+   pictures or not (any picture if intra is negative), returns the number
+   of these pictures */
+static int rc_pass_median(double * tex, s8 * cls, int cnt, int intra, int d0, int d1, double * buf, double * med)
+{
+    int i, n = 0;
+
+    for (i = 0; i < cnt; i++)
+    {
+        if (cls[i] >= 0 && (intra < 0 || (cls[i] & 1) == intra) && (cls[i] >> 1) >= d0 && (cls[i] >> 1) <= d1)
+        {
+            buf[n++] = tex[i];
+        }
+    }
+    if (n > 0)
+    {
+        qsort(buf, n, sizeof(double), rc_cmp_tex);
+        *med = buf[n >> 1];
+    }
+    return n;
+}
+
+/* distribute the bits of the whole sequence by the first pass statistics.
+   a picture gets bits in proportion to its texture complexity (bits x qf
+   of the first pass, or the forecast cost in the fast first pass)
+   compressed by qf_comp and weighted like the single pass target bits.
+   the texture complexity of a coded first pass is clipped around the
+   median of the pictures of the same slice type and depth for the plan,
+   a picture coded far off the rate of the others (e.g. at the minimum qp)
+   would otherwise take the bits of the whole sequence */
+static int rc_pass_plan(XEVE_CTX * ctx)
+{
+    XEVE_RC  * rc = ctx->rc;
+    FILE     * fp;
+    char       line[256];
+    int        w, h, bframes, pic, stype, sdepth, qp, cpx;
+    long long  bits;
+    double     tex, sum, med;
+    double   * buf;
+    s8       * cls;
+    int        i, c, cnt, coded;
+
+    fp = fopen(ctx->param.rc_stats, "r");
+    xeve_assert_rv(fp != NULL, XEVE_ERR_INVALID_ARGUMENT);
+
+    if (fgets(line, sizeof(line), fp) == NULL ||
+        sscanf(line, "#xeve-rc-stats w:%d h:%d bframes:%d", &w, &h, &bframes) != 3 ||
+        w != ctx->w || h != ctx->h || bframes != ctx->param.bframes)
+    {
+        fclose(fp);
+        xeve_assert_rv(0, XEVE_ERR_INVALID_ARGUMENT);
+    }
+
+    /* pictures are logged in coding order */
+    rc->pass_cnt = 0;
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        if (sscanf(line, "pic:%d", &pic) == 1 && pic >= rc->pass_cnt)
+        {
+            rc->pass_cnt = pic + 1;
+        }
+    }
+    if (rc->pass_cnt == 0)
+    {
+        fclose(fp);
+        xeve_assert_rv(0, XEVE_ERR_INVALID_ARGUMENT);
+    }
+    rc->pass_bits = (double *)xeve_malloc(sizeof(double) * rc->pass_cnt);
+    rc->pass_tex = (double *)xeve_malloc(sizeof(double) * rc->pass_cnt);
+    buf = (double *)xeve_malloc(sizeof(double) * rc->pass_cnt);
+    cls = (s8 *)xeve_malloc(sizeof(s8) * rc->pass_cnt);
+    if (rc->pass_bits == NULL || rc->pass_tex == NULL || buf == NULL || cls == NULL)
+    {
+        fclose(fp);
+        xeve_mfree(buf);
+        xeve_mfree(cls);
+        xeve_assert_rv(0, XEVE_ERR_OUT_OF_MEMORY);
+    }
+    xeve_mset(rc->pass_bits, 0, sizeof(double) * rc->pass_cnt);
+    xeve_mset(rc->pass_tex, 0, sizeof(double) * rc->pass_cnt);
+    xeve_mset(cls, -1, sizeof(s8) * rc->pass_cnt);
+
+    /* class of a picture: depth x 2 + 1 if intra */
+    rewind(fp);
+    cnt = 0;
+    coded = 0;
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        if (sscanf(line, "pic:%d type:%d depth:%d qp:%d bits:%lld cpx:%d",
+                   &pic, &stype, &sdepth, &qp, &bits, &cpx) != 6 || pic < 0)
+        {
+            continue;
+        }
+        tex = (bits > 0) ? bits * qp_to_qf(qp) : cpx;
+        rc->pass_tex[pic] = XEVE_MAX(tex, 1.0);
+        cls[pic] = (s8)((XEVE_CLIP3(0, 5, sdepth) << 1) + (stype == SLICE_I ? 1 : 0));
+        coded |= (bits > 0);
+        cnt++;
+    }
+    fclose(fp);
+    if (cnt == 0)
+    {
+        xeve_mfree(buf);
+        xeve_mfree(cls);
+        xeve_assert_rv(0, XEVE_ERR_INVALID_ARGUMENT);
+    }
+
+    xeve_mcpy(rc->pass_bits, rc->pass_tex, sizeof(double) * rc->pass_cnt);
+    if (coded)
+    {
+        /* a class of less than 3 pictures has no meaningful median, it is
+           clipped around the median of the neighboring depths, or of all
+           pictures */
+        for (c = 0; c < 12; c++)
+        {
+            if (rc_pass_median(rc->pass_tex, cls, rc->pass_cnt, c & 1, c >> 1, c >> 1, buf, &med) < 3 &&
+                rc_pass_median(rc->pass_tex, cls, rc->pass_cnt, c & 1, (c >> 1) - 1, (c >> 1) + 1, buf, &med) < 3)
+            {
+                rc_pass_median(rc->pass_tex, cls, rc->pass_cnt, -1, 0, 5, buf, &med);
+            }
+            for (i = 0; i < rc->pass_cnt; i++)
+            {
+                if (cls[i] == c)
+                {
+                    rc->pass_bits[i] = XEVE_CLIP3(med / 4, med * 4, rc->pass_tex[i]);
+                }
+            }
+        }
+    }
+
+    sum = 0;
+    for (i = 0; i < rc->pass_cnt; i++)
+    {
+        if (cls[i] < 0)
+        {
+            continue;
+        }
+        tex = pow(rc->pass_bits[i], rc->param->qf_comp) * rc->bpf_tid[cls[i] >> 1];
+        if ((cls[i] & 1) && ctx->param.keyint != 1)
+        {
+            tex *= rc->param->intra_rate_ratio;
+        }
+        rc->pass_bits[i] = tex;
+        sum += tex;
+    }
+    xeve_mfree(buf);
+    xeve_mfree(cls);
+
+    /* scale to the size of the sequence at the target bitrate */
+    for (i = 0; i < rc->pass_cnt; i++)
+    {
+        rc->pass_bits[i] *= (rc->bitrate / rc->fps) * cnt / sum;
+    }
+    rc->pass_scale = 1.0;
+    rc->pass_plan_cur = 0;
+    rc->pass_plan_sum = 0;
+    rc->pass_real_sum = 0;
+
+    /* the forecast cost of the fast first pass does not give the qf of a
+       picture, the single pass model is used with the planned bits */
+    if (!coded)
+    {
+        xeve_mfree(rc->pass_tex);
+        rc->pass_tex = NULL;
+    }
+    return XEVE_OK;
+}
+
+void xeve_rc_write_stats(XEVE_CTX * ctx, XEVE_PICO * pico, int stype, int sdepth, int qp, s64 bits)
+{
+    FILE * fp = ctx->rc->fp_stats;
+
+    if (fp == NULL)
+    {
+        return;
+    }
+    fprintf(fp, "pic:%d type:%d depth:%d qp:%d bits:%lld cpx:%d intra:%d inter:%d bi:%d\n",
+            pico->pic_icnt, stype, sdepth, qp, (long long)bits, get_pico_cpx(ctx, pico, stype),
+            pico->sinfo.uni_est_cost[INTRA], pico->sinfo.uni_est_cost[INTER_UNI0], pico->sinfo.bi_fcost);
+}
+
+int xeve_rc_fast_pass(XEVE_CTX * ctx)
+{
+    XEVE_PICO * pico;
+    int         sdepth;
+
+    /* analyzed pictures leave the lookahead window in input order */
+    pico = ctx->pico_buf[ctx->pic_cnt % ctx->pico_max_cnt];
+    if (pico->is_used && pico->pic_icnt == (int)ctx->pic_cnt)
+    {
+        /* the forecast numbers the anchor of the random access gop as depth 0 */
+        sdepth = pico->sinfo.slice_depth;
+        if (ctx->param.bframes > 0 && pico->sinfo.slice_type != SLICE_I)
+        {
+            sdepth++;
+        }
+        xeve_rc_write_stats(ctx, pico, pico->sinfo.slice_type, sdepth, 0, 0);
+        pico->pic.imgb->release(pico->pic.imgb);
+        pico->is_used = 0;
+        ctx->pic_cnt++;
+    }
+    return XEVE_OK_OUT_NOT_AVAILABLE;
+}
+
 int xeve_rc_create(XEVE_CTX * ctx)
 {
     /* create RC */
@@ -118,14 +343,33 @@ int xeve_rc_create(XEVE_CTX * ctx)
     ctx->rcore->pred = xeve_malloc(sizeof(pel) * rc_param->rc_blk_wh * rc_param->rc_blk_wh);
     xeve_mset(ctx->rcore->pred, 0, sizeof(pel) * rc_param->rc_blk_wh * rc_param->rc_blk_wh);
 
+    if (ctx->param.rc_pass == 1)
+    {
+        ctx->rc->fp_stats = fopen(ctx->param.rc_stats, "w");
+        xeve_assert_rv(ctx->rc->fp_stats != NULL, XEVE_ERR_INVALID_ARGUMENT);
+        fprintf(ctx->rc->fp_stats, "#xeve-rc-stats w:%d h:%d bframes:%d\n", ctx->w, ctx->h, ctx->param.bframes);
+    }
+    else if (ctx->param.rc_pass == 2)
+    {
+        return rc_pass_plan(ctx);
+    }
+
     return XEVE_OK;
 }
 
 int xeve_rc_delete(XEVE_CTX * ctx)
 {
+    if (ctx->rc->fp_stats != NULL)
+    {
+        fclose(ctx->rc->fp_stats);
+    }
+    xeve_mfree(ctx->rc->pass_bits);
+    xeve_mfree(ctx->rc->pass_tex);
     xeve_mfree(ctx->rcore->pred);
     xeve_mfree(ctx->rcore);
     xeve_mfree(ctx->rc);
+    ctx->rcore = NULL;
+    ctx->rc = NULL;
 
     return XEVE_OK;
 }
@@ -282,7 +526,8 @@ void xeve_init_rc(XEVE_CTX * ctx)
         rc->basecplx = f_blk * 650.0;
     }
 
-    if (ctx->param.gop_size == 1 && ctx->param.ref_pic_gap_length != 0)
+    /* rc_bpf_ld[] has no entry for the reference gap of 1 (st_idx of -1) */
+    if (ctx->param.gop_size == 1 && ctx->param.ref_pic_gap_length > 1)
     {
         xeve_init_rc_bpf_tbl(ctx);
     }
@@ -771,7 +1016,7 @@ static double get_vbv_qfactor(XEVE_CTX *ctx, XEVE_RCORE * rcore, s32 slice_type,
 static double get_qf(XEVE_CTX *ctx, XEVE_RCORE *rcore)
 {
     XEVE_PICO * pico;
-    double      cpx, qf, cpx_rate, target_bits, min_cp, max_cp;
+    double      cpx, qf, cpx_rate, target_bits, min_cp, max_cp, plan_rate;
     XEVE_RC   * rc = ctx->rc;
     rc->scene_cut = 0;
     /* compexity rate */
@@ -787,6 +1032,16 @@ static double get_qf(XEVE_CTX *ctx, XEVE_RCORE *rcore)
     rc->bpf = rc->bpf_tid[rc->scene_cut ? 0 : ctx->slice_depth];
     rc->rcm->target_bits += rc->bpf;
 
+    /* second pass: ratio of the bits planned over the whole sequence to the
+       bits of the fixed hierarchy, it replaces the intra and scene cut ratios */
+    plan_rate = 0;
+    rc->pass_plan_cur = 0;
+    if (rc->pass_bits != NULL && (int)ctx->pico->pic_icnt < rc->pass_cnt && rc->pass_bits[ctx->pico->pic_icnt] > 0)
+    {
+        rc->pass_plan_cur = rc->pass_bits[ctx->pico->pic_icnt];
+        plan_rate = rc->pass_plan_cur * rc->pass_scale / rc->bpf;
+    }
+
     /* target bits */
     target_bits = rc->rcm->target_bits;
     pico = ctx->pico;
@@ -795,7 +1050,7 @@ static double get_qf(XEVE_CTX *ctx, XEVE_RCORE *rcore)
     if (ctx->slice_type == SLICE_I)
     {
         rcore->cpx_frm = pico->sinfo.uni_est_cost[INTRA];
-        if (ctx->param.keyint != 1)
+        if (ctx->param.keyint != 1 && plan_rate == 0)
         {
             target_bits *= rc->param->intra_rate_ratio;
         }
@@ -814,9 +1069,13 @@ static double get_qf(XEVE_CTX *ctx, XEVE_RCORE *rcore)
         {
             rcore->cpx_frm = pico->sinfo.bi_fcost / (rc->scene_cut + 1);
         }
-        if (rc->scene_cut)
+        if (rc->scene_cut && plan_rate == 0)
             target_bits *= 1.3;
     }
+    if (plan_rate > 0)
+    {
+        target_bits *= plan_rate;
+    }
     /* cpx_pow */
     if (rcore->scene_type == SCENE_EX_LOW)
     {
@@ -997,6 +1256,13 @@ static double get_qfactor(XEVE_CTX *ctx)
     qf = get_qf(ctx, rcore);
     qf = get_qfactor_clip(ctx, rcore, qf);
 
+    if (rc->pass_tex != NULL && rc->pass_plan_cur > 0)
+    {
+        /* second pass over a coded first pass: the texture complexity
+           gives the qf of the planned bits */
+        qf = rc->pass_tex[ctx->pico->pic_icnt] / (rc->pass_plan_cur * rc->pass_scale);
+    }
+
     frm_qf_min = rcore->qf_min[rcore->stype];
     frm_qf_max = rcore->qf_max[rcore->stype];
 
@@ -1076,6 +1342,15 @@ void xeve_rc_update_frame(XEVE_CTX *ctx, XEVE_RC * rc, XEVE_RCORE * rcore)
         }
     }
 
+    if (rc->pass_plan_cur > 0)
+    {
+        /* the difference of the coded bits to the planned bits so far is
+           made up over the next second of pictures */
+        rc->pass_plan_sum += rc->pass_plan_cur;
+        rc->pass_real_sum += bits;
+        rc->pass_scale = XEVE_CLIP3(0.5, 2.0, 1.0 + (rc->pass_plan_sum - rc->pass_real_sum) / rc->bitrate);
+    }
+
     if (rcore->scene_type != SCENE_EX_LOW)
     {
         /* update RC model */
@@ -66,6 +66,8 @@ struct _XEVE_RC_PARAM
     int   aq_log2_blk_size;
     float aq_mode_str;
     float lcu_tree_str;
+    /* complexity compression of the second pass bit allocation */
+    float qf_comp;
 };
 
 /*****************************************************************************
@@ -182,6 +184,21 @@ struct _XEVE_RC
     int          encoding_mode;
     int          scene_cut;
     double       basecplx;
+    /* multi-pass statistics file */
+    FILE       * fp_stats;
+    /* bits of every picture planned by the second pass (input order) */
+    double     * pass_bits;
+    /* texture complexity (bits x qf) of the coded first pass, NULL if the
+       first pass was fast */
+    double     * pass_tex;
+    int          pass_cnt;
+    /* scale of the planned bits following the achieved bitrate */
+    double       pass_scale;
+    /* planned bits of the current picture, sums of the planned and of the
+       coded bits of the pictures coded so far */
+    double       pass_plan_cur;
+    double       pass_plan_sum;
+    double       pass_real_sum;
 
     const XEVE_RC_PARAM * param;
 };
@@ -227,4 +244,8 @@ s32  xeve_rc_rcore_set(XEVE_CTX * ctx);
 void xeve_rc_update_frame(XEVE_CTX *ctx, XEVE_RC * rc, XEVE_RCORE * rcore);
 s32  xeve_rc_get_frame_qp(XEVE_CTX *ctx);
 int  xeve_rc_get_qp(XEVE_CTX *ctx);
+/* write the statistics of a coded (or analyzed) picture in the first pass */
+void xeve_rc_write_stats(XEVE_CTX * ctx, XEVE_PICO * pico, int stype, int sdepth, int qp, s64 bits);
+/* fast first pass: emit the oldest analyzed picture instead of encoding it */
+int  xeve_rc_fast_pass(XEVE_CTX * ctx);
 #endif
\ No newline at end of file
@@ -35,7 +35,7 @@
 const XEVE_FN_SAD  (* xeve_func_sad)[8];
 const XEVE_FN_SSD  (* xeve_func_ssd)[8];
 const XEVE_FN_DIFF (* xeve_func_diff)[8];
-const XEVE_FN_SATD  * xeve_func_satd;
+const XEVE_FN_SATD (* xeve_func_satd)[8];
 
 /* SAD for 16bit **************************************************************/
 int sad_16b(int w, int h, void *src1, void *src2, int s_src1, int s_src2, int bit_depth)
@@ -1194,7 +1194,94 @@ int xeve_had(int w, int h, void *o, void *c, int s_org, int s_cur, int bit_depth
 }
 
 /* index: [log2 of width][log2 of height] */
-const XEVE_FN_SATD xeve_tbl_satd_16b[1] =
+const XEVE_FN_SATD xeve_tbl_satd_16b[8][8] =
 {
-    xeve_had,
+    /* width == 1 */
+    {
+        xeve_had, /* height == 1 */
+        xeve_had, /* height == 2 */
+        xeve_had, /* height == 4 */
+        xeve_had, /* height == 8 */
+        xeve_had, /* height == 16 */
+        xeve_had, /* height == 32 */
+        xeve_had, /* height == 64 */
+        xeve_had, /* height == 128 */
+    },
+    /* width == 2 */
+    {
+        xeve_had, /* height == 1 */
+        xeve_had, /* height == 2 */
+        xeve_had, /* height == 4 */
+        xeve_had, /* height == 8 */
+        xeve_had, /* height == 16 */
+        xeve_had, /* height == 32 */
+        xeve_had, /* height == 64 */
+        xeve_had, /* height == 128 */
+    },
+    /* width == 4 */
+    {
+        xeve_had, /* height == 1 */
+        xeve_had, /* height == 2 */
+        xeve_had, /* height == 4 */
+        xeve_had, /* height == 8 */
+        xeve_had, /* height == 16 */
+        xeve_had, /* height == 32 */
+        xeve_had, /* height == 64 */
+        xeve_had, /* height == 128 */
+    },
+    /* width == 8 */
+    {
+        xeve_had, /* height == 1 */
+        xeve_had, /* height == 2 */
+        xeve_had, /* height == 4 */
+        xeve_had, /* height == 8 */
+        xeve_had, /* height == 16 */
+        xeve_had, /* height == 32 */
+        xeve_had, /* height == 64 */
+        xeve_had, /* height == 128 */
+    },
+    /* width == 16 */
+    {
+        xeve_had, /* height == 1 */
+        xeve_had, /* height == 2 */
+        xeve_had, /* height == 4 */
+        xeve_had, /* height == 8 */
+        xeve_had, /* height == 16 */
+        xeve_had, /* height == 32 */
+        xeve_had, /* height == 64 */
+        xeve_had, /* height == 128 */
+    },
+    /* width == 32 */
+    {
+        xeve_had, /* height == 1 */
+        xeve_had, /* height == 2 */
+        xeve_had, /* height == 4 */
+        xeve_had, /* height == 8 */
+        xeve_had, /* height == 16 */
+        xeve_had, /* height == 32 */
+        xeve_had, /* height == 64 */
+        xeve_had, /* height == 128 */
+    },
+    /* width == 64 */
+    {
+        xeve_had, /* height == 1 */
+        xeve_had, /* height == 2 */
+        xeve_had, /* height == 4 */
+        xeve_had, /* height == 8 */
+        xeve_had, /* height == 16 */
+        xeve_had, /* height == 32 */
+        xeve_had, /* height == 64 */
+        xeve_had, /* height == 128 */
+    },
+    /* width == 128 */
+    {
+        xeve_had, /* height == 1 */
+        xeve_had, /* height == 2 */
+        xeve_had, /* height == 4 */
+        xeve_had, /* height == 8 */
+        xeve_had, /* height == 16 */
+        xeve_had, /* height == 32 */
+        xeve_had, /* height == 64 */
+        xeve_had, /* height == 128 */
+    }
 };
@@ -28,6 +28,10 @@
    POSSIBILITY OF SUCH DAMAGE.
 */
 
+#if defined(__linux__)
+#define _GNU_SOURCE /* sched_getaffinity() */
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include "xeve_thread_pool.h"
@@ -36,263 +40,87 @@
 #include <process.h>
 #else
 #include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#if defined(__linux__)
+#include <sched.h>
+#endif
+#endif
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <emmintrin.h>
+#define ts_pause() _mm_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#define ts_pause() __asm__ __volatile__("yield" ::: "memory")
+#else
+#define ts_pause()
 #endif
 
 #define WINDOWS_MUTEX_SYNC 0
 
-#if !defined(WIN32) && !defined(WIN64) 
+/* initial number of task entries of each worker queue */
+#define TASK_QUEUE_INIT_SIZE 64
+/* number of polls of a sync flag before the waiting thread is parked */
+#define SYNC_SPIN_COUNT      2000
 
-typedef struct _THREAD_CTX
-{
-    //synchronization members
-    pthread_t t_handle; //worker thread handle
-    pthread_attr_t tAttribute;//worker thread attribute
-    pthread_cond_t w_event; //wait event for worker thread
-    pthread_cond_t r_event; //wait event for main thread
-    pthread_mutex_t c_section; //for synchronization
+/* thread parked on a sync flag, linked into the list of its sync object */
+typedef struct _SYNC_WAITER SYNC_WAITER;
 
-    //member field to run  a task                   
-    THREAD_ENTRY task;
-    void * t_arg;
-    THREAD_STATUS t_status;
-    THREAD_RESULT task_result;
-    int thread_id;
-}THREAD_CTX;
+#if !defined(WIN32) && !defined(WIN64)
+
+#define THREAD_LOCAL __thread
+
+typedef pthread_t       TS_THREAD;
+typedef pthread_mutex_t TS_MUTEX;
+typedef pthread_cond_t  TS_COND;
 
 typedef struct _syncobject
 {
     pthread_mutex_t lmutex;
+    //threads parked on the sync flags guarded by this object
+    pthread_mutex_t park_lock;
+    SYNC_WAITER   * parked_list;
+    volatile int    parked;
 }THREAD_MUTEX;
 
-void * xeve_run_worker_thread(void * arg)
-{
-    /********************* main routine for thread pool worker thread *************************
-    ********************** worker thread can remain in suspended or running state *************
-    ********************* control the synchronization with help of thread context members *****/
-    
-    //member Initialization section
-    THREAD_CTX * t_context = (THREAD_CTX *)arg;
-    if (!t_context)
-    {
-        return 0; //error handling, more like a fail safe mechanism
-    }
-
-    while (1)
-    {
-        //worker thread loop
-        //remains suspended/sleep waiting for an event
-
-        //get the mutex and check the state
-        pthread_mutex_lock(&t_context->c_section);
-        while (t_context->t_status == THREAD_SUSPENDED)
-        {
-            //wait for the event
-            pthread_cond_wait(&t_context->w_event, &t_context->c_section);
-        }
-        
-        if (t_context->t_status == THREAD_TERMINATED)
-        {
-            t_context->task_result = THREAD_SUCCESS;
-            pthread_mutex_unlock(&t_context->c_section);
-            break;//exit the routine
-        }
-
-        t_context->t_status = THREAD_RUNNING;
-        pthread_mutex_unlock(&t_context->c_section);
-
-        //run the routine
-        //worker thread state is running with entry function and arg set
-        t_context->task(t_context->t_arg);
-
-        //signal the thread waiting on the result
-        pthread_mutex_lock(&t_context->c_section);
-        t_context->t_status = THREAD_SUSPENDED;
-        pthread_cond_signal(&t_context->r_event);
-        pthread_mutex_unlock(&t_context->c_section);
-    }
-
-    return 0;
-}
-
-
-POOL_THREAD  xeve_create_worker_thread(THREAD_CONTROLLER * tc, int thread_id)
+static void ts_mutex_init(TS_MUTEX * m)    { pthread_mutex_init(m, NULL); }
+static void ts_mutex_destroy(TS_MUTEX * m) { pthread_mutex_destroy(m); }
+static void ts_mutex_lock(TS_MUTEX * m)    { pthread_mutex_lock(m); }
+static void ts_mutex_unlock(TS_MUTEX * m)  { pthread_mutex_unlock(m); }
+static void ts_cond_init(TS_COND * c)      { pthread_cond_init(c, NULL); }
+static void ts_cond_destroy(TS_COND * c)   { pthread_cond_destroy(c); }
+static void ts_cond_wait(TS_COND * c, TS_MUTEX * m) { pthread_cond_wait(c, m); }
+static void ts_cond_broadcast(TS_COND * c) { pthread_cond_broadcast(c); }
+
+#define ts_load_acquire(p)     __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define ts_load_seq(p)         __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define ts_store_seq(p, v)     __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+#define ts_atomic_add(p, v)    __atomic_add_fetch((p), (v), __ATOMIC_SEQ_CST)
+#define ts_fetch_add(p, v)     __atomic_fetch_add((p), (v), __ATOMIC_SEQ_CST)
+
+//monotonic time in microseconds
+static long long ts_time_us()
 {
-    if (!tc)
-    {
-        return NULL; //error management 
-    }
-
-    THREAD_CTX * thread_context = NULL;
-
-
-    thread_context = (THREAD_CTX *)malloc(sizeof(THREAD_CTX));
-
-    if (!thread_context)
-    {
-        return NULL; //error management, bad alloc
-    }
-
-    int result = 1;
-
-    //intialize conditional variable and mutexes
-    result = pthread_mutex_init(&thread_context->c_section, NULL);
-    if (result)
-    {
-        goto TERROR; //error handling
-    }
-    result = pthread_cond_init(&thread_context->w_event, NULL);
-    if (result)
-    {
-        goto TERROR;
-    }
-    result = pthread_cond_init(&thread_context->r_event, NULL);
-    if (result)
-    {
-        goto TERROR;
-    }
-
-    //initialize the worker thread attribute and set the type to joinable
-    result = pthread_attr_init(&thread_context->tAttribute);
-    if (result)
-    {
-        goto TERROR;
-    }
-
-    result = pthread_attr_setdetachstate(&thread_context->tAttribute, PTHREAD_CREATE_JOINABLE);
-    if (result)
-    {
-        goto TERROR;
-    }
-
-    thread_context->task = NULL;
-    thread_context->t_arg = NULL;
-    thread_context->t_status = THREAD_SUSPENDED;
-    thread_context->task_result = THREAD_INVALID_STATE;
-    thread_context->thread_id = thread_id;
-    
-    //create the worker thread
-    result = pthread_create(&thread_context->t_handle, &thread_context->tAttribute, xeve_run_worker_thread, (void*)(thread_context));
-    if (result)
-    {
-        goto TERROR;
-    }
-
-    //dinit the attribue
-    pthread_attr_destroy(&thread_context->tAttribute);
-    return (POOL_THREAD)thread_context;
-
-TERROR:
-    pthread_mutex_destroy(&thread_context->c_section);
-    pthread_cond_destroy(&thread_context->w_event);
-    pthread_cond_destroy(&thread_context->r_event);
-    pthread_attr_destroy(&thread_context->tAttribute);
-    free(thread_context);
-
-    return NULL; //error handling, can't create a worker thread with proper initialization
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (long long)t.tv_sec * 1000000 + t.tv_nsec / 1000;
 }
 
+static void * ts_worker_entry(void * arg);
 
-THREAD_RESULT xeve_assign_task_thread(POOL_THREAD thread_id, THREAD_ENTRY entry, void * arg)
-{
-    //assign the task function and argument
-    //worker thread may be in running state or suspended state
-    //if worker thread is in suspended state, it can be waiting for first run or it has finished one task and is waiting again
-    //if worker thread is in running state, it will come to waiting state
-    //in any case, waiting on read event will always work
-
-    THREAD_CTX * t_context = (THREAD_CTX*)(thread_id);
-    if (!t_context)
-    {
-        return THREAD_INVALID_ARG;
-    }
-
-    //lock the mutex and wait on read event
-    pthread_mutex_lock(&t_context->c_section);
-    while (t_context->t_status == THREAD_RUNNING)
-    {
-        pthread_cond_wait(&t_context->r_event, &t_context->c_section);
-    }
-
-    //thread is in suspended state
-    t_context->t_status = THREAD_RUNNING;
-    t_context->task = entry;
-    t_context->t_arg = arg;
-    //signal the worker thread to wake up and run the task
-    pthread_cond_signal(&t_context->w_event);
-    pthread_mutex_unlock(&t_context->c_section); //release the lock
-
-    return THREAD_SUCCESS;
-}
-
-THREAD_RESULT  xeve_retrieve_thread_result(POOL_THREAD thread_id, int * res)
+static int ts_thread_create(TS_THREAD * t, void * arg)
 {
-    //whatever task has been assigned to worker thread
-    //wait for it to finish get the result
-
-    THREAD_CTX * t_context = (THREAD_CTX*)(thread_id);
-    if (!t_context)
-    {
-        return THREAD_INVALID_ARG;
-    }
-
-    THREAD_RESULT  result = THREAD_SUCCESS;
-
-    pthread_mutex_lock(&t_context->c_section);
-    while (THREAD_RUNNING == t_context->t_status)
-    {
-        pthread_cond_wait(&t_context->r_event, &t_context->c_section);
-    }
-
-    result = t_context->task_result;
-    pthread_mutex_unlock(&t_context->c_section);
-    *res = result;
-    return result;
+    return pthread_create(t, NULL, ts_worker_entry, arg) == 0;
 }
 
-
-THREAD_RESULT xeve_terminate_worker_thread(POOL_THREAD * thread_id)
+static void ts_thread_join(TS_THREAD t)
 {
-    //handler to close the thread
-    //close the thread handle
-    //release all the resource
-    // delete the thread context object
-
-    THREAD_CTX * t_context = (THREAD_CTX*)(*thread_id);
-    if (!t_context)
-    {
-        return THREAD_INVALID_ARG;
-    }
-
-    //The worker thread might be in suspended state or may be processing a task
-    pthread_mutex_lock(&t_context->c_section);
-    while (THREAD_RUNNING == t_context->t_status)
-    {
-        pthread_cond_wait(&t_context->r_event, &t_context->c_section);
-    }
-    
-    t_context->t_status = THREAD_TERMINATED;
-    pthread_cond_signal(&t_context->w_event);
-
-    pthread_mutex_unlock(&t_context->c_section);
-
-    //join the worker thread
-    pthread_join(t_context->t_handle, NULL);
-
-    //clean all the synchronization memebers
-    pthread_mutex_destroy(&t_context->c_section);
-    pthread_cond_destroy(&t_context->w_event);
-    pthread_cond_destroy(&t_context->r_event);
-    
-    //delete the thread context memory
-    free(t_context);
-    (*thread_id) = NULL;
-    return THREAD_SUCCESS;
+    pthread_join(t, NULL);
 }
 
 SYNC_OBJ get_synchronized_object()
 {
 
-    THREAD_MUTEX * imutex = (THREAD_MUTEX *)malloc(sizeof(THREAD_MUTEX));
+    THREAD_MUTEX * imutex = (THREAD_MUTEX *)calloc(1, sizeof(THREAD_MUTEX));
     if (0 == imutex)
     {
         return 0; //failure case
@@ -300,6 +128,14 @@ SYNC_OBJ get_synchronized_object()
 
     //intialize the mutex
     int result = pthread_mutex_init(&imutex->lmutex, NULL);
+    if (result == 0)
+    {
+        result = pthread_mutex_init(&imutex->park_lock, NULL);
+        if (result)
+        {
+            pthread_mutex_destroy(&imutex->lmutex);
+        }
+    }
     if (result)
     {
         if (imutex)
@@ -319,6 +155,7 @@ THREAD_RESULT release_synchornized_object(SYNC_OBJ * sobj)
 
     //delete the mutex
     pthread_mutex_destroy(&imutex->lmutex);
+    pthread_mutex_destroy(&imutex->park_lock);
 
     //free the memory
     free(imutex);
@@ -341,245 +178,223 @@ int threadsafe_decrement(SYNC_OBJ sobj, volatile int * pcnt)
     return temp;
 }
 
-#else
-typedef struct _THREAD_CTX
-{
-    //synchronization members
-    HANDLE t_handle; //worker thread handle
-    HANDLE w_event; //worker thread waiting event handle
-    HANDLE r_event; //signalling thread read event handle
-    CRITICAL_SECTION c_section; //critical section for fast synchronization
-    
-    //member field to run  a task
-    THREAD_ENTRY task;
-    void * t_arg;
-    THREAD_STATUS t_status;
-    THREAD_RESULT task_result;
-    int thread_id;
-
-}THREAD_CTX;
-
-typedef struct _THREAD_MUTEX
-{
-#if WINDOWS_MUTEX_SYNC
-    HANDLE lmutex;
-#else
-    CRITICAL_SECTION c_section; //critical section for fast synchronization
-#endif
-
-}THREAD_MUTEX;
-
-unsigned int __stdcall xeve_run_worker_thread(void * arg)
+//read one integer from a sysfs file, -1 on failure
+static int ts_read_sysfs_int(const char * path)
 {
-    /********************* main routine for thread pool worker thread *************************
-    ********************** worker thread can remain in suspended or running state *************
-    ********************* control the synchronization with help of thread context members *****/
-    
-    //member Initialization section
-    THREAD_CTX * t_context = (THREAD_CTX *)arg;
-    if (!t_context)
-    {
-        return 0; //error handling, more like a fail safe mechanism
-    }
+    FILE * fp = fopen(path, "r");
+    int    val = -1;
 
-    while (1)
+    if (fp)
     {
-        //worker thread loop
-        //remains suspended/sleep waiting for an event
-        WaitForSingleObject(t_context->w_event, INFINITE);
-
-        //worker thread has received the event to wake up and perform operation
-        EnterCriticalSection(&t_context->c_section);
-        if (t_context->t_status == THREAD_TERMINATED)
+        if (fscanf(fp, "%d", &val) != 1)
         {
-            //received signal to terminate
-            t_context->task_result = THREAD_SUCCESS;
-            LeaveCriticalSection(&t_context->c_section);
-            break;
+            val = -1;
         }
-        LeaveCriticalSection(&t_context->c_section);
-
-        //worker thread state is running with entry function and arg set
-        t_context->task(t_context->t_arg);
-
-        //change the state to suspended/waiting
-        EnterCriticalSection(&t_context->c_section);
-        t_context->t_status = THREAD_SUSPENDED;
-        t_context->task_result = THREAD_SUCCESS;
-        LeaveCriticalSection(&t_context->c_section);
-
-        //send an event to thread, waiting for it to finish it's task
-        SetEvent(t_context->r_event);
+        fclose(fp);
     }
-
-    return 0;
+    return val;
 }
 
-POOL_THREAD  xeve_create_worker_thread(THREAD_CONTROLLER * tc, int thread_id)
+//number of cpus granted by the cpu bandwidth limit of the cgroup, 0 if unlimited
+static int ts_cgroup_cpu_limit()
 {
-    if (!tc)
-    {
-        return NULL; //error management 
-    }
+    FILE    * fp;
+    char      quota_str[32];
+    long long quota = -1;
+    long long period = 0;
 
-    THREAD_CTX * thread_context = NULL;
-    thread_context = (THREAD_CTX *)malloc(sizeof(THREAD_CTX));
-
-    if (!thread_context)
+    fp = fopen("/sys/fs/cgroup/cpu.max", "r");
+    if (fp)
     {
-        return NULL; //error management, bad alloc
+        //cgroup v2: "<quota> <period>" or "max <period>"
+        if (fscanf(fp, "%31s %lld", quota_str, &period) == 2 && quota_str[0] != 'm')
+        {
+            quota = atoll(quota_str);
+        }
+        fclose(fp);
     }
-
-    //create waiting event
-    //create waiting event as automatic reset, only one thread can come out of waiting state
-    //done intentionally ... signally happens from different thread and only worker thread should be able to respond
-    thread_context->w_event = CreateEvent(NULL, FALSE, FALSE, NULL);
-    if (!thread_context->w_event)
+    else
     {
-        goto TERROR; //error handling, can't create event handler
+        //cgroup v1, the quota is -1 when unlimited
+        quota = ts_read_sysfs_int("/sys/fs/cgroup/cpu/cpu.cfs_quota_us");
+        period = ts_read_sysfs_int("/sys/fs/cgroup/cpu/cpu.cfs_period_us");
     }
-
-    thread_context->r_event = CreateEvent(NULL, TRUE, TRUE, NULL); //read event is enabled by default
-    if (!thread_context->r_event)
+    if (quota <= 0 || period <= 0)
     {
-        goto TERROR;
+        return 0;
     }
+    return (int)((quota + period - 1) / period);
+}
 
-    InitializeCriticalSection(&(thread_context->c_section)); //This section for fast data retrieval
-    
-    //intialize the state variables for the thread context object
-    thread_context->task = NULL;
-    thread_context->t_arg = NULL;
-    thread_context->t_status = THREAD_SUSPENDED;
-    thread_context->task_result = THREAD_INVALID_STATE;
-    thread_context->thread_id = thread_id;
+int get_cpu_core_count()
+{
+    long   logical = sysconf(_SC_NPROCESSORS_ONLN);
+    int  * core_key;
+    int    cores = 0;
+    int    first, last, cpu, pkg, core, limit, i;
+    char   path[128];
+    FILE * fp;
+#if defined(__linux__)
+    cpu_set_t mask;
+    int    use_mask = (sched_getaffinity(0, sizeof(mask), &mask) == 0);
 
-    thread_context->t_handle = (HANDLE)_beginthreadex(NULL, 0, xeve_run_worker_thread, (void *)thread_context,0, NULL); //create a thread store the handle and pass the handle to context
-    if (!thread_context->t_handle)
+    if (use_mask && CPU_COUNT(&mask) < logical)
     {
-        goto TERROR;
+        logical = CPU_COUNT(&mask);
     }
+#endif
 
-    //Everything created and intialized properly
-    //return the created thread_context;
-    return (POOL_THREAD)thread_context;
-
-TERROR:    
-    if (thread_context->w_event)
+    if (logical < 1)
     {
-        CloseHandle(thread_context->w_event);
+        return 1;
     }
-    if (thread_context->r_event)
+
+    //count the distinct (package, core) pairs of the online cpus this process
+    //may run on, so hardware threads sharing a core are counted once and the
+    //cores may differ in their number of hardware threads
+    fp = fopen("/sys/devices/system/cpu/online", "r");
+    core_key = (int *)malloc(sizeof(int) * 2 * logical);
+    if (fp && core_key)
     {
-        CloseHandle(thread_context->r_event);
+        while (fscanf(fp, "%d", &first) == 1)
+        {
+            last = first;
+            if (fscanf(fp, "-%d", &last) != 1)
+            {
+                last = first;
+            }
+            for (cpu = first; cpu <= last && cores < logical; cpu++)
+            {
+#if defined(__linux__)
+                if (use_mask && (cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, &mask)))
+                {
+                    continue;
+                }
+#endif
+                sprintf(path, "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+                pkg = ts_read_sysfs_int(path);
+                sprintf(path, "/sys/devices/system/cpu/cpu%d/topology/core_id", cpu);
+                core = ts_read_sysfs_int(path);
+                if (core < 0)
+                {
+                    //without a core id, the hardware threads of a core are
+                    //the cpus sharing its level 1 cache
+                    sprintf(path, "/sys/devices/system/cpu/cpu%d/cache/index0/level", cpu);
+                    if (ts_read_sysfs_int(path) == 1)
+                    {
+                        sprintf(path, "/sys/devices/system/cpu/cpu%d/cache/index0/shared_cpu_list", cpu);
+                        core = ts_read_sysfs_int(path);
+                    }
+                }
+                if (core < 0)
+                {
+                    cores = 0; //no topology information
+                    last = -1;
+                    break;
+                }
+                for (i = 0; i < cores; i++)
+                {
+                    if (core_key[2 * i] == pkg && core_key[2 * i + 1] == core)
+                    {
+                        break;
+                    }
+                }
+                if (i == cores)
+                {
+                    core_key[2 * cores] = pkg;
+                    core_key[2 * cores + 1] = core;
+                    cores++;
+                }
+            }
+            if (last < 0 || fgetc(fp) != ',')
+            {
+                break;
+            }
+        }
     }
-    DeleteCriticalSection(&thread_context->c_section);
-    if (thread_context)
+    if (fp)
     {
-        free(thread_context);
+        fclose(fp);
     }
+    free(core_key);
 
-    return NULL; //error handling, can't create a worker thread with proper initialization
-}
-
-THREAD_RESULT xeve_assign_task_thread(POOL_THREAD thread_id, THREAD_ENTRY entry, void * arg)
-{
-    //assign the task function and argument
-    //worker thread may be in running state or suspended state
-    //if worker thread is in suspended state, it can be waiting for first run or it has finished one task and is waiting again
-    //if worker thread is in running state, it will come to waiting state
-    //in any case, waiting on read event will always work
-
-    THREAD_CTX * t_context = (THREAD_CTX*)(thread_id);
-    if (!t_context)
+    if (cores <= 0)
     {
-        return THREAD_INVALID_ARG;
+        cores = (int)logical;
     }
-
-    WaitForSingleObject(t_context->r_event, INFINITE);
-
-    //worker thread is in waiting state
-    EnterCriticalSection(&t_context->c_section);
-    t_context->t_status = THREAD_RUNNING;
-    t_context->task = entry;
-    t_context->t_arg = arg;
-    //signal the worker thread to wake up and run the task
-    ResetEvent(t_context->r_event);
-    SetEvent(t_context->w_event);
-    LeaveCriticalSection(&t_context->c_section);
-
-    return THREAD_SUCCESS;
-}
-
-THREAD_RESULT  xeve_retrieve_thread_result(POOL_THREAD thread_id, int * res)
-{
-    //whatever task has been assigned to worker thread
-    //wait for it to finish get the result
-    THREAD_CTX * t_context = (THREAD_CTX*)(thread_id);
-    if (!t_context)
+    //a cpu quota smaller than the cores caps the threads which can run at once
+    limit = ts_cgroup_cpu_limit();
+    if (limit > 0 && limit < cores)
     {
-        return THREAD_INVALID_ARG;
+        cores = limit;
     }
-
-    THREAD_RESULT  result = THREAD_SUCCESS;
-
-    WaitForSingleObject(t_context->r_event, INFINITE);
-
-    //worker thread has finished it's job and now it is in waiting state
-    EnterCriticalSection(&t_context->c_section);
-    result = t_context->task_result;
-    LeaveCriticalSection(&t_context->c_section);
-    
-    *res = result;
-    return result;
+    return cores;
 }
 
-THREAD_RESULT xeve_terminate_worker_thread(POOL_THREAD * thread_id)
-{
-    //handler to close the thread
-    //close the thread handle
-    //release all the resource
-    // delete the thread context object
-
-
-    //the thread may be running or it is in suspended state
-    //if it is in suspended state, read event will be active
-    //if it is in running state, read event will be active after sometime
+#else
 
-    THREAD_CTX * t_context = (THREAD_CTX*)(*thread_id);
-    if (!t_context)
-    {
-        return THREAD_INVALID_ARG;
-    }
+#define THREAD_LOCAL __declspec(thread)
 
-    WaitForSingleObject(t_context->r_event, INFINITE);
+typedef HANDLE             TS_THREAD;
+typedef CRITICAL_SECTION   TS_MUTEX;
+typedef CONDITION_VARIABLE TS_COND;
 
-    //worker thread is in waiting state
-    EnterCriticalSection(&t_context->c_section);
-    t_context->t_status = THREAD_TERMINATED;
-    LeaveCriticalSection(&t_context->c_section);
+typedef struct _THREAD_MUTEX
+{
+#if WINDOWS_MUTEX_SYNC
+    HANDLE lmutex;
+#else
+    CRITICAL_SECTION c_section; //critical section for fast synchronization
+#endif
+    //threads parked on the sync flags guarded by this object
+    CRITICAL_SECTION park_lock;
+    SYNC_WAITER    * parked_list;
+    volatile int     parked;
 
-    //signal the worker thread to wake up and run the task
-    SetEvent(t_context->w_event);
+}THREAD_MUTEX;
 
-    //wait for worker thread to finish it's routine
-    WaitForSingleObject(t_context->t_handle, INFINITE);
-    CloseHandle(t_context->t_handle); //freed all the resources for the thread
+static void ts_mutex_init(TS_MUTEX * m)    { InitializeCriticalSection(m); }
+static void ts_mutex_destroy(TS_MUTEX * m) { DeleteCriticalSection(m); }
+static void ts_mutex_lock(TS_MUTEX * m)    { EnterCriticalSection(m); }
+static void ts_mutex_unlock(TS_MUTEX * m)  { LeaveCriticalSection(m); }
+static void ts_cond_init(TS_COND * c)      { InitializeConditionVariable(c); }
+static void ts_cond_destroy(TS_COND * c)   { (void)c; }
+static void ts_cond_wait(TS_COND * c, TS_MUTEX * m) { SleepConditionVariableCS(c, m, INFINITE); }
+static void ts_cond_broadcast(TS_COND * c) { WakeAllConditionVariable(c); }
+
+//volatile accesses have acquire/release semantics with MSVC
+#define ts_load_acquire(p)     (*(p))
+#define ts_load_seq(p)         InterlockedCompareExchange((volatile LONG *)(p), 0, 0)
+#define ts_store_seq(p, v)     InterlockedExchange((volatile LONG *)(p), (v))
+#define ts_atomic_add(p, v)    InterlockedExchangeAdd((volatile LONG *)(p), (v))
+#define ts_fetch_add(p, v)     InterlockedExchangeAdd((volatile LONG *)(p), (v))
+
+//monotonic time in microseconds
+static long long ts_time_us()
+{
+    LARGE_INTEGER cnt, freq;
+    QueryPerformanceCounter(&cnt);
+    QueryPerformanceFrequency(&freq);
+    return (long long)(cnt.QuadPart / freq.QuadPart) * 1000000 + (long long)(cnt.QuadPart % freq.QuadPart) * 1000000 / freq.QuadPart;
+}
 
-    CloseHandle(t_context->w_event);
-    CloseHandle(t_context->r_event);
-    DeleteCriticalSection(&t_context->c_section);
+static unsigned int __stdcall ts_worker_entry(void * arg);
 
-    //delete the thread context memory
-    free(t_context);
-    (*thread_id) = NULL;
+static int ts_thread_create(TS_THREAD * t, void * arg)
+{
+    *t = (HANDLE)_beginthreadex(NULL, 0, ts_worker_entry, arg, 0, NULL);
+    return *t != 0;
+}
 
-    return THREAD_SUCCESS;
+static void ts_thread_join(TS_THREAD t)
+{
+    WaitForSingleObject(t, INFINITE);
+    CloseHandle(t);
 }
 
 SYNC_OBJ get_synchronized_object()
 {
-    THREAD_MUTEX * imutex = (THREAD_MUTEX *)malloc(sizeof(THREAD_MUTEX));
+    THREAD_MUTEX * imutex = (THREAD_MUTEX *)calloc(1, sizeof(THREAD_MUTEX));
     if (0 == imutex)
     {
         return 0; //failure case
@@ -600,6 +415,7 @@ SYNC_OBJ get_synchronized_object()
     //initialize the critical section
     InitializeCriticalSection(&(imutex->c_section));
 #endif
+    InitializeCriticalSection(&imutex->park_lock);
     return imutex;
 }
 
@@ -613,6 +429,7 @@ THREAD_RESULT release_synchornized_object(SYNC_OBJ *  sobj)
     //delete critical section
     DeleteCriticalSection(&imutex->c_section);
 #endif
+    DeleteCriticalSection(&imutex->park_lock);
 
     //free the memory
     free(imutex);
@@ -655,51 +472,495 @@ int threadsafe_decrement(SYNC_OBJ sobj, volatile int * pcnt)
 #endif
     return temp;
 }
+
+int get_cpu_core_count()
+{
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION * info;
+    DWORD size = 0;
+    DWORD i;
+    int   cores = 0;
+    SYSTEM_INFO sys_info;
+
+    GetSystemInfo(&sys_info);
+
+    //count processor cores rather than hardware threads sharing a core
+    GetLogicalProcessorInformation(NULL, &size);
+    info = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION *)malloc(size);
+    if (info != NULL && GetLogicalProcessorInformation(info, &size))
+    {
+        for (i = 0; i < size / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION); i++)
+        {
+            if (info[i].Relationship == RelationProcessorCore)
+            {
+                cores++;
+            }
+        }
+    }
+    free(info);
+
+    if (cores < 1)
+    {
+        cores = (int)sys_info.dwNumberOfProcessors;
+    }
+    return cores < 1 ? 1 : cores;
+}
 #endif
 
-THREAD_RESULT init_thread_controller(THREAD_CONTROLLER * tc, int maxtask)
+
+/****************************************************************************
+ * task scheduler
+ *
+ * every executor (the threads created by the scheduler and the threads
+ * calling task_group_wait) owns a task queue. A task submitted by a worker
+ * goes to its own queue, a task submitted by any other thread goes to the
+ * shared queue 0. An executor takes tasks from its own queue first and
+ * steals from the other queues when it runs dry. Tasks are always taken
+ * from the front of a queue because encoder tasks are submitted in
+ * dependency order (e.g. CTU rows from top to bottom). A thread waiting for
+ * a group only takes the tasks of that group.
+ ****************************************************************************/
+typedef struct _TASK
 {
-    //assign handles to threadcontroller object
-    //handles for create, run, join and terminate will be given to controller  object
+    THREAD_ENTRY   entry;
+    void         * arg;
+    TASK_GROUP   * grp;
+} TASK;
 
-    tc->create = xeve_create_worker_thread;
-    tc->run = xeve_assign_task_thread;
-    tc->join = xeve_retrieve_thread_result;
-    tc->release = xeve_terminate_worker_thread;
-    tc->max_task_cnt = maxtask;
+typedef struct _TASK_QUEUE
+{
+    TS_MUTEX       lock;
+    TASK         * buf;
+    int            size;
+    int            head;
+    volatile int   cnt;
+} TASK_QUEUE;
+
+typedef struct _TASK_WORKER
+{
+    TASK_SCHEDULER * ts;
+    TS_THREAD        handle;
+    int              idx;
+} TASK_WORKER;
 
-    return THREAD_SUCCESS;
+struct _TASK_SCHEDULER
+{
+    /* number of worker threads */
+    int              workers;
+    /* queue 0 is shared by external threads, queue i belongs to worker i */
+    TASK_QUEUE     * queue;
+    TASK_WORKER    * worker;
+    /* guards sleeping executors, the queued task count and group completion */
+    TS_MUTEX         lock;
+    TS_COND          wake;
+    int              queued;
+    int              stop;
+};
+
+/* worker of the scheduler the current thread belongs to, if any */
+static THREAD_LOCAL TASK_WORKER * ts_self = NULL;
+
+static int ts_queue_push(TASK_QUEUE * q, TASK * task)
+{
+    ts_mutex_lock(&q->lock);
+    if (q->cnt == q->size)
+    {
+        int    size = q->size * 2;
+        TASK * buf = (TASK *)malloc(sizeof(TASK) * size);
+        int    i;
+
+        if (buf == NULL)
+        {
+            ts_mutex_unlock(&q->lock);
+            return 0;
+        }
+        for (i = 0; i < q->cnt; i++)
+        {
+            buf[i] = q->buf[(q->head + i) % q->size];
+        }
+        free(q->buf);
+        q->buf = buf;
+        q->size = size;
+        q->head = 0;
+    }
+    q->buf[(q->head + q->cnt) % q->size] = *task;
+    q->cnt++;
+    ts_mutex_unlock(&q->lock);
+    return 1;
+}
+
+/* take the first task of the queue, or the first task of the group grp when
+   grp is not NULL. the tasks in front of it are moved one slot back so the
+   queue keeps its order */
+static int ts_queue_pop(TASK_QUEUE * q, TASK_GROUP * grp, TASK * task)
+{
+    int found = 0;
+    int i;
+
+    if (q->cnt == 0) //unlocked peek, rechecked below
+    {
+        return 0;
+    }
+    ts_mutex_lock(&q->lock);
+    for (i = 0; i < q->cnt; i++)
+    {
+        if (grp == NULL || q->buf[(q->head + i) % q->size].grp == grp)
+        {
+            *task = q->buf[(q->head + i) % q->size];
+            for (; i > 0; i--)
+            {
+                q->buf[(q->head + i) % q->size] = q->buf[(q->head + i - 1) % q->size];
+            }
+            q->head = (q->head + 1) % q->size;
+            q->cnt--;
+            found = 1;
+            break;
+        }
+    }
+    ts_mutex_unlock(&q->lock);
+    return found;
+}
+
+static int ts_get_task(TASK_SCHEDULER * ts, int own, TASK_GROUP * grp, TASK * task)
+{
+    int i, q;
+
+    for (i = 0; i <= ts->workers; i++)
+    {
+        q = (own + i) % (ts->workers + 1);
+        if (ts_queue_pop(&ts->queue[q], grp, task))
+        {
+            ts_mutex_lock(&ts->lock);
+            ts->queued--;
+            task->grp->queued--;
+            ts_mutex_unlock(&ts->lock);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void ts_run_task(TASK_SCHEDULER * ts, TASK * task)
+{
+    int res = task->entry(task->arg);
+
+    ts_mutex_lock(&ts->lock);
+    if (res != 0 && task->grp->result == 0)
+    {
+        task->grp->result = res;
+    }
+    task->grp->pending--;
+    if (task->grp->pending == 0)
+    {
+        ts_cond_broadcast(&ts->wake);
+    }
+    ts_mutex_unlock(&ts->lock);
+}
+
+static int ts_own_queue(TASK_SCHEDULER * ts)
+{
+    return (ts_self != NULL && ts_self->ts == ts) ? ts_self->idx : 0;
+}
+
+#if !defined(WIN32) && !defined(WIN64)
+static void * ts_worker_entry(void * arg)
+#else
+static unsigned int __stdcall ts_worker_entry(void * arg)
+#endif
+{
+    TASK_WORKER    * w = (TASK_WORKER *)arg;
+    TASK_SCHEDULER * ts = w->ts;
+    TASK             task;
+
+    ts_self = w;
+    while (1)
+    {
+        if (ts_get_task(ts, w->idx, NULL, &task))
+        {
+            ts_run_task(ts, &task);
+            continue;
+        }
+
+        ts_mutex_lock(&ts->lock);
+        while (ts->queued <= 0 && !ts->stop)
+        {
+            ts_cond_wait(&ts->wake, &ts->lock);
+        }
+        if (ts->stop && ts->queued <= 0)
+        {
+            ts_mutex_unlock(&ts->lock);
+            break;
+        }
+        ts_mutex_unlock(&ts->lock);
+    }
+    return 0;
+}
+
+TASK_SCHEDULER * task_scheduler_create(int workers)
+{
+    TASK_SCHEDULER * ts;
+    int              i;
+
+    ts = (TASK_SCHEDULER *)calloc(1, sizeof(TASK_SCHEDULER));
+    if (ts == NULL)
+    {
+        return NULL;
+    }
+    ts->workers = workers < 0 ? 0 : workers;
+    ts_mutex_init(&ts->lock);
+    ts_cond_init(&ts->wake);
+
+    ts->queue = (TASK_QUEUE *)calloc(ts->workers + 1, sizeof(TASK_QUEUE));
+    ts->worker = (TASK_WORKER *)calloc(ts->workers + 1, sizeof(TASK_WORKER));
+    if (ts->queue == NULL || ts->worker == NULL)
+    {
+        free(ts->queue);
+        free(ts->worker);
+        ts_cond_destroy(&ts->wake);
+        ts_mutex_destroy(&ts->lock);
+        free(ts);
+        return NULL;
+    }
+
+    for (i = 0; i <= ts->workers; i++)
+    {
+        ts_mutex_init(&ts->queue[i].lock);
+        ts->queue[i].buf = (TASK *)malloc(sizeof(TASK) * TASK_QUEUE_INIT_SIZE);
+        ts->queue[i].size = TASK_QUEUE_INIT_SIZE;
+    }
+
+    for (i = 1; i <= ts->workers; i++)
+    {
+        ts->worker[i].ts = ts;
+        ts->worker[i].idx = i;
+        if (ts->queue[i].buf == NULL || !ts_thread_create(&ts->worker[i].handle, &ts->worker[i]))
+        {
+            ts->workers = i - 1;
+            task_scheduler_release(&ts);
+            return NULL;
+        }
+    }
+    if (ts->queue[0].buf == NULL)
+    {
+        task_scheduler_release(&ts);
+        return NULL;
+    }
+    return ts;
+}
+
+void task_scheduler_release(TASK_SCHEDULER ** pts)
+{
+    TASK_SCHEDULER * ts = *pts;
+    int              i;
+
+    if (ts == NULL)
+    {
+        return;
+    }
+
+    ts_mutex_lock(&ts->lock);
+    ts->stop = 1;
+    ts_cond_broadcast(&ts->wake);
+    ts_mutex_unlock(&ts->lock);
+
+    for (i = 1; i <= ts->workers; i++)
+    {
+        ts_thread_join(ts->worker[i].handle);
+    }
+    for (i = 0; i <= ts->workers; i++)
+    {
+        free(ts->queue[i].buf);
+        ts_mutex_destroy(&ts->queue[i].lock);
+    }
+    free(ts->queue);
+    free(ts->worker);
+    ts_cond_destroy(&ts->wake);
+    ts_mutex_destroy(&ts->lock);
+    free(ts);
+    *pts = NULL;
 }
 
-THREAD_RESULT dinit_thread_controller(THREAD_CONTROLLER * tc)
+void task_group_init(TASK_GROUP * grp)
 {
-    //reset all the handler to NULL
-    tc->create = NULL;
-    tc->run = NULL;
-    tc->join = NULL;
-    tc->release = NULL;
-    tc->max_task_cnt = 0;
+    grp->pending = 0;
+    grp->queued = 0;
+    grp->result = 0;
+}
+
+THREAD_RESULT task_submit(TASK_SCHEDULER * ts, TASK_GROUP * grp, THREAD_ENTRY entry, void * arg)
+{
+    TASK task;
+
+    task.entry = entry;
+    task.arg = arg;
+    task.grp = grp;
+
+    ts_mutex_lock(&ts->lock);
+    grp->pending++;
+    ts_mutex_unlock(&ts->lock);
+
+    if (!ts_queue_push(&ts->queue[ts_own_queue(ts)], &task))
+    {
+        ts_mutex_lock(&ts->lock);
+        grp->pending--;
+        ts_mutex_unlock(&ts->lock);
+        return THREAD_OUT_OF_MEMORY;
+    }
+
+    ts_mutex_lock(&ts->lock);
+    ts->queued++;
+    grp->queued++;
+    ts_cond_broadcast(&ts->wake);
+    ts_mutex_unlock(&ts->lock);
 
     return THREAD_SUCCESS;
 }
 
-int spinlock_wait(volatile int * addr, int val)
+int task_group_wait(TASK_SCHEDULER * ts, TASK_GROUP * grp)
 {
-    int temp;
+    TASK task;
+    int  own = ts_own_queue(ts);
 
     while (1)
     {
-        temp = *addr; //thread safe volatile read
-        if (temp == val || temp == -1)
+        //execute queued tasks of the group instead of blocking while the group
+        //is running, a task of another group may run much longer (e.g. the
+        //forecast) and would hold up the tasks waiting for this group
+        if (grp->queued > 0 && ts_get_task(ts, own, grp, &task))
+        {
+            ts_run_task(ts, &task);
+            continue;
+        }
+
+        ts_mutex_lock(&ts->lock);
+        if (grp->pending == 0)
+        {
+            ts_mutex_unlock(&ts->lock);
+            break;
+        }
+        if (grp->queued <= 0)
+        {
+            ts_cond_wait(&ts->wake, &ts->lock);
+        }
+        ts_mutex_unlock(&ts->lock);
+    }
+    return grp->result;
+}
+
+/****************************************************************************
+ * sync flags
+ *
+ * a waiting thread polls the flag for SYNC_SPIN_COUNT iterations and is then
+ * parked on its own condition, linked into the list of the sync object of
+ * the encoder. the parked count is raised before the flag is re-read under
+ * the park lock, and an assigning thread reads the parked count after its
+ * store, so a wake-up cannot be missed. only the threads parked on the
+ * assigned flag are woken.
+ ****************************************************************************/
+struct _SYNC_WAITER
+{
+    volatile int * addr;
+    TS_COND        cond;
+    SYNC_WAITER  * next;
+};
+
+static int sync_flag_reached(int temp, int val, int progress)
+{
+    return temp == -1 || (progress ? temp >= val : temp == val);
+}
+
+static int sync_flag_wait(SYNC_OBJ sobj, volatile int * addr, int val, int progress, long long * wait_time)
+{
+    THREAD_MUTEX * imutex = (THREAD_MUTEX *)sobj;
+    SYNC_WAITER    waiter, ** link;
+    long long      start;
+    int            temp, spin;
+
+    temp = ts_load_acquire(addr);
+    if (sync_flag_reached(temp, val, progress))
+    {
+        return temp;
+    }
+
+    start = wait_time ? ts_time_us() : 0;
+    for (spin = 0; spin < SYNC_SPIN_COUNT; spin++)
+    {
+        ts_pause();
+        temp = ts_load_acquire(addr);
+        if (sync_flag_reached(temp, val, progress))
         {
             break;
         }
     }
+
+    if (spin == SYNC_SPIN_COUNT)
+    {
+        waiter.addr = addr;
+        ts_cond_init(&waiter.cond);
+
+        ts_mutex_lock(&imutex->park_lock);
+        waiter.next = imutex->parked_list;
+        imutex->parked_list = &waiter;
+        ts_atomic_add(&imutex->parked, 1);
+        while (1)
+        {
+            temp = ts_load_seq(addr);
+            if (sync_flag_reached(temp, val, progress))
+            {
+                break;
+            }
+            ts_cond_wait(&waiter.cond, &imutex->park_lock);
+        }
+        ts_atomic_add(&imutex->parked, -1);
+        for (link = &imutex->parked_list; *link != &waiter; link = &(*link)->next);
+        *link = waiter.next;
+        ts_mutex_unlock(&imutex->park_lock);
+
+        ts_cond_destroy(&waiter.cond);
+    }
+
+    if (wait_time)
+    {
+        *wait_time += ts_time_us() - start;
+    }
     return temp;
 }
 
-void threadsafe_assign(volatile int * addr, int val)
+int spinlock_wait(SYNC_OBJ sobj, volatile int * addr, int val, long long * wait_time)
+{
+    return sync_flag_wait(sobj, addr, val, 0, wait_time);
+}
+
+int spinlock_wait_progress(SYNC_OBJ sobj, volatile int * addr, int val, long long * wait_time)
 {
-    //thread safe volatile assign
-    *addr = val;
-}
\ No newline at end of file
+    return sync_flag_wait(sobj, addr, val, 1, wait_time);
+}
+
+void threadsafe_assign(SYNC_OBJ sobj, volatile int * addr, int val)
+{
+    THREAD_MUTEX * imutex = (THREAD_MUTEX *)sobj;
+    SYNC_WAITER  * waiter;
+
+    ts_store_seq(addr, val);
+    if (ts_load_seq(&imutex->parked) > 0)
+    {
+        ts_mutex_lock(&imutex->park_lock);
+        for (waiter = imutex->parked_list; waiter != NULL; waiter = waiter->next)
+        {
+            if (waiter->addr == addr)
+            {
+                ts_cond_broadcast(&waiter->cond);
+            }
+        }
+        ts_mutex_unlock(&imutex->park_lock);
+    }
+}
+
+int threadsafe_fetch_add(volatile int * addr, int val)
+{
+    return ts_fetch_add(addr, val);
+}
+
+long long get_time_us()
+{
+    return ts_time_us();
+}
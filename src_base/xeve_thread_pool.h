@@ -31,16 +31,16 @@
 #ifndef _XEVE_THREAD_POOL_
 #define _XEVE_THREAD_POOL_
 
-typedef void* POOL_THREAD;
 typedef int (*THREAD_ENTRY) (void * arg);
-typedef struct _THREAD_CONTROLLER THREAD_CONTROLLER;
+typedef struct _TASK_SCHEDULER TASK_SCHEDULER;
 typedef void* SYNC_OBJ;
 
 /*****************************  Salient points  ****************************************************
-******************************  Thread Controller object will create, run and destroy***************
-******************************  threads. Thread Controller has to be initialised *******************
-******************************  before invoking handler functions.  Thread controller***************
-******************************  should be de-initialized to release handler functions***************
+******************************  Task scheduler owns a set of worker threads, each with *************
+******************************  its own task queue. Tasks are submitted to a task group ************
+******************************  and idle workers steal tasks from the queues of others. ************
+******************************  A thread waiting for a task group executes queued tasks ************
+******************************  until all tasks of the group are completed. ************************
 ****************************************************************************************************/
 
 typedef enum _THREAD_RESULT
@@ -61,30 +61,47 @@ typedef enum _THREAD_STATUS
 
 }THREAD_STATUS;
 
-struct _THREAD_CONTROLLER
+typedef struct _TASK_GROUP
 {
-    //Handler function to create requested thread, thread created is in suspended state
-    POOL_THREAD (*create)(THREAD_CONTROLLER * tc, int thread_id);
-    //Handler function to wake up suspended thread and assign task to complete
-    THREAD_RESULT (*run) (POOL_THREAD thread_id, THREAD_ENTRY entry, void * arg);
-    //Handler function to get result from the task assigned to the thread in consideration
-    THREAD_RESULT (*join)(POOL_THREAD thread_id, int * res);
-    //Handler function to terminate a thread in consideration
-    THREAD_RESULT (*release)(POOL_THREAD *thread_id);
-    //handle for mask number of allowed thread
-    int max_task_cnt;
-};
+    //number of submitted tasks which are not completed yet
+    volatile int pending;
+    //number of submitted tasks which are not taken by an executor yet
+    volatile int queued;
+    //first non-zero value returned by a task of the group
+    volatile int result;
+}TASK_GROUP;
 
-THREAD_RESULT init_thread_controller(THREAD_CONTROLLER * tc, int maxtask);
-THREAD_RESULT dinit_thread_controller(THREAD_CONTROLLER * tc);
+//create a scheduler with the given number of worker threads (the waiting thread is an additional executor)
+TASK_SCHEDULER * task_scheduler_create(int workers);
+//complete the queued tasks and terminate the worker threads
+void task_scheduler_release(TASK_SCHEDULER ** ts);
+void task_group_init(TASK_GROUP * grp);
+//queue a task, tasks should be submitted in the order of their dependencies
+THREAD_RESULT task_submit(TASK_SCHEDULER * ts, TASK_GROUP * grp, THREAD_ENTRY entry, void * arg);
+//wait for all tasks of the group, the waiting thread only executes tasks of the group.
+//tasks should not wait for a group. returns the first failed task result or zero
+int task_group_wait(TASK_SCHEDULER * ts, TASK_GROUP * grp);
 
 /*** Create a synchronization object which can be used to control race conditions across threads, synchronization object will be on encoding context*****/
 
 SYNC_OBJ get_synchronized_object();
 THREAD_RESULT release_synchornized_object(SYNC_OBJ * sobj); //sync object will be deleted
-int spinlock_wait(volatile int * addr, int val);
-void threadsafe_assign(volatile int * addr, int val);
+/* wait until *addr is val (or at least val for the progress variant) or -1, the
+   thread spins for a while and then sleeps until the value is changed by
+   threadsafe_assign with the same sync object. the blocked time in
+   microseconds is added to *wait_time when wait_time is not NULL */
+int spinlock_wait(SYNC_OBJ sobj, volatile int * addr, int val, long long * wait_time);
+int spinlock_wait_progress(SYNC_OBJ sobj, volatile int * addr, int val, long long * wait_time);
+void threadsafe_assign(SYNC_OBJ sobj, volatile int * addr, int val);
 int threadsafe_decrement(SYNC_OBJ sobj, volatile int * pcnt);
+/* atomically add val to *addr and return the previous value */
+int threadsafe_fetch_add(volatile int * addr, int val);
+/* monotonic time in microseconds */
+long long get_time_us();
+/* number of online physical processor cores the process may run on (hardware
+   threads sharing a core are counted once), capped by the cgroup cpu quota on
+   linux. NUMA topology is not considered */
+int get_cpu_core_count();
 
 #endif
 
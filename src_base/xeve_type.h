@@ -36,6 +36,7 @@
 #include "xeve_sad.h"
 #include "xeve_sad_sse.h"
 #include "xeve_sad_avx.h"
+#include "xeve_sad_avx512.h"
 
 /* support RDOQ */
 #define SCALE_BITS               15    /* Inherited from TMuC, pressumably for fractional bit estimates in RDOQ */
@@ -172,6 +173,14 @@ typedef struct _XEVE_FCST
     int                   w_blk;
     int                   h_blk;
     int                   f_blk;
+    /* number of pictures submitted to and analyzed by the forecast task,
+       the pictures in between wait for the task in input order */
+    volatile int          sub_cnt;
+    volatile int          done_cnt;
+    /* number of submitted pictures not finished by the task, the task
+       runs while it is not zero */
+    volatile int          queued;
+    TASK_GROUP            grp;
 
 }XEVE_FCST;
 
@@ -214,6 +223,9 @@ typedef struct _XEVE_SPIC_INFO
        2 : blank scene (ex: blank screen or stopped screen) */
     s32                     scene_type;
 
+    /* intra picture inserted by scene-cut detection */
+    s32                     scene_cut;
+
     /*[0] sra [1]: P1 / [2]: P2 / [3]: PGA */
     s32                   uni_est_cost[4];
     s32                   bi_fcost;
@@ -255,17 +267,43 @@ typedef struct _XEVE_PICO
     XEVE_SPIC_INFO      sinfo;
     /* address of sub-picture org */
     XEVE_PIC          * spic;
+    /* downscaled luma of the original for the motion search pyramid */
+    pel               * buf_pyr[XEVE_ME_PYR_LEVEL];
+    pel               * pyr[XEVE_ME_PYR_LEVEL];
+    int                 s_pyr[XEVE_ME_PYR_LEVEL];
 
 } XEVE_PICO;
 
 /*****************************************************************************
  * intra prediction structure
  *****************************************************************************/
+#define XEVE_PINTRA_CACHE_LOG2      8
+#define XEVE_PINTRA_CACHE_NUM      (1 << XEVE_PINTRA_CACHE_LOG2)
+
+/* rough (SATD) cost of luma intra candidates of one block, reused when the
+   same block is visited again in the same CTU with identical neighbours */
+typedef struct _XEVE_PINTRA_CACHE
+{
+    /* CTU generation the entry belongs to */
+    u32                 gen;
+    u16                 x_scu;
+    u16                 y_scu;
+    u8                  log2_cuw;
+    u8                  log2_cuh;
+    u16                 avail_lr;
+    /* luma neighbour samples the candidates were predicted from */
+    pel                 nb[N_REF][MAX_CU_SIZE * 3];
+    u32                 satd[IPD_CNT];
+} XEVE_PINTRA_CACHE;
+
 typedef struct _XEVE_PINTRA
 {
     /* temporary prediction buffer */
     pel                 pred[N_C][MAX_CU_DIM];
     pel                 pred_cache[IPD_CNT][MAX_CU_DIM]; // only for luma
+    /* candidate cost cache, invalidated at every CTU */
+    XEVE_PINTRA_CACHE   cache[XEVE_PINTRA_CACHE_NUM];
+    u32                 cache_gen;
 
     /* reconstruction buffer */
     pel                 rec[N_C][MAX_CU_DIM];
@@ -390,6 +428,14 @@ struct _XEVE_PINTER
     s16                 search_range_ipel[MV_D];
     /* search range for sub-pel */
     s16                 search_range_spel[MV_D];
+    /* integer-pel motion of the current CTU found by the pyramid search */
+    s16                 pyr_mv[REFP_NUM][XEVE_MAX_NUM_ACTIVE_REF_FRAME][XEVE_ME_PYR_W * XEVE_ME_PYR_W][MV_D];
+    /* integer-pel motion range around zero covered by the pyramid search */
+    int                 pyr_cover[REFP_NUM][XEVE_MAX_NUM_ACTIVE_REF_FRAME];
+    /* position of the CTU of the pyramid motion, 0 in pyr_on if not searched */
+    int                 pyr_x;
+    int                 pyr_y;
+    int                 pyr_on;
     s8              ( * search_pattern_hpel)[2];
     u8                  search_pattern_hpel_cnt;
     s8              ( * search_pattern_qpel)[2];
@@ -534,6 +580,14 @@ typedef struct _XEVE_SBAC
     u32                 bin_counter;
 } XEVE_SBAC;
 
+/* entropy coding state of a CTU row after its first two CTUs, the row below
+   starts from it when the CTU rows are shared by several threads */
+typedef struct _XEVE_ROW_STATE
+{
+    XEVE_SBAC_CTX       sbac_ctx;
+    u8                  qp_prev_eco;
+} XEVE_ROW_STATE;
+
 typedef struct _XEVE_DQP
 {
     s8                  prev_qp;
@@ -711,6 +765,8 @@ struct _XEVE_CORE
     int                tile_idx;
     XEVE_CTX         * ctx;
     int                thread_cnt;
+    /* accumulated time in microseconds spent waiting for CTU dependencies */
+    long long          sync_wait_time;
     TREE_CONS          tree_cons; //!< Tree status
     u8                 ctx_flags[NUM_CNID];
     int                split_mode_child[4];
@@ -883,22 +939,49 @@ struct _XEVE_CTX
     XEVE_RCORE         * rcore;
     /* rate control for sequence */
     XEVE_RC          * rc;
+    /* intra refresh: columns [refresh_x0, refresh_x1) of the current picture
+       are coded in intra, refresh_cnt pictures of the cycle refresh_id are coded */
+    int                refresh_x0;
+    int                refresh_x1;
+    int                refresh_cnt;
+    int                refresh_id;
+    /* NAL unit output called once a slice is written */
+    XEVE_NALU_OUT      nalu_out;
+    /* first byte of the bitstream buffer not yet given to nalu_out */
+    u8               * nalu_out_pos;
     /* temporary tile bitstream store buffer if needed */
     u8               * bs_tbuf[XEVE_MAX_NUM_TILES_ROW * XEVE_MAX_NUM_TILES_COL];
     /* bs_tbuf byte size for one tile */
     int                bs_tbuf_size;
-    THREAD_CONTROLLER * tc;
-    POOL_THREAD        thread_pool[XEVE_MAX_THREADS];
-    int                parallel_rows;
+    /* task scheduler with (param.threads - 1) worker threads */
+    TASK_SCHEDULER   * ts;
+    /* number of tiles of the current picture not yet taken by a tile task */
+    volatile s32       tile_left;
+    /* tiles of all slices of the current picture in slice order, the slices
+       go through mode decision together */
+    u8                 md_tile_order[XEVE_MAX_NUM_TILES_COL * XEVE_MAX_NUM_TILES_ROW];
+    int                md_tile_cnt;
+    /* deblocking of the current picture runs behind the CTU row wavefront */
+    int                dbk_pipe;
+    /* number of CTU rows of the current picture which are deblocked */
+    volatile s32       dbk_rows;
     volatile s32     * sync_flag;
     SYNC_OBJ           sync_block;
+    /* entropy coding state of each CTU row of each tile column of the current
+       picture */
+    XEVE_ROW_STATE   * row_state;
+    /* time (us) spent on each CTU of the current picture, without the waits */
+    s32              * map_ctu_time;
+    /* accumulated time (us) spent on each CTU row over the encoded pictures */
+    long long        * row_time;
+    /* per-thread data, allocated with param.threads entries */
     /* address of core structure */
-    XEVE_CORE        * core[XEVE_MAX_THREADS];
-    XEVE_BSW           bs[XEVE_MAX_THREADS];
-    XEVE_SBAC          sbac_enc[XEVE_MAX_THREADS];
-    XEVE_MODE          mode[XEVE_MAX_THREADS];
-    XEVE_PINTRA        pintra[XEVE_MAX_THREADS];
-    XEVE_PINTER        pinter[XEVE_MAX_THREADS];
+    XEVE_CORE       ** core;
+    XEVE_BSW         * bs;
+    XEVE_SBAC        * sbac_enc;
+    XEVE_MODE        * mode;
+    XEVE_PINTRA      * pintra;
+    XEVE_PINTER      * pinter;
 
 
     /* qp table */
@@ -1001,5 +1084,9 @@ typedef struct _ALF_SLICE_PARAM ALF_SLICE_PARAM;
 #include "xeve_itdq_sse.h"
 #include "xeve_itdq_avx.h"
 #include "xeve_tq_avx.h"
+#include "xeve_itdq_avx512.h"
+#include "xeve_tq_avx512.h"
+#include "xeve_df_sse.h"
+#include "xeve_df_avx.h"
 
 #endif /* _XEVE_TYPE_H_ */
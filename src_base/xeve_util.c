@@ -186,6 +186,10 @@ void xeve_picbuf_free(XEVE_PIC *pic)
         xeve_mfree(pic->map_unrefined_mv);
         xeve_mfree(pic->map_refi);
         xeve_mfree(pic->map_dqp_lah);
+        for(int i = 0; i < XEVE_ME_PYR_LEVEL; i++)
+        {
+            xeve_mfree(pic->buf_pyr[i]);
+        }
         xeve_mfree(pic);
     }
 }
@@ -247,6 +251,58 @@ static void picbuf_expand(pel *a, int s, int w, int h, int exp)
     }
 }
 
+int xeve_picbuf_alloc_pyr(pel *buf[XEVE_ME_PYR_LEVEL], pel *a[XEVE_ME_PYR_LEVEL], int s[XEVE_ME_PYR_LEVEL], int w, int h, int pad)
+{
+    int i, w_pyr, h_pyr, pad_pyr;
+
+    for(i = 0; i < XEVE_ME_PYR_LEVEL; i++)
+    {
+        w_pyr = (w + (2 << i) - 1) >> (i + 1);
+        h_pyr = (h + (2 << i) - 1) >> (i + 1);
+        pad_pyr = pad >> (i + 1);
+
+        s[i] = w_pyr + (pad_pyr << 1);
+        buf[i] = xeve_malloc(sizeof(pel) * s[i] * (h_pyr + (pad_pyr << 1)));
+        xeve_assert_rv(buf[i] != NULL, XEVE_ERR_OUT_OF_MEMORY);
+
+        a[i] = buf[i] + pad_pyr * s[i] + pad_pyr;
+    }
+    return XEVE_OK;
+}
+
+void xeve_picbuf_gen_pyr(pel *src, int s_src, pel *a[XEVE_ME_PYR_LEVEL], int s[XEVE_ME_PYR_LEVEL], int w, int h, int pad)
+{
+    int i, j, k, x0, x1, w_pyr, h_pyr;
+    pel *r0, *r1, *dst;
+
+    for(k = 0; k < XEVE_ME_PYR_LEVEL; k++)
+    {
+        w_pyr = (w + 1) >> 1;
+        h_pyr = (h + 1) >> 1;
+        dst = a[k];
+
+        for(i = 0; i < h_pyr; i++)
+        {
+            /* the last row and column are repeated for odd sizes */
+            r0 = src + (i << 1) * s_src;
+            r1 = src + XEVE_MIN((i << 1) + 1, h - 1) * s_src;
+
+            for(j = 0; j < w_pyr; j++)
+            {
+                x0 = j << 1;
+                x1 = XEVE_MIN(x0 + 1, w - 1);
+                dst[j] = (r0[x0] + r0[x1] + r1[x0] + r1[x1] + 2) >> 2;
+            }
+            dst += s[k];
+        }
+        picbuf_expand(a[k], s[k], w_pyr, h_pyr, pad >> (k + 1));
+
+        src = a[k];
+        s_src = s[k];
+        w = w_pyr;
+        h = h_pyr;
+    }
+}
 
 void xeve_picbuf_expand(XEVE_PIC *pic, int exp_l, int exp_c, int chroma_format_idc)
 {
@@ -1964,6 +2020,7 @@ int xeve_check_cpu_info()
     int support_sse  = 0;
     int support_avx  = 0;
     int support_avx2 = 0;
+    int support_avx512 = 0;
     int cpu_info[4]  = { 0 };
     __cpuid(cpu_info, 0);
     int id_cnt = cpu_info[0];
@@ -1983,11 +2040,15 @@ int xeve_check_cpu_info()
             {
                 __cpuid(cpu_info, 7);
                 support_avx2 = support_avx && GET_CPU_INFO(XEVE_CPU_INFO_AVX2, cpu_info);
+                /* the OS has to save the opmask and upper ZMM registers as well */
+                support_avx512 = support_avx2 && ((xcr_feature_mask & 0xE6) == 0xE6)
+                              && GET_CPU_INFO(XEVE_CPU_INFO_AVX512F, cpu_info)
+                              && GET_CPU_INFO(XEVE_CPU_INFO_AVX512BW, cpu_info);
             }
         }
     }
 
-    return (support_sse << 1) | support_avx | (support_avx2 << 2);
+    return (support_sse << 1) | support_avx | (support_avx2 << 2) | (support_avx512 << 3);
 }
 #endif
 
@@ -2221,10 +2282,24 @@ void xeve_set_chroma_qp_tbl_loc(XEVE_CTX* ctx)
     ctx->qp_chroma_dynamic[1] = &(ctx->qp_chroma_dynamic_ext[1][6 * (ctx->param.codec_bit_depth - 8)]);
 }
 
+/* read the space separated integers of a parameter string, return the count */
+static int parse_int_list(char * str, int * list, int max_cnt)
+{
+    char * val;
+    int    cnt = 0;
+
+    for (val = strtok(str, " \r"); val != NULL && cnt < max_cnt; val = strtok(NULL, " \r"))
+    {
+        list[cnt++] = atoi(val);
+    }
+    return cnt;
+}
+
 static int parse_tile_slice_param(XEVE_CTX* ctx)
 {
     XEVE_TS_INFO * ts_info = &ctx->ts_info;
     XEVE_PARAM   * param = &ctx->param;
+    int            cnt, i;
 
     ts_info->tile_uniform_spacing_flag = param->tile_uniform_spacing_flag;
     ts_info->tile_columns              = param->tile_columns;
@@ -2233,30 +2308,25 @@ static int parse_tile_slice_param(XEVE_CTX* ctx)
     ts_info->arbitrary_slice_flag      = param->arbitrary_slice_flag;
 
     int num_tiles = ts_info->tile_columns * ts_info->tile_rows;
-    if (num_tiles < ts_info->num_slice_in_pic) return XEVE_ERR;
+    if (num_tiles < ts_info->num_slice_in_pic) return XEVE_ERR_INVALID_ARGUMENT;
     if (num_tiles > 1)
     {
         if (!ts_info->tile_uniform_spacing_flag)
         {
-            ts_info->tile_column_width_array[0] = atoi(strtok(param->tile_column_width_array, " "));
-            int j = 1;
-            do
+            if (param->tile_column_width_array[0] == '\0' && param->tile_row_height_array[0] == '\0')
             {
-                char* val = strtok(NULL, " \r");
-                if (!val)
-                    break;
-                ts_info->tile_column_width_array[j++] = atoi(val);
-            } while (1);
-
-            ts_info->tile_row_height_array[0] = atoi(strtok(param->tile_row_height_array, " "));
-            j = 1;
-            do
+                /* no tile sizes are given, space the tiles uniformly */
+                param->tile_uniform_spacing_flag = 1;
+                ts_info->tile_uniform_spacing_flag = 1;
+            }
+            else
             {
-                char* val = strtok(NULL, " \r");
-                if (!val)
-                    break;
-                ts_info->tile_row_height_array[j++] = atoi(val);
-            } while (1);
+                /* the size of the last column and row is the remainder */
+                cnt = parse_int_list(param->tile_column_width_array, ts_info->tile_column_width_array, XEVE_MAX_NUM_TILE_WIDTH);
+                xeve_assert_rv(cnt >= ts_info->tile_columns - 1, XEVE_ERR_INVALID_ARGUMENT);
+                cnt = parse_int_list(param->tile_row_height_array, ts_info->tile_row_height_array, XEVE_MAX_NUM_TILE_HEIGHT);
+                xeve_assert_rv(cnt >= ts_info->tile_rows - 1, XEVE_ERR_INVALID_ARGUMENT);
+            }
         }
 
         if (ts_info->num_slice_in_pic == 1)
@@ -2267,27 +2337,24 @@ static int parse_tile_slice_param(XEVE_CTX* ctx)
         }
         else /* There are more than one slice in the picture */
         {
-            ts_info->tile_array_in_slice[0] = atoi(strtok(param->num_remaining_tiles_in_slice_minus1, " "));
-            int j = 1;
-            do
-            {
-                char* val = strtok(NULL, " \r");
-                if (!val)
-                    break;
-                ts_info->tile_array_in_slice[j++] = atoi(val);
-            } while (1);
+            cnt = parse_int_list(param->tile_array_in_slice, ts_info->tile_array_in_slice, XEVE_MAX_NUM_TILES);
 
             if (ts_info->arbitrary_slice_flag)
             {
-                ts_info->num_remaining_tiles_in_slice_minus1[0] = atoi(strtok(param->num_remaining_tiles_in_slice_minus1, " ")) - 1;
-                int j = 1;
-                do
+                int tiles = 0;
+                xeve_assert_rv(parse_int_list(param->num_remaining_tiles_in_slice_minus1, ts_info->num_remaining_tiles_in_slice_minus1,
+                                              XEVE_MAX_NUM_TILES >> 1) >= ts_info->num_slice_in_pic, XEVE_ERR_INVALID_ARGUMENT);
+                for (i = 0; i < ts_info->num_slice_in_pic; i++)
                 {
-                    char* val = strtok(NULL, " \r");
-                    if (!val)
-                        break;
-                    ts_info->num_remaining_tiles_in_slice_minus1[j++] = atoi(val) - 1;
-                } while (1);
+                    ts_info->num_remaining_tiles_in_slice_minus1[i] -= 1;
+                    tiles += ts_info->num_remaining_tiles_in_slice_minus1[i] + 2;
+                }
+                xeve_assert_rv(cnt >= tiles, XEVE_ERR_INVALID_ARGUMENT);
+            }
+            else
+            {
+                /* first and last tile of every slice */
+                xeve_assert_rv(cnt >= 2 * ts_info->num_slice_in_pic, XEVE_ERR_INVALID_ARGUMENT);
             }
         }
     }
@@ -2295,13 +2362,44 @@ static int parse_tile_slice_param(XEVE_CTX* ctx)
     return XEVE_OK;
 }
 
+int xeve_get_auto_threads(XEVE_PARAM * param)
+{
+    int threads = get_cpu_core_count();
+    /* CTU rows (of the smallest CTU size) or tiles processed in parallel,
+       the main profile also splits every tile into CTU rows */
+    int max_tasks = XEVE_MAX((param->h + 63) >> 6, param->tile_columns * param->tile_rows);
+
+    if (param->profile == XEVE_PROFILE_MAIN)
+    {
+        max_tasks = XEVE_MAX(max_tasks, ((param->h + 63) >> 6) * param->tile_columns);
+    }
+
+    threads = XEVE_MIN(threads, max_tasks);
+    return XEVE_CLIP3(1, XEVE_MAX_THREADS, threads);
+}
+
 int xeve_set_init_param(XEVE_CTX * ctx, XEVE_PARAM * param)
 {
+    int ret;
+
     /* check input parameters */
     xeve_assert_rv(param->w > 0 && param->h > 0, XEVE_ERR_INVALID_ARGUMENT);
     xeve_assert_rv(param->qp >= MIN_QUANT && param->qp <= MAX_QUANT, XEVE_ERR_INVALID_ARGUMENT);
     xeve_assert_rv(param->keyint >= 0 ,XEVE_ERR_INVALID_ARGUMENT);
-    xeve_assert_rv(param->threads <= XEVE_MAX_THREADS ,XEVE_ERR_INVALID_ARGUMENT);
+    xeve_assert_rv(param->scenecut >= 0 && param->scenecut <= 100, XEVE_ERR_INVALID_ARGUMENT);
+    xeve_assert_rv(param->rc_pass >= 0 && param->rc_pass <= 2, XEVE_ERR_INVALID_ARGUMENT);
+    xeve_assert_rv(param->intra_refresh >= 0, XEVE_ERR_INVALID_ARGUMENT);
+    xeve_assert_rv(param->intra_refresh == 0 || param->bframes == 0, XEVE_ERR_INVALID_ARGUMENT);
+    if (param->rc_pass != 0)
+    {
+        xeve_assert_rv(strlen(param->rc_stats) > 0, XEVE_ERR_INVALID_ARGUMENT);
+        xeve_assert_rv(param->rc_pass == 1 || param->rc_type == XEVE_RC_ABR, XEVE_ERR_INVALID_ARGUMENT);
+    }
+    if (param->threads == XEVE_THREADS_AUTO)
+    {
+        param->threads = xeve_get_auto_threads(param);
+    }
+    xeve_assert_rv(param->threads >= 1 && param->threads <= XEVE_MAX_THREADS ,XEVE_ERR_INVALID_ARGUMENT);
 
     if(param->disable_hgop == 0)
     {
@@ -2351,7 +2449,9 @@ int xeve_set_init_param(XEVE_CTX * ctx, XEVE_PARAM * param)
     param->qp_min            = MIN_QUANT;
     param->gop_size          = param->bframes +1;
     param->lookahead         = XEVE_MIN(XEVE_MAX((param->cutree)? param->gop_size : 0, param->lookahead), XEVE_MAX_INBUF_CNT>>1);
-    param->use_fcst          = ((param->use_fcst || param->lookahead) && (param->rc_type || param->aq_mode)) ? 1 : 0;
+    param->scenecut          = (param->closed_gop || param->keyint == 1) ? 0 : param->scenecut;
+    param->rc_pass_fast      = (param->rc_pass == 1) ? param->rc_pass_fast : 0;
+    param->use_fcst          = (((param->use_fcst || param->lookahead) && (param->rc_type || param->aq_mode)) || param->scenecut || param->rc_pass) ? 1 : 0;
     param->chroma_format_idc = XEVE_CFI_FROM_CF(XEVE_CS_GET_FORMAT(param->cs));
     param->cs_w_shift        = XEVE_GET_CHROMA_W_SHIFT(param->chroma_format_idc);
     param->cs_h_shift        = XEVE_GET_CHROMA_H_SHIFT(param->chroma_format_idc);
@@ -2378,7 +2478,8 @@ int xeve_set_init_param(XEVE_CTX * ctx, XEVE_PARAM * param)
     }
 #endif
 
-    parse_tile_slice_param(ctx);
+    ret = parse_tile_slice_param(ctx);
+    xeve_assert_rv(ret == XEVE_OK, ret);
 
     return XEVE_OK;
 }
@@ -2400,7 +2501,8 @@ static void decide_normal_gop(XEVE_CTX * ctx, u32 pic_imcnt)
         ctx->poc.prev_poc_val = ctx->poc.poc_val;
         ctx->slice_ref_flag = 1;
     }
-    else if ((i_period != 0) && pic_imcnt % i_period == 0)
+    else if (((i_period != 0) && pic_imcnt % i_period == 0) ||
+             (pic_imcnt % gop_size == 0 && ctx->param.scenecut && ctx->pico_buf[pic_imcnt % ctx->pico_max_cnt]->sinfo.scene_cut))
     {
         ctx->slice_type = SLICE_I;
         ctx->slice_depth = FRM_DEPTH_0;
@@ -2491,7 +2593,7 @@ static void decide_slice_type(XEVE_CTX * ctx)
         else /* IPPP... */
         {
             pic_imcnt = (i_period > 0) ? pic_icnt % i_period : pic_icnt;
-            if (pic_imcnt == 0)
+            if (pic_imcnt == 0 || (ctx->param.scenecut && ctx->pico->sinfo.scene_cut))
             {
                 ctx->slice_type = SLICE_I;
                 ctx->slice_depth = FRM_DEPTH_0;
@@ -2566,6 +2668,99 @@ static void decide_slice_type(XEVE_CTX * ctx)
 }
 
 
+/* move the intra refresh column to the next position of the cycle */
+static void set_intra_refresh(XEVE_CTX * ctx)
+{
+    XEVE_PIC * pic = PIC_CURR(ctx);
+    int        n = ctx->param.intra_refresh;
+
+    if(ctx->slice_type == SLICE_I)
+    {
+        /* an I picture is a clean reference for the following cycle */
+        ctx->refresh_id++;
+        ctx->refresh_cnt = 0;
+        ctx->refresh_x0 = ctx->refresh_x1 = 0;
+        pic->refresh_w = ctx->w;
+    }
+    else
+    {
+        if(ctx->refresh_cnt == n)
+        {
+            ctx->refresh_id++;
+            ctx->refresh_cnt = 0;
+        }
+        ctx->refresh_x0 = XEVE_MIN((int)ctx->w, ((ctx->refresh_cnt * (int)ctx->w_lcu) / n) << ctx->log2_max_cuwh);
+        ctx->refresh_x1 = XEVE_MIN((int)ctx->w, (((ctx->refresh_cnt + 1) * (int)ctx->w_lcu) / n) << ctx->log2_max_cuwh);
+        ctx->refresh_cnt++;
+
+        if(ctx->refresh_x1 < (int)ctx->w)
+        {
+            pic->refresh_w = XEVE_MAX(0, ctx->refresh_x1 - REFRESH_LF_MARGIN);
+        }
+        else
+        {
+            pic->refresh_w = ctx->w;
+        }
+    }
+    pic->refresh_id = ctx->refresh_id;
+}
+
+/* the CU is in the intra refresh column */
+int xeve_refresh_is_intra(XEVE_CTX * ctx, int x, int cuw)
+{
+    return ctx->param.intra_refresh && x < ctx->refresh_x1 && x + cuw > ctx->refresh_x0;
+}
+
+/* an inter CU left of the intra refresh column can be predicted only from
+   the area refreshed in the same cycle of the reference pictures */
+int xeve_refresh_check_mv(XEVE_CTX * ctx, XEVE_MODE * mi, int x, int cuw)
+{
+    XEVE_PIC * ref;
+    int        lidx, w;
+
+    if(!ctx->param.intra_refresh || x + cuw > ctx->refresh_x0)
+    {
+        return 1;
+    }
+    if(mi->affine_flag)
+    {
+        /* the sub-block motion is not bounded by the control points */
+        return 0;
+    }
+    for(lidx = 0; lidx < REFP_NUM; lidx++)
+    {
+        if(REFI_IS_VALID(mi->refi[lidx]))
+        {
+            ref = ctx->refp[mi->refi[lidx]][lidx].pic;
+            w = (ref->refresh_id == ctx->refresh_id) ? ref->refresh_w : 0;
+            if(x + cuw + ((mi->mv[lidx][MV_X] + 3) >> 2) + REFRESH_MC_MARGIN > w)
+            {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/* the above-right samples of a CU at the end of the intra refresh column
+   are not refreshed yet, so the intra modes using them are not allowed */
+int xeve_refresh_check_ipm(XEVE_CTX * ctx, int x, int cuw, int ipm, int is_chroma)
+{
+    if(!ctx->param.intra_refresh || ctx->refresh_x1 >= (int)ctx->w || x >= ctx->refresh_x1 || x + (cuw << 1) <= ctx->refresh_x1)
+    {
+        return 1;
+    }
+    if(is_chroma)
+    {
+        return ipm != IPD_BI_C;
+    }
+    if(ctx->sps.tool_eipd)
+    {
+        return ipm == IPD_DC || ipm >= IPD_VER;
+    }
+    return ipm != IPD_UR_B;
+}
+
 int xeve_pic_prepare(XEVE_CTX * ctx, XEVE_BITB * bitb, XEVE_STAT * stat)
 {
     int             ret;
@@ -2588,13 +2783,16 @@ int xeve_pic_prepare(XEVE_CTX * ctx, XEVE_BITB * bitb, XEVE_STAT * stat)
         ctx->pic_dbk = xeve_pic_alloc(&ctx->rpm.pa, &ret);
         xeve_assert_rv(ctx->pic_dbk != NULL, ret);
     }
+    /* set before the mode decision, its threads share the picture */
+    ctx->pic_dbk->pic_deblock_alpha_offset = ctx->param.deblock_alpha_offset;
+    ctx->pic_dbk->pic_deblock_beta_offset = ctx->param.deblock_beta_offset;
 
     decide_slice_type(ctx);
 
     ctx->lcu_cnt = ctx->f_lcu;
     ctx->slice_num = 0;
 
-    if (ctx->tile_cnt == 1 && ctx->param.threads > 1)
+    if (ctx->param.threads > 1)
     {
         for (u32 i = 0; i < ctx->f_lcu; i++)
         {
@@ -2603,6 +2801,7 @@ int xeve_pic_prepare(XEVE_CTX * ctx, XEVE_BITB * bitb, XEVE_STAT * stat)
     }
 
     if(ctx->slice_type == SLICE_I) ctx->last_intra_poc = ctx->poc.poc_val;
+    if(ctx->param.intra_refresh) set_intra_refresh(ctx);
 
     size = sizeof(s8) * ctx->f_scu * REFP_NUM;
     xeve_mset_x64a(ctx->map_refi, -1, size);
@@ -2618,6 +2817,7 @@ int xeve_pic_prepare(XEVE_CTX * ctx, XEVE_BITB * bitb, XEVE_STAT * stat)
     {
         xeve_bsw_init(&ctx->bs[i], ctx->bs[i].beg, bitb->bsize, NULL);
     }
+    ctx->nalu_out_pos = ctx->bs[0].beg;
 
     /* clear map */
     xeve_mset_x64a(ctx->map_scu, 0, sizeof(u32) * ctx->f_scu);
@@ -2662,6 +2862,7 @@ int xeve_pic_finish(XEVE_CTX *ctx, XEVE_BITB *bitb, XEVE_STAT *stat)
 
     /* expand current encoding picture, if needs */
     ctx->fn_picbuf_expand(ctx, PIC_CURR(ctx));
+    xeve_mt_row_time_update(ctx);
 
     /* picture buffer management */
     ret = xeve_picman_put_pic(&ctx->rpm, PIC_CURR(ctx), ctx->nalu.nal_unit_type_plus1 - 1 == XEVE_IDR_NUT,
@@ -2707,6 +2908,10 @@ int xeve_pic_finish(XEVE_CTX *ctx, XEVE_BITB *bitb, XEVE_STAT *stat)
     {
         ctx->rcore->real_bits = (stat->write - stat->sei_size) << 3;
     }
+    if (ctx->param.rc_pass == 1)
+    {
+        xeve_rc_write_stats(ctx, ctx->pico, ctx->slice_type, ctx->slice_depth, ctx->sh->qp, (s64)(stat->write - stat->sei_size) << 3);
+    }
 
     if (imgb_o)
     {
@@ -2899,6 +3104,25 @@ void xeve_set_sh(XEVE_CTX *ctx, XEVE_SH *sh)
     ctx->sh->slice_pic_parameter_set_id = 0;
 }
 
+int xeve_alloc_tile(XEVE_CTX * ctx, int f_tile)
+{
+    int size, i;
+    u8 * qp_prev_eco;
+
+    /* per-thread qp storage of all tiles follows the tile array */
+    size = (sizeof(XEVE_TILE) + sizeof(u8) * ctx->param.threads) * f_tile;
+    ctx->tile = xeve_malloc(size);
+    xeve_assert_rv(ctx->tile, XEVE_ERR_OUT_OF_MEMORY);
+    xeve_mset(ctx->tile, 0, size);
+
+    qp_prev_eco = (u8 *)(ctx->tile + f_tile);
+    for (i = 0; i < f_tile; i++)
+    {
+        ctx->tile[i].qp_prev_eco = qp_prev_eco + i * ctx->param.threads;
+    }
+    return XEVE_OK;
+}
+
 int xeve_set_tile_info(XEVE_CTX * ctx)
 {
     XEVE_TILE  * tile;
@@ -2909,10 +3133,8 @@ int xeve_set_tile_info(XEVE_CTX * ctx)
 
     ctx->tile_to_slice_map[0] = 0;
     /* alloc tile information */
-    size = sizeof(XEVE_TILE) * f_tile;
-    ctx->tile = xeve_malloc(size);
-    xeve_assert_rv(ctx->tile, XEVE_ERR_OUT_OF_MEMORY);
-    xeve_mset(ctx->tile, 0, size);
+    size = xeve_alloc_tile(ctx, f_tile);
+    xeve_assert_rv(size == XEVE_OK, size);
 
     /* update tile information - Tile width, height, First ctb address */
     tidx = 0;
@@ -2978,7 +3200,8 @@ int xeve_ready(XEVE_CTX* ctx)
 
     if (ctx->param.rc_type != 0 || ctx->param.lookahead != 0 || ctx->param.use_fcst != 0)
     {
-        xeve_rc_create(ctx);
+        ret = xeve_rc_create(ctx);
+        xeve_assert_g(ret == XEVE_OK, ERR);
     }
     else
     {
@@ -2987,26 +3210,13 @@ int xeve_ready(XEVE_CTX* ctx)
         ctx->qp = ctx->param.qp;
     }
 
-    //initialize the threads to NULL
-    for (int i = 0; i < XEVE_MAX_THREADS; i++)
-    {
-        ctx->thread_pool[i] = 0;
-    }
-
     //get the context synchronization handle
     ctx->sync_block = get_synchronized_object();
     xeve_assert_gv(ctx->sync_block != NULL, ret, XEVE_ERR_UNKNOWN, ERR);
 
-    if (ctx->param.threads >= 1)
-    {
-        ctx->tc = xeve_malloc(sizeof(THREAD_CONTROLLER));
-        init_thread_controller(ctx->tc, ctx->param.threads);
-        for (int i = 0; i < ctx->param.threads; i++)
-        {
-            ctx->thread_pool[i] = ctx->tc->create(ctx->tc, i);
-            xeve_assert_gv(ctx->thread_pool[i] != NULL, ret, XEVE_ERR_UNKNOWN, ERR);
-        }
-    }
+    //the calling thread executes tasks as well while waiting
+    ctx->ts = task_scheduler_create(ctx->param.threads - 1);
+    xeve_assert_gv(ctx->ts != NULL, ret, XEVE_ERR_UNKNOWN, ERR);
 
     size = ctx->f_lcu * sizeof(int);
     ctx->sync_flag = (volatile s32 *)xeve_malloc(size);
@@ -3016,6 +3226,15 @@ int xeve_ready(XEVE_CTX* ctx)
         ctx->sync_flag[i] = 0;
     }
 
+    ctx->row_state = (XEVE_ROW_STATE *)xeve_malloc(sizeof(XEVE_ROW_STATE) * ctx->h_lcu * ctx->param.tile_columns);
+    xeve_assert_gv(ctx->row_state, ret, XEVE_ERR_OUT_OF_MEMORY, ERR);
+    ctx->map_ctu_time = (s32 *)xeve_malloc(sizeof(s32) * ctx->f_lcu);
+    xeve_assert_gv(ctx->map_ctu_time, ret, XEVE_ERR_OUT_OF_MEMORY, ERR);
+    xeve_mset(ctx->map_ctu_time, 0, sizeof(s32) * ctx->f_lcu);
+    ctx->row_time = (long long *)xeve_malloc(sizeof(long long) * ctx->h_lcu);
+    xeve_assert_gv(ctx->row_time, ret, XEVE_ERR_OUT_OF_MEMORY, ERR);
+    xeve_mset(ctx->row_time, 0, sizeof(long long) * ctx->h_lcu);
+
     /*  allocate CU data map*/
     if (ctx->map_cu_data == NULL)
     {
@@ -3069,6 +3288,7 @@ int xeve_ready(XEVE_CTX* ctx)
     ctx->pa.pad_l = PIC_PAD_SIZE_L;
     ctx->pa.pad_c = PIC_PAD_SIZE_L >> ctx->param.cs_h_shift;
     ctx->pa.bit_depth = ctx->param.codec_bit_depth;
+    ctx->pa.me_pyramid = ctx->param.me_pyramid;
     ctx->pic_cnt = 0;
     ctx->pic_icnt = -1;
     ctx->poc.poc_val = 0;
@@ -3077,22 +3297,23 @@ int xeve_ready(XEVE_CTX* ctx)
     ret = xeve_picman_init(&ctx->rpm, MAX_PB_SIZE, XEVE_MAX_NUM_REF_PICS, &ctx->pa);
     xeve_assert_g(XEVE_SUCCEEDED(ret), ERR);
 
-    if (ctx->param.gop_size == 1 && ctx->param.keyint != 1) //LD case
+    if (ctx->param.bframes)
     {
-        ctx->pico_max_cnt = 2;
+        ctx->frm_rnum = XEVE_MAX(ctx->param.bframes + 1, ctx->param.lookahead);
     }
-    else //RA case
+    else
     {
-        ctx->pico_max_cnt = 1 + ((ctx->param.gop_size) << 1);
+        ctx->frm_rnum = 0;
     }
 
-    if (ctx->param.bframes)
+    if (ctx->param.gop_size == 1 && ctx->param.keyint != 1) //LD case
     {
-        ctx->frm_rnum = XEVE_MAX(ctx->param.bframes + 1, ctx->param.lookahead);
+        ctx->pico_max_cnt = 2;
     }
-    else
+    else //RA case
     {
-        ctx->frm_rnum = 0;
+        /* delayed pictures and the previous GOP are kept in pico_buf[] */
+        ctx->pico_max_cnt = 1 + ctx->param.gop_size + XEVE_MAX(ctx->param.gop_size, ctx->frm_rnum);
     }
 
     ctx->qp = ctx->param.qp;
@@ -3102,6 +3323,10 @@ int xeve_ready(XEVE_CTX* ctx)
         fcst->w_blk = (ctx->w/2 + (((1 << (fcst->log2_fcst_blk_spic + 1)) - 1))) >> (fcst->log2_fcst_blk_spic + 1);
         fcst->h_blk = (ctx->h/2 + (((1 << (fcst->log2_fcst_blk_spic + 1)) - 1))) >> (fcst->log2_fcst_blk_spic + 1);
         fcst->f_blk = fcst->w_blk * fcst->h_blk;
+        fcst->sub_cnt = 0;
+        fcst->done_cnt = 0;
+        fcst->queued = 0;
+        task_group_init(&fcst->grp);
     }
 
     for (i = 0; i < ctx->pico_max_cnt; i++)
@@ -3205,28 +3430,12 @@ ERR:
         release_synchornized_object(&ctx->sync_block);
     }
 
-    if (ctx->param.threads >= 1)
-    {
-        if (ctx->tc)
-        {
-            //thread controller instance is present
-            //terminate the created thread
-            for (int i = 0; i < ctx->param.threads; i++)
-            {
-                if (ctx->thread_pool[i])
-                {
-                    //valid thread instance
-                    ctx->tc->release(&ctx->thread_pool[i]);
-                }
-            }
-            //dinitialize the tc
-            dinit_thread_controller(ctx->tc);
-            xeve_mfree_fast(ctx->tc);
-            ctx->tc = 0;
-        }
-    }
+    task_scheduler_release(&ctx->ts);
 
     xeve_mfree_fast((void*)ctx->sync_flag);
+    xeve_mfree_fast(ctx->row_state);
+    xeve_mfree_fast(ctx->map_ctu_time);
+    xeve_mfree_fast(ctx->row_time);
 
     if (ctx->param.use_fcst)
     {
@@ -3252,7 +3461,7 @@ ERR:
         xeve_core_free(core);
     }
 
-    if (ctx->param.rc_type != 0 || ctx->param.lookahead != 0)
+    if (ctx->rc != NULL)
     {
         xeve_rc_delete(ctx);
     }
@@ -3265,6 +3474,8 @@ void xeve_flush(XEVE_CTX * ctx)
     int i;
     xeve_assert(ctx);
 
+    xeve_forecast_wait(ctx);
+
     xeve_mfree_fast(ctx->map_scu);
     for(i = 0; i < (int)ctx->f_lcu; i++)
     {
@@ -3274,6 +3485,7 @@ void xeve_flush(XEVE_CTX * ctx)
     xeve_mfree_fast(ctx->map_ipm);
     xeve_mfree_fast(ctx->map_depth);
     xeve_mfree_fast(ctx->sh_array);
+    xeve_mfree_fast(ctx->tile);
 
     //release the sync block
     if (ctx->sync_block)
@@ -3281,29 +3493,13 @@ void xeve_flush(XEVE_CTX * ctx)
         release_synchornized_object(&ctx->sync_block);
     }
 
-    //Release thread pool controller and created threads
-    if (ctx->param.threads >= 1)
-    {
-        if(ctx->tc)
-        {
-            //thread controller instance is present
-            //terminate the created thread
-            for (int i = 0; i < ctx->param.threads; i++)
-            {
-                if(ctx->thread_pool[i])
-                {
-                    //valid thread instance
-                    ctx->tc->release(&ctx->thread_pool[i]);
-                }
-            }
-            //dinitialize the tc
-            dinit_thread_controller(ctx->tc);
-            xeve_mfree_fast(ctx->tc);
-            ctx->tc = 0;
-        }
-    }
+    //Release the task scheduler and its worker threads
+    task_scheduler_release(&ctx->ts);
 
         xeve_mfree_fast((void*) ctx->sync_flag);
+        xeve_mfree_fast(ctx->row_state);
+        xeve_mfree_fast(ctx->map_ctu_time);
+        xeve_mfree_fast(ctx->row_time);
 
     xeve_mfree_fast(ctx->map_cu_mode);
     xeve_picbuf_free(ctx->pic_dbk);
@@ -3328,6 +3524,10 @@ void xeve_flush(XEVE_CTX * ctx)
         xeve_mfree_fast(ctx->pico_buf[i]->sinfo.map_qp_blk);
         xeve_mfree_fast(ctx->pico_buf[i]->sinfo.map_qp_scu);
         xeve_mfree_fast(ctx->pico_buf[i]->sinfo.transfer_cost);
+        for(int j = 0; j < XEVE_ME_PYR_LEVEL; j++)
+        {
+            xeve_mfree(ctx->pico_buf[i]->buf_pyr[j]);
+        }
         xeve_mfree_fast(ctx->pico_buf[i]);
     }
 
@@ -3336,7 +3536,7 @@ void xeve_flush(XEVE_CTX * ctx)
         if(ctx->inbuf[i]) ctx->inbuf[i]->release(ctx->inbuf[i]);
     }
 
-    if (ctx->param.rc_type != 0 ||  ctx->param.aq_mode !=0)
+    if (ctx->rc != NULL)
     {
         xeve_rc_delete(ctx);
     }
@@ -3419,7 +3619,9 @@ void xeve_update_core_loc_param_mt(XEVE_CTX * ctx, XEVE_CORE * core)
     core->y_scu = core->y_lcu << (MAX_CU_LOG2 - MIN_CU_LOG2); // set y_scu location
 }
 
-int xeve_mt_get_next_ctu_num(XEVE_CTX * ctx, XEVE_CORE * core, int skip_ctb_line_cnt)
+/* the CTU rows of a tile are taken dynamically: a thread completing its row
+   continues with the first row of the tile not yet taken by any thread */
+int xeve_mt_get_next_ctu_num(XEVE_CTX * ctx, XEVE_CORE * core)
 {
     int sp_x_lcu = ctx->tile[core->tile_num].ctba_rs_first % ctx->w_lcu;
     int sp_y_lcu = ctx->tile[core->tile_num].ctba_rs_first / ctx->w_lcu;
@@ -3430,7 +3632,7 @@ int xeve_mt_get_next_ctu_num(XEVE_CTX * ctx, XEVE_CORE * core, int skip_ctb_line
     if (core->x_lcu == sp_x_lcu + ctx->tile[core->tile_num].w_ctb)
     {
         core->x_lcu = sp_x_lcu;
-        core->y_lcu += skip_ctb_line_cnt;
+        core->y_lcu = sp_y_lcu + threadsafe_fetch_add(&ctx->tile[core->tile_num].row_next, 1);
     }
 
     core->lcu_num = core->y_lcu * ctx->w_lcu + core->x_lcu;
@@ -3445,6 +3647,53 @@ int xeve_mt_get_next_ctu_num(XEVE_CTX * ctx, XEVE_CORE * core, int skip_ctb_line
     return core->lcu_num;
 }
 
+/* CTU of a row after which the entropy coding state is stored for the row below */
+static int mt_row_state_x_lcu(XEVE_CTX * ctx, int tile_num)
+{
+    return ctx->tile[tile_num].ctba_rs_first % ctx->w_lcu + XEVE_MIN(1, ctx->tile[tile_num].w_ctb - 1);
+}
+
+/* the tiles of a tile column share the entropy coding state of a CTU row */
+static XEVE_ROW_STATE * mt_row_state(XEVE_CTX * ctx, int tile_num, int y_lcu)
+{
+    return &ctx->row_state[y_lcu * ctx->param.tile_columns + tile_num % ctx->param.tile_columns];
+}
+
+/* when several threads share the CTU rows, a row starts from the entropy
+   coding state of the row above rather than from the last row of the thread,
+   so the result does not depend on which thread takes which row */
+void xeve_mt_row_state_load(XEVE_CTX * ctx, XEVE_CORE * core, XEVE_SBAC * sbac, int * qp_prev_eco)
+{
+    XEVE_ROW_STATE * rs;
+    int sp_y_lcu = ctx->tile[core->tile_num].ctba_rs_first / ctx->w_lcu;
+
+    if (ctx->tile[core->tile_num].parallel_rows < 2 || core->y_lcu == sp_y_lcu)
+    {
+        return;
+    }
+
+    spinlock_wait(ctx->sync_block, &ctx->sync_flag[(core->y_lcu - 1) * ctx->w_lcu + mt_row_state_x_lcu(ctx, core->tile_num)], THREAD_TERMINATED, &core->sync_wait_time);
+    rs = mt_row_state(ctx, core->tile_num, core->y_lcu - 1);
+    xeve_mcpy(&sbac->ctx, &rs->sbac_ctx, sizeof(XEVE_SBAC_CTX));
+    *qp_prev_eco = rs->qp_prev_eco;
+}
+
+/* store the entropy coding state of the current row for the row below, it
+   has to be called before the CTU is marked as completed */
+void xeve_mt_row_state_store(XEVE_CTX * ctx, XEVE_CORE * core, XEVE_SBAC * sbac, int qp_prev_eco)
+{
+    XEVE_ROW_STATE * rs;
+
+    if (ctx->tile[core->tile_num].parallel_rows < 2 || core->x_lcu != mt_row_state_x_lcu(ctx, core->tile_num))
+    {
+        return;
+    }
+
+    rs = mt_row_state(ctx, core->tile_num, core->y_lcu);
+    xeve_mcpy(&rs->sbac_ctx, &sbac->ctx, sizeof(XEVE_SBAC_CTX));
+    rs->qp_prev_eco = (u8)qp_prev_eco;
+}
+
 int xeve_init_core_mt(XEVE_CTX * ctx, int tile_num, XEVE_CORE * core, int thread_cnt)
 {
     ctx->fn_mode_init_mt(ctx, thread_cnt);
@@ -3454,9 +3703,7 @@ int xeve_init_core_mt(XEVE_CTX * ctx, int tile_num, XEVE_CORE * core, int thread
     ctx->core[thread_cnt]->qp_y = core->qp_y;
     ctx->core[thread_cnt]->qp_u = core->qp_u;
     ctx->core[thread_cnt]->qp_v = core->qp_v;
-    ctx->sh->qp_prev_eco = ctx->sh->qp;
-    ctx->sh->qp_prev_mode = ctx->sh->qp;
-    ctx->core[thread_cnt]->dqp_data[ctx->log2_max_cuwh - 2][ctx->log2_max_cuwh - 2].prev_qp = ctx->sh->qp_prev_mode;
+    ctx->core[thread_cnt]->dqp_data[ctx->log2_max_cuwh - 2][ctx->log2_max_cuwh - 2].prev_qp = ctx->sh->qp;
     ctx->core[thread_cnt]->dqp_curr_best[ctx->log2_max_cuwh - 2][ctx->log2_max_cuwh - 2].curr_qp = ctx->sh->qp;
     ctx->core[thread_cnt]->dqp_curr_best[ctx->log2_max_cuwh - 2][ctx->log2_max_cuwh - 2].prev_qp = ctx->sh->qp;
     ctx->core[thread_cnt]->ctx = ctx;
@@ -3465,6 +3712,127 @@ int xeve_init_core_mt(XEVE_CTX * ctx, int tile_num, XEVE_CORE * core, int thread
     return XEVE_OK;
 }
 
+/* deblocking is pipelined with the mode decision when the picture is a
+   single tile of a single slice, the CTU rows are then filtered in order
+   by the threads completing the mode decision of the row below */
+void xeve_mt_deblock_init(XEVE_CTX * ctx)
+{
+    ctx->dbk_rows = 0;
+    ctx->dbk_pipe = ctx->sh->deblocking_filter_on && ctx->tile_cnt == 1 && ctx->ts_info.num_slice_in_pic == 1;
+}
+
+/* filter the vertical and then the horizontal edges of a CTU row, which gives
+   the same result as the picture level passes since the horizontal edges of
+   a row only access the last lines of the row above */
+static void deblock_ctu_row(XEVE_CTX * ctx, XEVE_CORE * core, int y_lcu)
+{
+    TREE_CONS tree_cons = core->tree_cons;
+    int scu_in_lcu_wh = 1 << (ctx->log2_max_cuwh - MIN_CU_LOG2);
+    int t_scu = y_lcu * scu_in_lcu_wh;
+    int b_scu = XEVE_MIN(ctx->h_scu, t_scu + scu_in_lcu_wh);
+    int is_hor_edge, i, j;
+    u32 k1;
+
+    for (is_hor_edge = 0; is_hor_edge <= 1; is_hor_edge++)
+    {
+        for (j = t_scu; j < b_scu; j++)
+        {
+            for (i = 0; i < ctx->w_scu; i++)
+            {
+                k1 = i + j * ctx->w_scu;
+                MCU_CLR_COD(ctx->map_scu[k1]);
+
+                if (!MCU_GET_DMVRF(ctx->map_scu[k1]))
+                {
+                    ctx->map_unrefined_mv[k1][REFP_0][MV_X] = ctx->map_mv[k1][REFP_0][MV_X];
+                    ctx->map_unrefined_mv[k1][REFP_0][MV_Y] = ctx->map_mv[k1][REFP_0][MV_Y];
+                    ctx->map_unrefined_mv[k1][REFP_1][MV_X] = ctx->map_mv[k1][REFP_1][MV_X];
+                    ctx->map_unrefined_mv[k1][REFP_1][MV_Y] = ctx->map_mv[k1][REFP_1][MV_Y];
+                }
+            }
+        }
+
+        for (i = 0; i < ctx->w_lcu; i++)
+        {
+            ctx->fn_deblock_tree(ctx, PIC_MODE(ctx), (i << ctx->log2_max_cuwh), (y_lcu << ctx->log2_max_cuwh), ctx->max_cuwh, ctx->max_cuwh, 0, 0, is_hor_edge
+                               , xeve_get_default_tree_cons(), core, ctx->pps.loop_filter_across_tiles_enabled_flag);
+        }
+    }
+    core->tree_cons = tree_cons;
+}
+
+/* deblock a CTU row once its mode decision is completed and the rows above
+   are deblocked */
+static void deblock_ctu_row_mt(XEVE_CTX * ctx, XEVE_CORE * core, int y_lcu)
+{
+    /* last CTU of the row */
+    spinlock_wait(ctx->sync_block, &ctx->sync_flag[(y_lcu + 1) * ctx->w_lcu - 1], THREAD_TERMINATED, &core->sync_wait_time);
+    spinlock_wait_progress(ctx->sync_block, &ctx->dbk_rows, y_lcu, &core->sync_wait_time);
+    deblock_ctu_row(ctx, core, y_lcu);
+    threadsafe_assign(ctx->sync_block, &ctx->dbk_rows, y_lcu + 1);
+}
+
+/* called when the mode decision of the CTU row of the core is completed,
+   the samples of the row above are no more referenced by the mode decision
+   (intra prediction, IBC and the deblocking estimation only access the
+   current and the above CTU row) so the row above can be deblocked */
+void xeve_mt_deblock_rows(XEVE_CTX * ctx, XEVE_CORE * core)
+{
+    if (!ctx->dbk_pipe)
+    {
+        return;
+    }
+
+    if (core->y_lcu > 0)
+    {
+        deblock_ctu_row_mt(ctx, core, core->y_lcu - 1);
+    }
+    if (core->y_lcu == ctx->h_lcu - 1)
+    {
+        deblock_ctu_row_mt(ctx, core, core->y_lcu);
+    }
+}
+
+/* copy the accumulated dependency wait time of each thread (microseconds),
+   *size is updated to the number of bytes written */
+int xeve_get_sync_wait_time(XEVE_CTX * ctx, long long * wait_time, int * size)
+{
+    int i, cnt;
+
+    cnt = XEVE_MIN(*size / (int)sizeof(long long), ctx->param.threads);
+    xeve_assert_rv(cnt > 0, XEVE_ERR_INVALID_ARGUMENT);
+    for (i = 0; i < cnt; i++)
+    {
+        wait_time[i] = ctx->core[i]->sync_wait_time;
+    }
+    *size = cnt * (int)sizeof(long long);
+    return XEVE_OK;
+}
+
+/* add the time of the CTUs of the current picture to their rows */
+void xeve_mt_row_time_update(XEVE_CTX * ctx)
+{
+    u32 i;
+
+    for (i = 0; i < ctx->f_lcu; i++)
+    {
+        ctx->row_time[i / ctx->w_lcu] += ctx->map_ctu_time[i];
+    }
+}
+
+/* copy the accumulated time of each CTU row (microseconds), *size is updated
+   to the number of bytes written */
+int xeve_get_row_time(XEVE_CTX * ctx, long long * row_time, int * size)
+{
+    int cnt;
+
+    cnt = XEVE_MIN(*size / (int)sizeof(long long), ctx->h_lcu);
+    xeve_assert_rv(cnt > 0, XEVE_ERR_INVALID_ARGUMENT);
+    xeve_mcpy(row_time, ctx->row_time, cnt * sizeof(long long));
+    *size = cnt * (int)sizeof(long long);
+    return XEVE_OK;
+}
+
 int xeve_deblock_mt(void * arg)
 {
     XEVE_CORE * core = (XEVE_CORE *)arg;
@@ -3478,7 +3846,7 @@ int xeve_loop_filter(XEVE_CTX * ctx, XEVE_CORE * core)
 {
     int ret = XEVE_OK;
 
-    if (ctx->sh->deblocking_filter_on)
+    if (ctx->sh->deblocking_filter_on && !ctx->dbk_pipe)
     {
 #if TRACE_DBF
         XEVE_TRACE_SET(1);
@@ -3494,44 +3862,18 @@ int xeve_loop_filter(XEVE_CTX * ctx, XEVE_CORE * core)
             {
                 ctx->sh = &ctx->sh_array[ctx->slice_num];
                 u16 total_tiles_in_slice = ctx->sh->num_tiles_in_slice;
-                THREAD_CONTROLLER * tc;
-                int res;
-                int i, k = 0;
-                tc = ctx->tc;
-                int parallel_task = 1;
-                int thread_cnt = 0, thread_cnt1 = 0;;
-                int task_completed = 0;
-
-                while (total_tiles_in_slice)
-                {
-                    parallel_task = 1;// (ctx->param.threads > total_tiles_in_slice) ? total_tiles_in_slice : ctx->param.threads;
-                    for (thread_cnt = 0; (thread_cnt < parallel_task - 1); thread_cnt++)
-                    {
-                        i = ctx->sh->tile_order[thread_cnt + task_completed];
-                        ctx->core[thread_cnt]->thread_cnt = thread_cnt;
-                        ctx->core[thread_cnt]->tile_num = i;
-                        ctx->core[thread_cnt]->deblock_is_hor = is_hor_edge;
 
-                        tc->run(ctx->thread_pool[thread_cnt], xeve_deblock_mt, (void*)ctx->core[thread_cnt]);
-                    }
-                    i = ctx->sh->tile_order[thread_cnt + task_completed];
-                    ctx->core[thread_cnt]->thread_cnt = thread_cnt;
-                    ctx->core[thread_cnt]->tile_num = i;
-                    ctx->core[thread_cnt]->deblock_is_hor = is_hor_edge;
+                /* tiles are filtered in order since the filtering of a tile
+                   boundary depends on the coded state of the neighbouring tile */
+                for (int k = 0; k < total_tiles_in_slice; k++)
+                {
+                    ctx->core[0]->thread_cnt = 0;
+                    ctx->core[0]->tile_num = ctx->sh->tile_order[k];
+                    ctx->core[0]->deblock_is_hor = is_hor_edge;
 
-                    xeve_deblock_mt((void*)ctx->core[thread_cnt]);
-                    for (thread_cnt1 = 0; thread_cnt1 < parallel_task - 1; thread_cnt1++)
-                    {
-                        tc->join(ctx->thread_pool[thread_cnt1], &res);
-                        if (XEVE_FAILED(res))
-                        {
-                            ret = res;
-                        }
-                    }
-                    total_tiles_in_slice -= parallel_task;
-                    task_completed += parallel_task;
+                    ret = xeve_deblock_mt((void*)ctx->core[0]);
+                    xeve_assert_rv(ret == XEVE_OK, ret);
                 }
-                total_tiles_in_slice = ctx->sh->num_tiles_in_slice;
             }
 #if TRACE_DBF
             XEVE_TRACE_SET(0);
@@ -3575,9 +3917,57 @@ int xeve_enc(XEVE_CTX * ctx, XEVE_BITB * bitb, XEVE_STAT * stat)
     ctx->fn_enc_pic_finish(ctx, bitb, stat);
     xeve_assert_rv(ret == XEVE_OK, ret);
 
+    /* remaining NAL units (SEI) */
+    ret = xeve_nalu_out(ctx, 1);
+    xeve_assert_rv(ret == XEVE_OK, ret);
+
     return XEVE_OK;
 }
 
+int xeve_nalu_out(XEVE_CTX * ctx, int last)
+{
+    XEVE_BSW * bs = &ctx->bs[0];
+    int        size;
+
+    if (ctx->nalu_out.fn == NULL)
+    {
+        return XEVE_OK;
+    }
+
+    /* the bitstream is byte aligned at the end of a NAL unit */
+    size = (int)(bs->cur - ctx->nalu_out_pos);
+    if (size > 0 || last)
+    {
+        if (ctx->nalu_out.fn(ctx->nalu_out.opaque, ctx->nalu_out_pos, size, last))
+        {
+            return XEVE_ERR;
+        }
+        ctx->nalu_out_pos = bs->cur;
+    }
+    return XEVE_OK;
+}
+
+
+/* check whether the planes of a pushed image can be used without copy */
+static int imgb_referable(XEVE_CTX * ctx, XEVE_IMGB * img)
+{
+    int i, w, h;
+
+    if(!ctx->param.inbuf_ref || ctx->fn_pic_flt != NULL) return 0;
+    if(img->addref == NULL || img->release == NULL) return 0;
+    if(img->cs != ctx->param.cs || XEVE_CS_GET_BYTE_DEPTH(img->cs) != sizeof(pel)) return 0;
+
+    for(i = 0; i < img->np; i++)
+    {
+        w = i == 0 ? ctx->w : ctx->w >> ctx->param.cs_w_shift;
+        h = i == 0 ? ctx->h : ctx->h >> ctx->param.cs_h_shift;
+
+        if(img->aw[i] < w || img->ah[i] < h) return 0;
+        if(img->s[i] < w * (int)sizeof(pel) || (img->s[i] % sizeof(pel)) != 0) return 0;
+        if(((size_t)img->a[i] % sizeof(pel)) != 0) return 0;
+    }
+    return 1;
+}
 
 int xeve_push_frm(XEVE_CTX * ctx, XEVE_IMGB * img)
 {
@@ -3587,15 +3977,24 @@ int xeve_push_frm(XEVE_CTX * ctx, XEVE_IMGB * img)
 
     int ret;
 
-    ret = ctx->fn_get_inbuf(ctx, &imgb);
-    xeve_assert_rv(XEVE_OK == ret, ret);
+    if(imgb_referable(ctx, img))
+    {
+        /* the image is released after the picture is encoded */
+        imgb = img;
+        imgb->addref(imgb);
+    }
+    else
+    {
+        ret = ctx->fn_get_inbuf(ctx, &imgb);
+        xeve_assert_rv(XEVE_OK == ret, ret);
 
-    imgb->cs = ctx->param.cs;
-    xeve_imgb_cpy(imgb, img);
+        imgb->cs = ctx->param.cs;
+        xeve_imgb_cpy(imgb, img);
 
-    if (ctx->fn_pic_flt != NULL)
-    {
-        ctx->fn_pic_flt(ctx, imgb);
+        if (ctx->fn_pic_flt != NULL)
+        {
+            ctx->fn_pic_flt(ctx, imgb);
+        }
     }
 
     ctx->pic_icnt++;
@@ -3628,6 +4027,22 @@ int xeve_push_frm(XEVE_CTX * ctx, XEVE_IMGB * img)
     pic->s_c = STRIDE_IMGB2PIC(imgb->s[1]);
 
     pic->imgb = imgb;
+
+    if (ctx->param.me_pyramid)
+    {
+        /* the padding only covers the pre-search blocks crossing the picture boundary */
+        int pad = 2 << XEVE_ME_PYR_LOG2_BLK;
+        if (pico->buf_pyr[0] == NULL)
+        {
+            ret = xeve_picbuf_alloc_pyr(pico->buf_pyr, pico->pyr, pico->s_pyr, pic->w_l, pic->h_l, pad);
+            xeve_assert_rv(ret == XEVE_OK, ret);
+        }
+        xeve_mcpy(pic->buf_pyr, pico->buf_pyr, sizeof(pic->buf_pyr));
+        xeve_mcpy(pic->pyr, pico->pyr, sizeof(pic->pyr));
+        xeve_mcpy(pic->s_pyr, pico->s_pyr, sizeof(pic->s_pyr));
+        xeve_picbuf_gen_pyr(pic->y, pic->s_l, pic->pyr, pic->s_pyr, pic->w_l, pic->h_l, pad);
+    }
+
     /* generate sub-picture for RC and Forecast */
     if (ctx->param.use_fcst)
     {
@@ -3653,24 +4068,45 @@ int xeve_push_frm(XEVE_CTX * ctx, XEVE_IMGB * img)
 void xeve_platform_init_func(XEVE_CTX * ctx)
 {
 #if X86_SSE
-    int check_cpu, support_sse, support_avx, support_avx2;
+    int check_cpu, support_sse, support_avx, support_avx2, support_avx512;
 
     check_cpu = xeve_check_cpu_info();
     support_sse  = (check_cpu >> 1) & 1;
     support_avx  = check_cpu & 1;
     support_avx2 = (check_cpu >> 2) & 1;
+    support_avx512 = (check_cpu >> 3) & 1;
 
-    if (support_avx2)
+    if (support_avx512)
+    {
+        xeve_func_sad               = xeve_tbl_sad_16b_avx512;
+        xeve_func_ssd               = xeve_tbl_ssd_16b_avx512;
+        xeve_func_diff              = xeve_tbl_diff_16b_avx512;
+        xeve_func_satd              = xeve_tbl_satd_16b_avx;
+        xeve_func_mc_l              = xeve_tbl_mc_l_avx512;
+        xeve_func_mc_c              = xeve_tbl_mc_c_avx512;
+        xeve_func_average_no_clip   = &xeve_average_16b_no_clip_sse;
+        ctx->fn_itxb                = &xeve_tbl_itxb_avx512;
+        xeve_func_txb               = &xeve_tbl_txb_avx512;
+        xeve_func_dbk_luma_hor      = &xeve_dbk_luma_hor_avx;
+        xeve_func_dbk_luma_ver      = &xeve_dbk_luma_ver_avx;
+        xeve_func_dbk_chroma_hor    = &xeve_dbk_chroma_hor_avx;
+        xeve_func_dbk_chroma_ver    = &xeve_dbk_chroma_ver_avx;
+    }
+    else if (support_avx2)
     {
         xeve_func_sad               = xeve_tbl_sad_16b_avx;
         xeve_func_ssd               = xeve_tbl_ssd_16b_sse;
         xeve_func_diff              = xeve_tbl_diff_16b_sse;
-        xeve_func_satd              = xeve_tbl_satd_16b_sse;
+        xeve_func_satd              = xeve_tbl_satd_16b_avx;
         xeve_func_mc_l              = xeve_tbl_mc_l_avx;
         xeve_func_mc_c              = xeve_tbl_mc_c_avx;
         xeve_func_average_no_clip   = &xeve_average_16b_no_clip_sse;
         ctx->fn_itxb                = &xeve_tbl_itxb_avx;
         xeve_func_txb               = &xeve_tbl_txb_avx;
+        xeve_func_dbk_luma_hor      = &xeve_dbk_luma_hor_avx;
+        xeve_func_dbk_luma_ver      = &xeve_dbk_luma_ver_avx;
+        xeve_func_dbk_chroma_hor    = &xeve_dbk_chroma_hor_avx;
+        xeve_func_dbk_chroma_ver    = &xeve_dbk_chroma_ver_avx;
     }
     else if (support_sse)
     {
@@ -3683,6 +4119,10 @@ void xeve_platform_init_func(XEVE_CTX * ctx)
         xeve_func_average_no_clip   = &xeve_average_16b_no_clip_sse;
         ctx->fn_itxb                = &xeve_tbl_itxb_sse;
         xeve_func_txb               = &xeve_tbl_txb; /*to be updated*/
+        xeve_func_dbk_luma_hor      = &xeve_dbk_luma_hor_sse;
+        xeve_func_dbk_luma_ver      = &xeve_dbk_luma_ver_sse;
+        xeve_func_dbk_chroma_hor    = &xeve_dbk_chroma_hor_sse;
+        xeve_func_dbk_chroma_ver    = &xeve_dbk_chroma_ver_sse;
     }
     else
 #endif
@@ -3696,13 +4136,68 @@ void xeve_platform_init_func(XEVE_CTX * ctx)
         xeve_func_average_no_clip   = &xeve_average_16b_no_clip;
         ctx->fn_itxb                = &xeve_tbl_itxb;
         xeve_func_txb               = &xeve_tbl_txb;
+        xeve_func_dbk_luma_hor      = &xeve_dbk_luma_hor;
+        xeve_func_dbk_luma_ver      = &xeve_dbk_luma_ver;
+        xeve_func_dbk_chroma_hor    = &xeve_dbk_chroma_hor;
+        xeve_func_dbk_chroma_ver    = &xeve_dbk_chroma_ver;
     }
 }
 
+int xeve_alloc_thread_data(XEVE_CTX * ctx)
+{
+    int threads = ctx->param.threads;
+
+    ctx->core = (XEVE_CORE **)xeve_malloc(sizeof(XEVE_CORE *) * threads);
+    xeve_assert_rv(ctx->core, XEVE_ERR_OUT_OF_MEMORY);
+    xeve_mset(ctx->core, 0, sizeof(XEVE_CORE *) * threads);
+
+    ctx->bs = (XEVE_BSW *)xeve_malloc(sizeof(XEVE_BSW) * threads);
+    xeve_assert_rv(ctx->bs, XEVE_ERR_OUT_OF_MEMORY);
+    xeve_mset(ctx->bs, 0, sizeof(XEVE_BSW) * threads);
+
+    ctx->sbac_enc = (XEVE_SBAC *)xeve_malloc(sizeof(XEVE_SBAC) * threads);
+    xeve_assert_rv(ctx->sbac_enc, XEVE_ERR_OUT_OF_MEMORY);
+    xeve_mset(ctx->sbac_enc, 0, sizeof(XEVE_SBAC) * threads);
+
+    ctx->mode = (XEVE_MODE *)xeve_malloc(sizeof(XEVE_MODE) * threads);
+    xeve_assert_rv(ctx->mode, XEVE_ERR_OUT_OF_MEMORY);
+    xeve_mset(ctx->mode, 0, sizeof(XEVE_MODE) * threads);
+
+    ctx->pintra = (XEVE_PINTRA *)xeve_malloc(sizeof(XEVE_PINTRA) * threads);
+    xeve_assert_rv(ctx->pintra, XEVE_ERR_OUT_OF_MEMORY);
+    xeve_mset(ctx->pintra, 0, sizeof(XEVE_PINTRA) * threads);
+
+    ctx->pinter = (XEVE_PINTER *)xeve_malloc(sizeof(XEVE_PINTER) * threads);
+    xeve_assert_rv(ctx->pinter, XEVE_ERR_OUT_OF_MEMORY);
+    xeve_mset(ctx->pinter, 0, sizeof(XEVE_PINTER) * threads);
+
+    return XEVE_OK;
+}
+
+void xeve_free_thread_data(XEVE_CTX * ctx)
+{
+    xeve_mfree(ctx->core);
+    xeve_mfree(ctx->bs);
+    xeve_mfree(ctx->sbac_enc);
+    xeve_mfree(ctx->mode);
+    xeve_mfree(ctx->pintra);
+    xeve_mfree(ctx->pinter);
+    ctx->core        = NULL;
+    ctx->bs          = NULL;
+    ctx->sbac_enc    = NULL;
+    ctx->mode        = NULL;
+    ctx->pintra      = NULL;
+    ctx->pinter      = NULL;
+}
+
 int xeve_platform_init(XEVE_CTX * ctx)
 {
     int ret = XEVE_ERR_UNKNOWN;
 
+    /* allocate per-thread data */
+    ret = xeve_alloc_thread_data(ctx);
+    xeve_assert_rv(XEVE_OK == ret, ret);
+
     /* create mode decision */
     ret = xeve_mode_create(ctx, 0);
     xeve_assert_rv(XEVE_OK == ret, ret);
@@ -3760,6 +4255,8 @@ void xeve_platform_deinit(XEVE_CTX * ctx)
 {
     xeve_assert(ctx->pf == NULL);
 
+    xeve_free_thread_data(ctx);
+
     ctx->fn_ready = NULL;
     ctx->fn_flush = NULL;
     ctx->fn_enc = NULL;
@@ -3777,7 +4274,8 @@ int xeve_create_bs_buf(XEVE_CTX  * ctx, int max_bs_buf_size)
     u8 * bs_buf, *bs_buf_temp;
     if (ctx->param.threads > 1)
     {
-        bs_buf = (u8 *)xeve_malloc(sizeof(u8 *) * (ctx->param.threads - 1) * max_bs_buf_size);
+        bs_buf = (u8 *)xeve_malloc(sizeof(u8) * (ctx->param.threads - 1) * max_bs_buf_size);
+        xeve_assert_rv(bs_buf, XEVE_ERR_OUT_OF_MEMORY);
         for (int task_id = 1; task_id < ctx->param.threads; task_id++)
         {
             bs_buf_temp = bs_buf + ((task_id - 1) * max_bs_buf_size);
@@ -3790,7 +4288,7 @@ int xeve_create_bs_buf(XEVE_CTX  * ctx, int max_bs_buf_size)
 
 int xeve_delete_bs_buf(XEVE_CTX  * ctx)
 {
-    if (ctx->param.threads > 1)
+    if (ctx->param.threads > 1 && ctx->bs != NULL)
     {
         u8 * bs_buf_temp = ctx->bs[1].beg;
         if (bs_buf_temp != NULL)
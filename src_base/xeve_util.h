@@ -93,6 +93,10 @@ u16  xeve_get_avail_intra(int x_scu, int y_scu, int w_scu, int h_scu, int scup,
 XEVE_PIC* xeve_picbuf_alloc(int w, int h, int pad_l, int pad_c, int bit_depth, int *err, int chroma_format_idc);
 void xeve_picbuf_free(XEVE_PIC *pic);
 void xeve_picbuf_expand(XEVE_PIC *pic, int exp_l, int exp_c, int chroma_format_idc);
+/* allocate the padded luma levels of the motion search pyramid */
+int xeve_picbuf_alloc_pyr(pel *buf[XEVE_ME_PYR_LEVEL], pel *a[XEVE_ME_PYR_LEVEL], int s[XEVE_ME_PYR_LEVEL], int w, int h, int pad);
+/* downscale luma by 2x2 averaging into each level of the pyramid and pad it */
+void xeve_picbuf_gen_pyr(pel *src, int s_src, pel *a[XEVE_ME_PYR_LEVEL], int s[XEVE_ME_PYR_LEVEL], int w, int h, int pad);
 void xeve_poc_derivation(XEVE_SPS sps, int tid, XEVE_POC *poc);
 void xeve_picbuf_rc_free(XEVE_PIC *pic);
 void xeve_check_motion_availability(int scup, int cuw, int cuh, int w_scu, int h_scu, int neb_addr[MAX_NUM_POSSIBLE_SCAND], int valid_flag[MAX_NUM_POSSIBLE_SCAND], u32 *map_scu, u16 avail_lr, int num_mvp, int is_ibc, u8 * map_tidx);
@@ -181,6 +185,8 @@ void xeve_imgb_garbage_free(XEVE_IMGB * imgb);
 #define XEVE_CPU_INFO_OSXSAVE  0x5B // ((2 << 5) | 27)
 #define XEVE_CPU_INFO_AVX      0x5C // ((2 << 5) | 28)
 #define XEVE_CPU_INFO_AVX2     0x25 // ((1 << 5) |  5)
+#define XEVE_CPU_INFO_AVX512F  0x30 // ((1 << 5) | 16)
+#define XEVE_CPU_INFO_AVX512BW 0x3E // ((1 << 5) | 30)
 
 int  xeve_check_cpu_info();
 
@@ -204,6 +210,7 @@ void xeve_ctx_free(XEVE_CTX * ctx);
 XEVE_CORE * xeve_core_alloc(int chroma_format_idc);
 void xeve_core_free(XEVE_CORE * core);
 void xeve_copy_chroma_qp_mapping_params(XEVE_CHROMA_TABLE *dst, XEVE_CHROMA_TABLE *src);
+int  xeve_get_auto_threads(XEVE_PARAM * param);
 int  xeve_set_init_param(XEVE_CTX * ctx, XEVE_PARAM * param);
 int  xeve_pic_finish(XEVE_CTX *ctx, XEVE_BITB *bitb, XEVE_STAT *stat);
 void xeve_set_nalu(XEVE_NALU * nalu, int nalu_type, int nuh_temporal_id);
@@ -212,6 +219,7 @@ void xeve_set_sps(XEVE_CTX * ctx, XEVE_SPS * sps);
 void xeve_set_pps(XEVE_CTX * ctx, XEVE_PPS * pps);
 int  xeve_set_active_pps_info(XEVE_CTX * ctx);
 void xeve_set_sh(XEVE_CTX *ctx, XEVE_SH *sh);
+int  xeve_alloc_tile(XEVE_CTX * ctx, int f_tile);
 int  xeve_set_tile_info(XEVE_CTX * ctx);
 int  xeve_platform_init(XEVE_CTX * ctx);
 void xeve_platform_deinit(XEVE_CTX * ctx);
@@ -219,6 +227,10 @@ int  xeve_pic_prepare(XEVE_CTX * ctx, XEVE_BITB * bitb, XEVE_STAT * stat);
 int  xeve_pic_finish(XEVE_CTX * ctx, XEVE_BITB * bitb, XEVE_STAT * stat);
 int  xeve_pic(XEVE_CTX * ctx, XEVE_BITB * bitb, XEVE_STAT * stat);
 int  xeve_enc(XEVE_CTX * ctx, XEVE_BITB * bitb, XEVE_STAT * stat);
+int  xeve_nalu_out(XEVE_CTX * ctx, int last);
+int  xeve_refresh_is_intra(XEVE_CTX * ctx, int x, int cuw);
+int  xeve_refresh_check_mv(XEVE_CTX * ctx, XEVE_MODE * mi, int x, int cuw);
+int  xeve_refresh_check_ipm(XEVE_CTX * ctx, int x, int cuw, int ipm, int is_chroma);
 int  xeve_push_frm(XEVE_CTX * ctx, XEVE_IMGB * img);
 int  xeve_ready(XEVE_CTX * ctx);
 void xeve_flush(XEVE_CTX * ctx);
@@ -226,13 +238,22 @@ int  xeve_picbuf_get_inbuf(XEVE_CTX * ctx, XEVE_IMGB ** img);
 int  xeve_header(XEVE_CTX * ctx);
 void xeve_update_core_loc_param(XEVE_CTX * ctx, XEVE_CORE * core);
 void xeve_update_core_loc_param_mt(XEVE_CTX * ctx, XEVE_CORE * core);
-int  xeve_mt_get_next_ctu_num(XEVE_CTX * ctx, XEVE_CORE * core, int skip_ctb_line_cnt);
+int  xeve_mt_get_next_ctu_num(XEVE_CTX * ctx, XEVE_CORE * core);
+void xeve_mt_row_state_load(XEVE_CTX * ctx, XEVE_CORE * core, XEVE_SBAC * sbac, int * qp_prev_eco);
+void xeve_mt_row_state_store(XEVE_CTX * ctx, XEVE_CORE * core, XEVE_SBAC * sbac, int qp_prev_eco);
 int  xeve_init_core_mt(XEVE_CTX * ctx, int tile_num, XEVE_CORE * core, int thread_cnt);
+void xeve_mt_deblock_init(XEVE_CTX * ctx);
+void xeve_mt_deblock_rows(XEVE_CTX * ctx, XEVE_CORE * core);
+int  xeve_get_sync_wait_time(XEVE_CTX * ctx, long long * wait_time, int * size);
+void xeve_mt_row_time_update(XEVE_CTX * ctx);
+int  xeve_get_row_time(XEVE_CTX * ctx, long long * row_time, int * size);
 int  xeve_deblock_mt(void * arg);
 int  xeve_loop_filter(XEVE_CTX * ctx, XEVE_CORE * core);
 void xeve_recon(XEVE_CTX * ctx, XEVE_CORE * core, s16 *coef, pel *pred, int is_coef, int cuw, int cuh, int s_rec, pel *rec, int bit_depth);
 void xeve_platform_init_func(XEVE_CTX * ctx);
 int  xeve_platform_init(XEVE_CTX * ctx);
+int  xeve_alloc_thread_data(XEVE_CTX * ctx);
+void xeve_free_thread_data(XEVE_CTX * ctx);
 int  xeve_create_bs_buf(XEVE_CTX  * ctx, int max_bs_buf_size);
 int  xeve_delete_bs_buf(XEVE_CTX  * ctx);
 int  xeve_encode_sps(XEVE_CTX * ctx);
@@ -0,0 +1,321 @@
+/* The copyright in this software is being made available under the BSD
+   License, included below. This software may be subject to contributor and
+   other third party rights, including patent rights, and no such rights are
+   granted under this license.
+
+   Copyright (c) 2020, Samsung Electronics Co., Ltd.
+   All Rights Reserved. */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+   
+   - Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+   
+   - Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+   
+   - Neither the name of the copyright owner, nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+   
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+   POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "xevem_type.h"
+#include "xevem_alf_avx.h"
+
+#if X86_SSE
+/****************************************************************************
+ * adaptive loop filter
+ ****************************************************************************/
+static const int alf_tbl_trans_coef[4][MAX_NUM_ALF_LUMA_COEFF] =
+{
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 },
+    { 9, 4, 10, 8, 1, 5, 11, 7, 3, 0, 2, 6, 12 },
+    { 0, 3, 2, 1, 8, 7, 6, 5, 4, 9, 10, 11, 12 },
+    { 9, 8, 10, 4, 3, 7, 11, 5, 1, 0, 2, 6, 12 }
+};
+
+#define ALF_LOAD_256(p)    _mm256_loadu_si256((const __m256i *)(p))
+
+/* coefficient pairs for _mm256_madd_epi16, the last pair of an odd number
+   of coefficients is padded with zero */
+static void alf_set_coef_pairs(int * pair, const short * coef, const int * idx, const int num_coef)
+{
+    int k, c0, c1;
+
+    for(k = 0; k < num_coef; k += 2)
+    {
+        c0 = coef[idx ? idx[k] : k];
+        c1 = (k + 1 < num_coef) ? coef[idx ? idx[k + 1] : k + 1] : 0;
+        pair[k >> 1] = (int)(((u32)(u16)c1 << 16) | (u16)c0);
+    }
+}
+
+static __inline void alf_taps_7(const pel * p0, const int s, __m256i * t)
+{
+    const pel * p1 = p0 + s, * p2 = p0 - s, * p3 = p1 + s, * p4 = p2 - s, * p5 = p3 + s, * p6 = p4 - s;
+
+    t[0]  = _mm256_add_epi16(ALF_LOAD_256(p5), ALF_LOAD_256(p6));
+    t[1]  = _mm256_add_epi16(ALF_LOAD_256(p3 + 1), ALF_LOAD_256(p4 - 1));
+    t[2]  = _mm256_add_epi16(ALF_LOAD_256(p3), ALF_LOAD_256(p4));
+    t[3]  = _mm256_add_epi16(ALF_LOAD_256(p3 - 1), ALF_LOAD_256(p4 + 1));
+    t[4]  = _mm256_add_epi16(ALF_LOAD_256(p1 + 2), ALF_LOAD_256(p2 - 2));
+    t[5]  = _mm256_add_epi16(ALF_LOAD_256(p1 + 1), ALF_LOAD_256(p2 - 1));
+    t[6]  = _mm256_add_epi16(ALF_LOAD_256(p1), ALF_LOAD_256(p2));
+    t[7]  = _mm256_add_epi16(ALF_LOAD_256(p1 - 1), ALF_LOAD_256(p2 + 1));
+    t[8]  = _mm256_add_epi16(ALF_LOAD_256(p1 - 2), ALF_LOAD_256(p2 + 2));
+    t[9]  = _mm256_add_epi16(ALF_LOAD_256(p0 + 3), ALF_LOAD_256(p0 - 3));
+    t[10] = _mm256_add_epi16(ALF_LOAD_256(p0 + 2), ALF_LOAD_256(p0 - 2));
+    t[11] = _mm256_add_epi16(ALF_LOAD_256(p0 + 1), ALF_LOAD_256(p0 - 1));
+    t[12] = ALF_LOAD_256(p0);
+    t[13] = _mm256_setzero_si256();
+}
+
+static __inline void alf_taps_5(const pel * p0, const int s, __m256i * t)
+{
+    const pel * p1 = p0 + s, * p2 = p0 - s, * p3 = p1 + s, * p4 = p2 - s;
+
+    t[0] = _mm256_add_epi16(ALF_LOAD_256(p3), ALF_LOAD_256(p4));
+    t[1] = _mm256_add_epi16(ALF_LOAD_256(p1 + 1), ALF_LOAD_256(p2 - 1));
+    t[2] = _mm256_add_epi16(ALF_LOAD_256(p1), ALF_LOAD_256(p2));
+    t[3] = _mm256_add_epi16(ALF_LOAD_256(p1 - 1), ALF_LOAD_256(p2 + 1));
+    t[4] = _mm256_add_epi16(ALF_LOAD_256(p0 + 2), ALF_LOAD_256(p0 - 2));
+    t[5] = _mm256_add_epi16(ALF_LOAD_256(p0 + 1), ALF_LOAD_256(p0 - 1));
+    t[6] = ALF_LOAD_256(p0);
+    t[7] = _mm256_setzero_si256();
+}
+
+/* filter the 16 pixels of the tap sums, the unpacked lower halves of the
+   lanes hold pixels 0-3 and 8-11, the upper halves pixels 4-7 and 12-15 */
+static __inline __m256i alf_filter_16px(const __m256i * t, const __m256i * coef_lo, const __m256i * coef_hi, const int num_pair, const __m256i min, const __m256i max)
+{
+    const __m256i offset = _mm256_set1_epi32(1 << 8);
+    __m256i lo = offset, hi = offset;
+    int k;
+
+    for(k = 0; k < num_pair; k++)
+    {
+        lo = _mm256_add_epi32(lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(t[k << 1], t[(k << 1) + 1]), coef_lo[k]));
+        hi = _mm256_add_epi32(hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(t[k << 1], t[(k << 1) + 1]), coef_hi[k]));
+    }
+    lo = _mm256_min_epi32(_mm256_max_epi32(_mm256_srai_epi32(lo, 9), min), max);
+    hi = _mm256_min_epi32(_mm256_max_epi32(_mm256_srai_epi32(hi, 9), min), max);
+    return _mm256_packs_epi32(lo, hi);
+}
+
+void xevem_alf_filter_blk_7_avx(ALF_CLASSIFIER ** classifier, pel * rec_dst, const int dst_stride, const pel * rec_src, const int src_stride, const AREA * blk, const u8 comp_id, short * filter_set, const CLIP_RANGE * clip_range)
+{
+    const __m256i min = _mm256_set1_epi32(clip_range->min);
+    const __m256i max = _mm256_set1_epi32(clip_range->max);
+    const int w16 = blk->width & ~15;
+    __m256i coef_lo[7], coef_hi[7], t[14];
+    int pair[4][7];
+    ALF_CLASSIFIER * alf_class, cl;
+    int i, j, k, ii;
+
+    for(i = 0; i < blk->height; i += 4)
+    {
+        alf_class = classifier[blk->y + i] + blk->x;
+
+        for(j = 0; j < w16; j += 16)
+        {
+            for(k = 0; k < 4; k++)
+            {
+                cl = alf_class[j + (k << 2)];
+                alf_set_coef_pairs(pair[k], filter_set + ((cl >> 2) & 0x1F) * MAX_NUM_ALF_LUMA_COEFF, alf_tbl_trans_coef[cl & 0x03], MAX_NUM_ALF_LUMA_COEFF);
+            }
+            for(k = 0; k < 7; k++)
+            {
+                coef_lo[k] = _mm256_setr_epi32(pair[0][k], pair[0][k], pair[0][k], pair[0][k], pair[2][k], pair[2][k], pair[2][k], pair[2][k]);
+                coef_hi[k] = _mm256_setr_epi32(pair[1][k], pair[1][k], pair[1][k], pair[1][k], pair[3][k], pair[3][k], pair[3][k], pair[3][k]);
+            }
+            for(ii = 0; ii < 4; ii++)
+            {
+                alf_taps_7(rec_src + (i + ii) * src_stride + j, src_stride, t);
+                _mm256_storeu_si256((__m256i *)(rec_dst + (i + ii) * dst_stride + j), alf_filter_16px(t, coef_lo, coef_hi, 7, min, max));
+            }
+        }
+    }
+    if(w16 < blk->width)
+    {
+        AREA rest = { blk->x + w16, blk->y, blk->width - w16, blk->height };
+        xevem_alf_filter_blk_7_sse(classifier, rec_dst + w16, dst_stride, rec_src + w16, src_stride, &rest, comp_id, filter_set, clip_range);
+    }
+}
+
+void xevem_alf_filter_blk_5_avx(ALF_CLASSIFIER ** classifier, pel * rec_dst, const int dst_stride, const pel * rec_src, const int src_stride, const AREA * blk, const u8 comp_id, short * filter_set, const CLIP_RANGE * clip_range)
+{
+    const __m256i min = _mm256_set1_epi32(clip_range->min);
+    const __m256i max = _mm256_set1_epi32(clip_range->max);
+    const int w16 = blk->width & ~15;
+    __m256i coef[4], t[8];
+    int pair[4];
+    int i, j, k;
+
+    alf_set_coef_pairs(pair, filter_set, NULL, MAX_NUM_ALF_CHROMA_COEFF);
+    for(k = 0; k < 4; k++)
+    {
+        coef[k] = _mm256_set1_epi32(pair[k]);
+    }
+
+    for(i = 0; i < blk->height; i++)
+    {
+        for(j = 0; j < w16; j += 16)
+        {
+            alf_taps_5(rec_src + i * src_stride + j, src_stride, t);
+            _mm256_storeu_si256((__m256i *)(rec_dst + i * dst_stride + j), alf_filter_16px(t, coef, coef, 4, min, max));
+        }
+    }
+    if(w16 < blk->width)
+    {
+        AREA rest = { blk->x + w16, blk->y, blk->width - w16, blk->height };
+        xevem_alf_filter_blk_5_sse(classifier, rec_dst + w16, dst_stride, rec_src + w16, src_stride, &rest, comp_id, filter_set, clip_range);
+    }
+}
+
+void xevem_alf_derive_classification_blk_avx(ALF_CLASSIFIER ** classifier, const pel * src_luma, const int src_stride, const AREA * blk, const int shift, int bit_depth)
+{
+    int laplacian[NUM_DIRECTIONS][CLASSIFICATION_BLK_SIZE + 5][CLASSIFICATION_BLK_SIZE + 5];
+    int sum[NUM_DIRECTIONS][(CLASSIFICATION_BLK_SIZE >> 2) + 1];
+    ALIGNED_32(int vh[8]);
+    ALIGNED_32(int dd[8]);
+    const __m256i ones = _mm256_set1_epi16(1);
+    const int num_grp = (blk->width >> 2) + 1;
+    const pel * src = src_luma + (blk->y - 2) * src_stride + blk->x - 2;
+    __m256i y, y_l, y_r, yd, yd_l, yd_r, yu, yu_l, yu_r, yu2, yu2_l, yu2_r, y2, yu_2, ver, hor, d0, d1;
+    int i, j, d, g;
+
+    for(i = 0; i < blk->height + 4; i += 2)
+    {
+        for(g = 0; g + 4 <= num_grp; g += 4)
+        {
+            const pel * s1 = src + (g << 2);
+            const pel * s0 = s1 - src_stride, * s2 = s1 + src_stride, * s3 = s2 + src_stride;
+
+            y     = ALF_LOAD_256(s1);
+            y_l   = ALF_LOAD_256(s1 - 1);
+            y_r   = ALF_LOAD_256(s1 + 1);
+            yd    = ALF_LOAD_256(s0);
+            yd_l  = ALF_LOAD_256(s0 - 1);
+            yd_r  = ALF_LOAD_256(s0 + 1);
+            yu    = ALF_LOAD_256(s2);
+            yu_l  = ALF_LOAD_256(s2 - 1);
+            yu_r  = ALF_LOAD_256(s2 + 1);
+            yu2   = ALF_LOAD_256(s3);
+            yu2_l = ALF_LOAD_256(s3 - 1);
+            yu2_r = ALF_LOAD_256(s3 + 1);
+            y2    = _mm256_slli_epi16(y, 1);
+            yu_2  = _mm256_slli_epi16(yu, 1);
+
+            ver = _mm256_add_epi16(_mm256_abs_epi16(_mm256_sub_epi16(_mm256_sub_epi16(y2, yd), yu)), _mm256_abs_epi16(_mm256_sub_epi16(_mm256_sub_epi16(yu_2, y), yu2)));
+            hor = _mm256_add_epi16(_mm256_abs_epi16(_mm256_sub_epi16(_mm256_sub_epi16(y2, y_r), y_l)), _mm256_abs_epi16(_mm256_sub_epi16(_mm256_sub_epi16(yu_2, yu_r), yu_l)));
+            d0  = _mm256_add_epi16(_mm256_abs_epi16(_mm256_sub_epi16(_mm256_sub_epi16(y2, yd_l), yu_r)), _mm256_abs_epi16(_mm256_sub_epi16(_mm256_sub_epi16(yu_2, y_l), yu2_r)));
+            d1  = _mm256_add_epi16(_mm256_abs_epi16(_mm256_sub_epi16(_mm256_sub_epi16(y2, yu_l), yd_r)), _mm256_abs_epi16(_mm256_sub_epi16(_mm256_sub_epi16(yu_2, yu2_l), y_r)));
+
+            /* per lane: group sums of two groups for two directions */
+            _mm256_store_si256((__m256i *)vh, _mm256_hadd_epi32(_mm256_madd_epi16(ver, ones), _mm256_madd_epi16(hor, ones)));
+            _mm256_store_si256((__m256i *)dd, _mm256_hadd_epi32(_mm256_madd_epi16(d0, ones), _mm256_madd_epi16(d1, ones)));
+
+            sum[VER][g]       = vh[0]; sum[VER][g + 1]   = vh[1];
+            sum[VER][g + 2]   = vh[4]; sum[VER][g + 3]   = vh[5];
+            sum[HOR][g]       = vh[2]; sum[HOR][g + 1]   = vh[3];
+            sum[HOR][g + 2]   = vh[6]; sum[HOR][g + 3]   = vh[7];
+            sum[DIAG0][g]     = dd[0]; sum[DIAG0][g + 1] = dd[1];
+            sum[DIAG0][g + 2] = dd[4]; sum[DIAG0][g + 3] = dd[5];
+            sum[DIAG1][g]     = dd[2]; sum[DIAG1][g + 1] = dd[3];
+            sum[DIAG1][g + 2] = dd[6]; sum[DIAG1][g + 3] = dd[7];
+        }
+        if(g < num_grp)
+        {
+            xevem_alf_laplacian_grp_sse(src, src_stride, g, num_grp, sum[VER], sum[HOR], sum[DIAG0], sum[DIAG1]);
+        }
+        for(d = 0; d < NUM_DIRECTIONS; d++)
+        {
+            for(j = 0; j < num_grp - 1; j++)
+            {
+                laplacian[d][i][j << 2] = sum[d][j] + sum[d][j + 1];
+            }
+        }
+        src += src_stride << 1;
+    }
+    alf_derive_classification_lap(classifier, laplacian, blk, bit_depth);
+}
+
+/* accumulate the outer product of the filter taps, the entries below the
+   diagonal are overwritten by the mirrored entries at the end of a block */
+static __inline void alf_cov_acc_avx(ALF_COVARIANCE * cov, const int * e, const int num_coef, const int y_local)
+{
+    __m128i ek, p;
+    double * E;
+    int k, l;
+
+    for(k = 0; k < num_coef; k++)
+    {
+        E = cov->E[k];
+        ek = _mm_set1_epi32(e[k]);
+        for(l = k & ~3; l + 4 <= num_coef; l += 4)
+        {
+            p = _mm_mullo_epi32(ek, _mm_loadu_si128((const __m128i *)(e + l)));
+            _mm256_storeu_pd(E + l, _mm256_add_pd(_mm256_loadu_pd(E + l), _mm256_cvtepi32_pd(p)));
+        }
+        for(l = XEVE_MAX(l, k); l < num_coef; l++)
+        {
+            E[l] += e[k] * e[l];
+        }
+        cov->y[k] += e[k] * y_local;
+    }
+    cov->pix_acc += y_local * y_local;
+}
+
+void xevem_alf_get_blk_stats_avx(int ch, ALF_COVARIANCE * alf_cov, const ALF_FILTER_SHAPE * shape, ALF_CLASSIFIER ** classifier, pel * org0, const int org_stride, pel * rec0, const int rec_stride, const int x, const int y, const int width, const int height)
+{
+    int E_local[MAX_NUM_ALF_LUMA_COEFF];
+    int trans_idx = 0, class_idx = 0, num_classes, i, j, k, l;
+    pel * rec = rec0 + y * rec_stride + x;
+    pel * org = org0 + y * org_stride + x;
+
+    for(i = 0; i < height; i++)
+    {
+        for(j = 0; j < width; j++)
+        {
+            xeve_mset(E_local, 0, shape->num_coef * sizeof(int));
+            if(classifier)
+            {
+                ALF_CLASSIFIER cl = classifier[(ch ? (y << 1) : y) + i][(ch ? (x << 1) : x) + j];
+                trans_idx = cl & 0x03;
+                class_idx = (cl >> 2) & 0x1F;
+            }
+            xeve_alf_clac_covariance(E_local, rec + j, rec_stride, shape->pattern, shape->filterLength >> 1, trans_idx);
+            alf_cov_acc_avx(&alf_cov[class_idx], E_local, shape->num_coef, org[j] - rec[j]);
+        }
+        org += org_stride;
+        rec += rec_stride;
+    }
+
+    num_classes = classifier ? MAX_NUM_ALF_CLASSES : 1;
+    for(class_idx = 0; class_idx < num_classes; class_idx++)
+    {
+        for(k = 1; k < shape->num_coef; k++)
+        {
+            for(l = 0; l < k; l++)
+            {
+                alf_cov[class_idx].E[k][l] = alf_cov[class_idx].E[l][k];
+            }
+        }
+    }
+}
+#endif /* X86_SSE */
@@ -0,0 +1,47 @@
+/* The copyright in this software is being made available under the BSD
+   License, included below. This software may be subject to contributor and
+   other third party rights, including patent rights, and no such rights are
+   granted under this license.
+
+   Copyright (c) 2020, Samsung Electronics Co., Ltd.
+   All Rights Reserved. */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+   
+   - Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+   
+   - Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+   
+   - Neither the name of the copyright owner, nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+   
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+   POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef _XEVEM_ALF_AVX_H_
+#define _XEVEM_ALF_AVX_H_
+
+#if X86_SSE
+void xevem_alf_derive_classification_blk_avx(ALF_CLASSIFIER ** classifier, const pel * src_luma, const int src_stride, const AREA * blk, const int shift, int bit_depth);
+void xevem_alf_filter_blk_7_avx(ALF_CLASSIFIER ** classifier, pel * rec_dst, const int dst_stride, const pel * rec_src, const int src_stride, const AREA * blk, const u8 comp_id, short * filter_set, const CLIP_RANGE * clip_range);
+void xevem_alf_filter_blk_5_avx(ALF_CLASSIFIER ** classifier, pel * rec_dst, const int dst_stride, const pel * rec_src, const int src_stride, const AREA * blk, const u8 comp_id, short * filter_set, const CLIP_RANGE * clip_range);
+void xevem_alf_get_blk_stats_avx(int ch, ALF_COVARIANCE * alf_cov, const ALF_FILTER_SHAPE * shape, ALF_CLASSIFIER ** classifier, pel * org0, const int org_stride, pel * rec0, const int rec_stride, const int x, const int y, const int width, const int height);
+#endif /* X86_SSE */
+
+#endif /* _XEVEM_ALF_AVX_H_ */
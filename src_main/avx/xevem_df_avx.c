@@ -0,0 +1,410 @@
+/* The copyright in this software is being made available under the BSD
+   License, included below. This software may be subject to contributor and
+   other third party rights, including patent rights, and no such rights are
+   granted under this license.
+
+   Copyright (c) 2020, Samsung Electronics Co., Ltd.
+   All Rights Reserved. */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+   
+   - Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+   
+   - Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+   
+   - Neither the name of the copyright owner, nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+   
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+   POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "xevem_type.h"
+#include "xevem_df_avx.h"
+
+#if X86_SSE
+
+/* 16-bit lanes stay exact up to 10-bit samples, deeper content goes to C */
+#define ADDB_MAX_BIT_DEPTH_AVX  10
+
+#define ADDB_CLIP_AVX(x, max) \
+    _mm256_min_epi16(_mm256_max_epi16(x, _mm256_setzero_si256()), max)
+
+#define ADDB_CLIP3_AVX(x, c) \
+    _mm256_min_epi16(_mm256_max_epi16(x, _mm256_sub_epi16(_mm256_setzero_si256(), c)), c)
+
+#define ADDB_CMPLT_AVX(a, b) \
+    _mm256_cmpgt_epi16(b, a)
+
+#define ADDB_MUL3_AVX(x) \
+    _mm256_add_epi16(x, _mm256_slli_epi16(x, 1))
+
+/* transposes the 8x8 blocks of both 128-bit lanes */
+#define TRANSPOSE_8x8_16B_AVX(r0, r1, r2, r3, r4, r5, r6, r7) \
+{ \
+    __m256i a0_, a1_, a2_, a3_, a4_, a5_, a6_, a7_; \
+    __m256i b0_, b1_, b2_, b3_, b4_, b5_, b6_, b7_; \
+    a0_ = _mm256_unpacklo_epi16(r0, r1); \
+    a1_ = _mm256_unpackhi_epi16(r0, r1); \
+    a2_ = _mm256_unpacklo_epi16(r2, r3); \
+    a3_ = _mm256_unpackhi_epi16(r2, r3); \
+    a4_ = _mm256_unpacklo_epi16(r4, r5); \
+    a5_ = _mm256_unpackhi_epi16(r4, r5); \
+    a6_ = _mm256_unpacklo_epi16(r6, r7); \
+    a7_ = _mm256_unpackhi_epi16(r6, r7); \
+    b0_ = _mm256_unpacklo_epi32(a0_, a2_); \
+    b1_ = _mm256_unpackhi_epi32(a0_, a2_); \
+    b2_ = _mm256_unpacklo_epi32(a1_, a3_); \
+    b3_ = _mm256_unpackhi_epi32(a1_, a3_); \
+    b4_ = _mm256_unpacklo_epi32(a4_, a6_); \
+    b5_ = _mm256_unpackhi_epi32(a4_, a6_); \
+    b6_ = _mm256_unpacklo_epi32(a5_, a7_); \
+    b7_ = _mm256_unpackhi_epi32(a5_, a7_); \
+    r0 = _mm256_unpacklo_epi64(b0_, b4_); \
+    r1 = _mm256_unpackhi_epi64(b0_, b4_); \
+    r2 = _mm256_unpacklo_epi64(b1_, b5_); \
+    r3 = _mm256_unpackhi_epi64(b1_, b5_); \
+    r4 = _mm256_unpacklo_epi64(b2_, b6_); \
+    r5 = _mm256_unpackhi_epi64(b2_, b6_); \
+    r6 = _mm256_unpacklo_epi64(b3_, b7_); \
+    r7 = _mm256_unpackhi_epi64(b3_, b7_); \
+}
+
+/* bs, alpha, beta and c of 16 consecutive lines, lines 8..15 in the high lane */
+#define ADDB_LOAD_PRM_AVX(prm, bs, alpha, beta, c) \
+{ \
+    __m256i t0_, t1_, t2_, t3_, u0_, u1_, u2_, u3_; \
+    t0_ = _mm256_loadu2_m128i((__m128i*)((prm) + 8), (__m128i*)((prm))); \
+    t1_ = _mm256_loadu2_m128i((__m128i*)((prm) + 10), (__m128i*)((prm) + 2)); \
+    t2_ = _mm256_loadu2_m128i((__m128i*)((prm) + 12), (__m128i*)((prm) + 4)); \
+    t3_ = _mm256_loadu2_m128i((__m128i*)((prm) + 14), (__m128i*)((prm) + 6)); \
+    u0_ = _mm256_unpacklo_epi16(t0_, t1_); \
+    u1_ = _mm256_unpackhi_epi16(t0_, t1_); \
+    u2_ = _mm256_unpacklo_epi16(t2_, t3_); \
+    u3_ = _mm256_unpackhi_epi16(t2_, t3_); \
+    t0_ = _mm256_unpacklo_epi16(u0_, u1_); \
+    t1_ = _mm256_unpackhi_epi16(u0_, u1_); \
+    t2_ = _mm256_unpacklo_epi16(u2_, u3_); \
+    t3_ = _mm256_unpackhi_epi16(u2_, u3_); \
+    bs = _mm256_unpacklo_epi64(t0_, t2_); \
+    alpha = _mm256_unpackhi_epi64(t0_, t2_); \
+    beta = _mm256_unpacklo_epi64(t1_, t3_); \
+    c = _mm256_unpackhi_epi64(t1_, t3_); \
+}
+
+/* row r of an edge in the low lane and row r + 8 in the high lane */
+#define ADDB_LOAD_ROW_PAIR_AVX(buf, stride, r) \
+    _mm256_loadu2_m128i((__m128i*)((buf) + ((r) + 8) * (stride)), (__m128i*)((buf) + (r) * (stride)))
+
+#define ADDB_STORE_ROW_PAIR_AVX(buf, stride, r, v) \
+    _mm256_storeu2_m128i((__m128i*)((buf) + ((r) + 8) * (stride)), (__m128i*)((buf) + (r) * (stride)), v)
+
+/* lanes where the line is filtered at all */
+static __m256i addb_on_mask_avx(__m256i p0, __m256i p1, __m256i q0, __m256i q1, __m256i bs, __m256i alpha, __m256i beta)
+{
+    __m256i on;
+
+    on = _mm256_andnot_si256(_mm256_cmpeq_epi16(bs, _mm256_setzero_si256())
+                        , ADDB_CMPLT_AVX(_mm256_abs_epi16(_mm256_sub_epi16(p0, q0)), alpha));
+    on = _mm256_and_si256(on, ADDB_CMPLT_AVX(_mm256_abs_epi16(_mm256_sub_epi16(p1, p0)), beta));
+    on = _mm256_and_si256(on, ADDB_CMPLT_AVX(_mm256_abs_epi16(_mm256_sub_epi16(q1, q0)), beta));
+
+    return on;
+}
+
+/* p[0..3] and q[0..3] hold the samples from the edge outwards */
+static void addb_luma_avx(__m256i *p, __m256i *q, const XEVEM_DBK_PRM *prm, int bit_depth)
+{
+    __m256i bs, alpha, beta, c, c0, c1, max, two, four;
+    __m256i on, ap, aq, strong, flat, m;
+    __m256i sum, s0, s1, s2, n0, n1, d;
+    __m256i op[3], oq[3];
+
+    ADDB_LOAD_PRM_AVX(prm, bs, alpha, beta, c);
+
+    on = addb_on_mask_avx(p[0], p[1], q[0], q[1], bs, alpha, beta);
+    if(_mm256_testz_si256(on, on))
+    {
+        return;
+    }
+
+    c1 = c;
+    max = _mm256_set1_epi16((1 << bit_depth) - 1);
+    two = _mm256_set1_epi16(2);
+    four = _mm256_set1_epi16(4);
+
+    ap = ADDB_CMPLT_AVX(_mm256_abs_epi16(_mm256_sub_epi16(p[0], p[2])), beta);
+    aq = ADDB_CMPLT_AVX(_mm256_abs_epi16(_mm256_sub_epi16(q[0], q[2])), beta);
+    strong = _mm256_cmpeq_epi16(bs, _mm256_set1_epi16(DBF_ADDB_BS_INTRA_STRONG));
+    flat = ADDB_CMPLT_AVX(_mm256_abs_epi16(_mm256_sub_epi16(p[0], q[0])), _mm256_add_epi16(_mm256_srai_epi16(alpha, 2), two));
+
+    /* normal filter */
+    c0 = _mm256_sub_epi16(_mm256_setzero_si256(), _mm256_add_epi16(ap, aq));
+    c0 = _mm256_add_epi16(c1, _mm256_sll_epi16(c0, _mm_cvtsi32_si128(XEVE_MAX(0, bit_depth - 9))));
+    d = _mm256_add_epi16(_mm256_slli_epi16(_mm256_sub_epi16(q[0], p[0]), 2), _mm256_sub_epi16(p[1], q[1]));
+    d = ADDB_CLIP3_AVX(_mm256_srai_epi16(_mm256_add_epi16(d, four), 3), c0);
+    n0 = ADDB_CLIP_AVX(_mm256_add_epi16(p[0], d), max);
+    op[0] = n0;
+    n0 = ADDB_CLIP_AVX(_mm256_sub_epi16(q[0], d), max);
+    oq[0] = n0;
+
+    d = ADDB_MUL3_AVX(_mm256_add_epi16(_mm256_add_epi16(p[2], p[0]), q[0]));
+    d = _mm256_sub_epi16(_mm256_sub_epi16(d, _mm256_slli_epi16(p[1], 3)), q[1]);
+    d = ADDB_CLIP3_AVX(_mm256_srai_epi16(d, 4), c1);
+    op[1] = _mm256_blendv_epi8(p[1], _mm256_add_epi16(p[1], d), ap);
+
+    d = ADDB_MUL3_AVX(_mm256_add_epi16(_mm256_add_epi16(q[2], q[0]), p[0]));
+    d = _mm256_sub_epi16(_mm256_sub_epi16(d, _mm256_slli_epi16(q[1], 3)), p[1]);
+    d = ADDB_CLIP3_AVX(_mm256_srai_epi16(d, 4), c1);
+    oq[1] = _mm256_blendv_epi8(q[1], _mm256_add_epi16(q[1], d), aq);
+
+    /* strong filter of the intra edges */
+    sum = _mm256_add_epi16(_mm256_add_epi16(p[1], p[0]), q[0]);
+    s0 = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(p[2], _mm256_slli_epi16(sum, 1)), _mm256_add_epi16(q[1], four)), 3);
+    s1 = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(p[2], sum), two), 2);
+    s2 = _mm256_add_epi16(_mm256_slli_epi16(p[3], 1), ADDB_MUL3_AVX(p[2]));
+    s2 = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(s2, sum), four), 3);
+    n1 = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(_mm256_slli_epi16(p[1], 1), p[0]), _mm256_add_epi16(q[1], two)), 2);
+    m = _mm256_and_si256(ap, flat);
+    op[0] = _mm256_blendv_epi8(op[0], _mm256_blendv_epi8(n1, s0, m), strong);
+    op[1] = _mm256_blendv_epi8(op[1], _mm256_blendv_epi8(p[1], s1, m), strong);
+    op[2] = _mm256_blendv_epi8(p[2], _mm256_blendv_epi8(p[2], s2, m), strong);
+
+    sum = _mm256_add_epi16(_mm256_add_epi16(q[1], q[0]), p[0]);
+    s0 = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(q[2], _mm256_slli_epi16(sum, 1)), _mm256_add_epi16(p[1], four)), 3);
+    s1 = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(q[2], sum), two), 2);
+    s2 = _mm256_add_epi16(_mm256_slli_epi16(q[3], 1), ADDB_MUL3_AVX(q[2]));
+    s2 = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(s2, sum), four), 3);
+    n1 = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(_mm256_slli_epi16(q[1], 1), q[0]), _mm256_add_epi16(p[1], two)), 2);
+    m = _mm256_and_si256(aq, flat);
+    oq[0] = _mm256_blendv_epi8(oq[0], _mm256_blendv_epi8(n1, s0, m), strong);
+    oq[1] = _mm256_blendv_epi8(oq[1], _mm256_blendv_epi8(q[1], s1, m), strong);
+    oq[2] = _mm256_blendv_epi8(q[2], _mm256_blendv_epi8(q[2], s2, m), strong);
+
+    p[0] = _mm256_blendv_epi8(p[0], ADDB_CLIP_AVX(op[0], max), on);
+    p[1] = _mm256_blendv_epi8(p[1], ADDB_CLIP_AVX(op[1], max), on);
+    p[2] = _mm256_blendv_epi8(p[2], ADDB_CLIP_AVX(op[2], max), on);
+    q[0] = _mm256_blendv_epi8(q[0], ADDB_CLIP_AVX(oq[0], max), on);
+    q[1] = _mm256_blendv_epi8(q[1], ADDB_CLIP_AVX(oq[1], max), on);
+    q[2] = _mm256_blendv_epi8(q[2], ADDB_CLIP_AVX(oq[2], max), on);
+}
+
+/* p[0..1] and q[0..1] hold the samples from the edge outwards */
+static void addb_chroma_avx(__m256i *p, __m256i *q, const XEVEM_DBK_PRM *prm, int bit_depth)
+{
+    __m256i bs, alpha, beta, c, c0, max, two;
+    __m256i on, strong, d, s;
+
+    ADDB_LOAD_PRM_AVX(prm, bs, alpha, beta, c);
+
+    on = addb_on_mask_avx(p[0], p[1], q[0], q[1], bs, alpha, beta);
+    if(_mm256_testz_si256(on, on))
+    {
+        return;
+    }
+
+    c0 = c;
+    max = _mm256_set1_epi16((1 << bit_depth) - 1);
+    two = _mm256_set1_epi16(2);
+    strong = _mm256_cmpeq_epi16(bs, _mm256_set1_epi16(DBF_ADDB_BS_INTRA_STRONG));
+
+    d = _mm256_add_epi16(_mm256_slli_epi16(_mm256_sub_epi16(q[0], p[0]), 2), _mm256_sub_epi16(p[1], q[1]));
+    d = ADDB_CLIP3_AVX(_mm256_srai_epi16(_mm256_add_epi16(d, _mm256_set1_epi16(4)), 3), c0);
+
+    s = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(_mm256_slli_epi16(p[1], 1), p[0]), _mm256_add_epi16(q[1], two)), 2);
+    s = _mm256_blendv_epi8(_mm256_add_epi16(p[0], d), s, strong);
+    p[0] = _mm256_blendv_epi8(p[0], ADDB_CLIP_AVX(s, max), on);
+
+    s = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(_mm256_slli_epi16(q[1], 1), q[0]), _mm256_add_epi16(p[1], two)), 2);
+    s = _mm256_blendv_epi8(_mm256_sub_epi16(q[0], d), s, strong);
+    q[0] = _mm256_blendv_epi8(q[0], ADDB_CLIP_AVX(s, max), on);
+}
+
+void xevem_dbk_addb_luma_hor_avx(pel *buf, int stride, const XEVEM_DBK_PRM *prm, int len, int bit_depth)
+{
+    __m256i p[DBF_LENGTH], q[DBF_LENGTH];
+    pel * b;
+    int i, j;
+
+    if(bit_depth > ADDB_MAX_BIT_DEPTH_AVX)
+    {
+        xevem_dbk_addb_luma_hor(buf, stride, prm, len, bit_depth);
+        return;
+    }
+
+    for(i = 0; i + 16 <= len; i += 16)
+    {
+        b = buf + i;
+        for(j = 0; j < DBF_LENGTH; j++)
+        {
+            q[j] = _mm256_loadu_si256((__m256i*)(b + j * stride));
+            p[j] = _mm256_loadu_si256((__m256i*)(b - (j + 1) * stride));
+        }
+
+        addb_luma_avx(p, q, prm + i, bit_depth);
+
+        for(j = 0; j < DBF_LENGTH - 1; j++)
+        {
+            _mm256_storeu_si256((__m256i*)(b + j * stride), q[j]);
+            _mm256_storeu_si256((__m256i*)(b - (j + 1) * stride), p[j]);
+        }
+    }
+
+    if(i < len)
+    {
+        xevem_dbk_addb_luma_hor_sse(buf + i, stride, prm + i, len - i, bit_depth);
+    }
+}
+
+void xevem_dbk_addb_luma_ver_avx(pel *buf, int stride, const XEVEM_DBK_PRM *prm, int len, int bit_depth)
+{
+    __m256i p[DBF_LENGTH], q[DBF_LENGTH];
+    __m256i r[8];
+    pel * b;
+    int i, j;
+
+    if(bit_depth > ADDB_MAX_BIT_DEPTH_AVX)
+    {
+        xevem_dbk_addb_luma_ver(buf, stride, prm, len, bit_depth);
+        return;
+    }
+
+    for(i = 0; i + 16 <= len; i += 16)
+    {
+        b = buf + i * stride - DBF_LENGTH;
+        for(j = 0; j < 8; j++)
+        {
+            r[j] = ADDB_LOAD_ROW_PAIR_AVX(b, stride, j);
+        }
+        TRANSPOSE_8x8_16B_AVX(r[0], r[1], r[2], r[3], r[4], r[5], r[6], r[7]);
+        for(j = 0; j < DBF_LENGTH; j++)
+        {
+            p[j] = r[DBF_LENGTH - 1 - j];
+            q[j] = r[DBF_LENGTH + j];
+        }
+
+        addb_luma_avx(p, q, prm + i, bit_depth);
+
+        for(j = 0; j < DBF_LENGTH; j++)
+        {
+            r[DBF_LENGTH - 1 - j] = p[j];
+            r[DBF_LENGTH + j] = q[j];
+        }
+        TRANSPOSE_8x8_16B_AVX(r[0], r[1], r[2], r[3], r[4], r[5], r[6], r[7]);
+        for(j = 0; j < 8; j++)
+        {
+            ADDB_STORE_ROW_PAIR_AVX(b, stride, j, r[j]);
+        }
+    }
+
+    if(i < len)
+    {
+        xevem_dbk_addb_luma_ver_sse(buf + i * stride, stride, prm + i, len - i, bit_depth);
+    }
+}
+
+void xevem_dbk_addb_chroma_hor_avx(pel *buf, int stride, const XEVEM_DBK_PRM *prm, int len, int bit_depth)
+{
+    __m256i p[DBF_LENGTH_CHROMA], q[DBF_LENGTH_CHROMA];
+    pel * b;
+    int i, j;
+
+    if(bit_depth > ADDB_MAX_BIT_DEPTH_AVX)
+    {
+        xevem_dbk_addb_chroma_hor(buf, stride, prm, len, bit_depth);
+        return;
+    }
+
+    for(i = 0; i + 16 <= len; i += 16)
+    {
+        b = buf + i;
+        for(j = 0; j < DBF_LENGTH_CHROMA; j++)
+        {
+            q[j] = _mm256_loadu_si256((__m256i*)(b + j * stride));
+            p[j] = _mm256_loadu_si256((__m256i*)(b - (j + 1) * stride));
+        }
+
+        addb_chroma_avx(p, q, prm + i, bit_depth);
+
+        _mm256_storeu_si256((__m256i*)(b), q[0]);
+        _mm256_storeu_si256((__m256i*)(b - stride), p[0]);
+    }
+
+    if(i < len)
+    {
+        xevem_dbk_addb_chroma_hor_sse(buf + i, stride, prm + i, len - i, bit_depth);
+    }
+}
+
+void xevem_dbk_addb_chroma_ver_avx(pel *buf, int stride, const XEVEM_DBK_PRM *prm, int len, int bit_depth)
+{
+    __m256i p[DBF_LENGTH_CHROMA], q[DBF_LENGTH_CHROMA];
+    __m256i r[4], t0, t1, t2, t3;
+    __m128i lo, hi;
+    pel * b;
+    int i, j;
+
+    if(bit_depth > ADDB_MAX_BIT_DEPTH_AVX)
+    {
+        xevem_dbk_addb_chroma_ver(buf, stride, prm, len, bit_depth);
+        return;
+    }
+
+    for(i = 0; i + 16 <= len; i += 16)
+    {
+        b = buf + i * stride - DBF_LENGTH_CHROMA;
+        for(j = 0; j < 4; j++)
+        {
+            r[j] = _mm256_unpacklo_epi16(ADDB_LOAD_ROW_PAIR_AVX(b, stride, 2 * j), ADDB_LOAD_ROW_PAIR_AVX(b, stride, 2 * j + 1));
+        }
+        t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+        t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+        t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+        t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+        p[1] = _mm256_unpacklo_epi64(t0, t2);
+        p[0] = _mm256_unpackhi_epi64(t0, t2);
+        q[0] = _mm256_unpacklo_epi64(t1, t3);
+        q[1] = _mm256_unpackhi_epi64(t1, t3);
+
+        addb_chroma_avx(p, q, prm + i, bit_depth);
+
+        t0 = _mm256_unpacklo_epi16(p[1], p[0]);
+        t1 = _mm256_unpackhi_epi16(p[1], p[0]);
+        t2 = _mm256_unpacklo_epi16(q[0], q[1]);
+        t3 = _mm256_unpackhi_epi16(q[0], q[1]);
+        r[0] = _mm256_unpacklo_epi32(t0, t2);
+        r[1] = _mm256_unpackhi_epi32(t0, t2);
+        r[2] = _mm256_unpacklo_epi32(t1, t3);
+        r[3] = _mm256_unpackhi_epi32(t1, t3);
+        for(j = 0; j < 4; j++)
+        {
+            lo = _mm256_castsi256_si128(r[j]);
+            hi = _mm256_extracti128_si256(r[j], 1);
+            _mm_storel_epi64((__m128i*)(b + (2 * j) * stride), lo);
+            _mm_storel_epi64((__m128i*)(b + (2 * j + 1) * stride), _mm_srli_si128(lo, 8));
+            _mm_storel_epi64((__m128i*)(b + (2 * j + 8) * stride), hi);
+            _mm_storel_epi64((__m128i*)(b + (2 * j + 9) * stride), _mm_srli_si128(hi, 8));
+        }
+    }
+
+    if(i < len)
+    {
+        xevem_dbk_addb_chroma_ver_sse(buf + i * stride, stride, prm + i, len - i, bit_depth);
+    }
+}
+#endif /* X86_SSE */
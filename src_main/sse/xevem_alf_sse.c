@@ -0,0 +1,355 @@
+/* The copyright in this software is being made available under the BSD
+   License, included below. This software may be subject to contributor and
+   other third party rights, including patent rights, and no such rights are
+   granted under this license.
+
+   Copyright (c) 2020, Samsung Electronics Co., Ltd.
+   All Rights Reserved. */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+   
+   - Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+   
+   - Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+   
+   - Neither the name of the copyright owner, nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+   
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+   POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "xevem_type.h"
+#include "xevem_alf_sse.h"
+
+#if X86_SSE
+/****************************************************************************
+ * adaptive loop filter
+ ****************************************************************************/
+static const int alf_tbl_trans_coef[4][MAX_NUM_ALF_LUMA_COEFF] =
+{
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 },
+    { 9, 4, 10, 8, 1, 5, 11, 7, 3, 0, 2, 6, 12 },
+    { 0, 3, 2, 1, 8, 7, 6, 5, 4, 9, 10, 11, 12 },
+    { 9, 8, 10, 4, 3, 7, 11, 5, 1, 0, 2, 6, 12 }
+};
+
+/* load 8 pixels, or 4 pixels when the block is 4 pixels wide */
+static __inline __m128i alf_load(const pel * p, const int full)
+{
+    return full ? _mm_loadu_si128((const __m128i *)p) : _mm_loadl_epi64((const __m128i *)p);
+}
+
+/* coefficient pairs for _mm_madd_epi16, the last pair of an odd number of
+   coefficients is padded with zero */
+static void alf_set_coef_pairs(__m128i * pair, const short * coef, const int * idx, const int num_coef)
+{
+    int k, c0, c1;
+
+    for(k = 0; k < num_coef; k += 2)
+    {
+        c0 = coef[idx ? idx[k] : k];
+        c1 = (k + 1 < num_coef) ? coef[idx ? idx[k + 1] : k + 1] : 0;
+        pair[k >> 1] = _mm_set1_epi32((int)(((u32)(u16)c1 << 16) | (u16)c0));
+    }
+}
+
+static __inline void alf_taps_7(const pel * p0, const int s, const int full, __m128i * t)
+{
+    const pel * p1 = p0 + s, * p2 = p0 - s, * p3 = p1 + s, * p4 = p2 - s, * p5 = p3 + s, * p6 = p4 - s;
+
+    t[0]  = _mm_add_epi16(alf_load(p5, full), alf_load(p6, full));
+    t[1]  = _mm_add_epi16(alf_load(p3 + 1, full), alf_load(p4 - 1, full));
+    t[2]  = _mm_add_epi16(alf_load(p3, full), alf_load(p4, full));
+    t[3]  = _mm_add_epi16(alf_load(p3 - 1, full), alf_load(p4 + 1, full));
+    t[4]  = _mm_add_epi16(alf_load(p1 + 2, full), alf_load(p2 - 2, full));
+    t[5]  = _mm_add_epi16(alf_load(p1 + 1, full), alf_load(p2 - 1, full));
+    t[6]  = _mm_add_epi16(alf_load(p1, full), alf_load(p2, full));
+    t[7]  = _mm_add_epi16(alf_load(p1 - 1, full), alf_load(p2 + 1, full));
+    t[8]  = _mm_add_epi16(alf_load(p1 - 2, full), alf_load(p2 + 2, full));
+    t[9]  = _mm_add_epi16(alf_load(p0 + 3, full), alf_load(p0 - 3, full));
+    t[10] = _mm_add_epi16(alf_load(p0 + 2, full), alf_load(p0 - 2, full));
+    t[11] = _mm_add_epi16(alf_load(p0 + 1, full), alf_load(p0 - 1, full));
+    t[12] = alf_load(p0, full);
+    t[13] = _mm_setzero_si128();
+}
+
+static __inline void alf_taps_5(const pel * p0, const int s, const int full, __m128i * t)
+{
+    const pel * p1 = p0 + s, * p2 = p0 - s, * p3 = p1 + s, * p4 = p2 - s;
+
+    t[0] = _mm_add_epi16(alf_load(p3, full), alf_load(p4, full));
+    t[1] = _mm_add_epi16(alf_load(p1 + 1, full), alf_load(p2 - 1, full));
+    t[2] = _mm_add_epi16(alf_load(p1, full), alf_load(p2, full));
+    t[3] = _mm_add_epi16(alf_load(p1 - 1, full), alf_load(p2 + 1, full));
+    t[4] = _mm_add_epi16(alf_load(p0 + 2, full), alf_load(p0 - 2, full));
+    t[5] = _mm_add_epi16(alf_load(p0 + 1, full), alf_load(p0 - 1, full));
+    t[6] = alf_load(p0, full);
+    t[7] = _mm_setzero_si128();
+}
+
+/* filter the 8 pixels of the tap sums, the lower and upper 4 pixels use
+   their own coefficients */
+static __inline __m128i alf_filter_8px(const __m128i * t, const __m128i * coef_lo, const __m128i * coef_hi, const int num_pair, const __m128i min, const __m128i max)
+{
+    const __m128i offset = _mm_set1_epi32(1 << 8);
+    __m128i lo = offset, hi = offset;
+    int k;
+
+    for(k = 0; k < num_pair; k++)
+    {
+        lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(t[k << 1], t[(k << 1) + 1]), coef_lo[k]));
+        hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(t[k << 1], t[(k << 1) + 1]), coef_hi[k]));
+    }
+    lo = _mm_min_epi32(_mm_max_epi32(_mm_srai_epi32(lo, 9), min), max);
+    hi = _mm_min_epi32(_mm_max_epi32(_mm_srai_epi32(hi, 9), min), max);
+    return _mm_packs_epi32(lo, hi);
+}
+
+void xevem_alf_filter_blk_7_sse(ALF_CLASSIFIER ** classifier, pel * rec_dst, const int dst_stride, const pel * rec_src, const int src_stride, const AREA * blk, const u8 comp_id, short * filter_set, const CLIP_RANGE * clip_range)
+{
+    const __m128i min = _mm_set1_epi32(clip_range->min);
+    const __m128i max = _mm_set1_epi32(clip_range->max);
+    __m128i coef[2][7], t[14], out;
+    ALF_CLASSIFIER * alf_class, cl;
+    int i, j, k, ii;
+
+    for(i = 0; i < blk->height; i += 4)
+    {
+        alf_class = classifier[blk->y + i] + blk->x;
+
+        for(j = 0; j < blk->width; j += 8)
+        {
+            const int full = (j + 8 <= blk->width);
+
+            for(k = 0; k < (full ? 2 : 1); k++)
+            {
+                cl = alf_class[j + (k << 2)];
+                alf_set_coef_pairs(coef[k], filter_set + ((cl >> 2) & 0x1F) * MAX_NUM_ALF_LUMA_COEFF, alf_tbl_trans_coef[cl & 0x03], MAX_NUM_ALF_LUMA_COEFF);
+            }
+            for(ii = 0; ii < 4; ii++)
+            {
+                const pel * src = rec_src + (i + ii) * src_stride + j;
+                pel * dst = rec_dst + (i + ii) * dst_stride + j;
+
+                if(full)
+                {
+                    alf_taps_7(src, src_stride, 1, t);
+                    out = alf_filter_8px(t, coef[0], coef[1], 7, min, max);
+                    _mm_storeu_si128((__m128i *)dst, out);
+                }
+                else
+                {
+                    alf_taps_7(src, src_stride, 0, t);
+                    out = alf_filter_8px(t, coef[0], coef[0], 7, min, max);
+                    _mm_storel_epi64((__m128i *)dst, out);
+                }
+            }
+        }
+    }
+}
+
+void xevem_alf_filter_blk_5_sse(ALF_CLASSIFIER ** classifier, pel * rec_dst, const int dst_stride, const pel * rec_src, const int src_stride, const AREA * blk, const u8 comp_id, short * filter_set, const CLIP_RANGE * clip_range)
+{
+    const __m128i min = _mm_set1_epi32(clip_range->min);
+    const __m128i max = _mm_set1_epi32(clip_range->max);
+    const short * c = filter_set;
+    __m128i coef[4], t[8], out;
+    int i, j, sum;
+
+    alf_set_coef_pairs(coef, filter_set, NULL, MAX_NUM_ALF_CHROMA_COEFF);
+
+    for(i = 0; i < blk->height; i++)
+    {
+        const pel * src = rec_src + i * src_stride;
+        pel * dst = rec_dst + i * dst_stride;
+
+        for(j = 0; j + 8 <= blk->width; j += 8)
+        {
+            alf_taps_5(src + j, src_stride, 1, t);
+            out = alf_filter_8px(t, coef, coef, 4, min, max);
+            _mm_storeu_si128((__m128i *)(dst + j), out);
+        }
+        if(j + 4 <= blk->width)
+        {
+            alf_taps_5(src + j, src_stride, 0, t);
+            out = alf_filter_8px(t, coef, coef, 4, min, max);
+            _mm_storel_epi64((__m128i *)(dst + j), out);
+            j += 4;
+        }
+        for(; j < blk->width; j++)
+        {
+            const pel * p0 = src + j, * p1 = p0 + src_stride, * p2 = p0 - src_stride;
+            const pel * p3 = p1 + src_stride, * p4 = p2 - src_stride;
+
+            sum  = c[0] * (p3[0] + p4[0]);
+            sum += c[1] * (p1[1] + p2[-1]);
+            sum += c[2] * (p1[0] + p2[0]);
+            sum += c[3] * (p1[-1] + p2[1]);
+            sum += c[4] * (p0[2] + p0[-2]);
+            sum += c[5] * (p0[1] + p0[-1]);
+            sum += c[6] * p0[0];
+            dst[j] = clip_pel((sum + (1 << 8)) >> 9, *clip_range);
+        }
+    }
+}
+
+/* laplacian terms of 8 (or 4) pixels of a row pair, the second row of the
+   pair is the row below src */
+static __inline void alf_laplacian_8px(const pel * src, const int s, const int full, __m128i * ver, __m128i * hor, __m128i * d0, __m128i * d1)
+{
+    const pel * src_d = src - s, * src_u = src + s, * src_u2 = src + (s << 1);
+    __m128i y, y_l, y_r, yd, yd_l, yd_r, yu, yu_l, yu_r, yu2, yu2_l, yu2_r, y2, yu_2;
+
+    y     = alf_load(src, full);
+    y_l   = alf_load(src - 1, full);
+    y_r   = alf_load(src + 1, full);
+    yd    = alf_load(src_d, full);
+    yd_l  = alf_load(src_d - 1, full);
+    yd_r  = alf_load(src_d + 1, full);
+    yu    = alf_load(src_u, full);
+    yu_l  = alf_load(src_u - 1, full);
+    yu_r  = alf_load(src_u + 1, full);
+    yu2   = alf_load(src_u2, full);
+    yu2_l = alf_load(src_u2 - 1, full);
+    yu2_r = alf_load(src_u2 + 1, full);
+    y2    = _mm_slli_epi16(y, 1);
+    yu_2  = _mm_slli_epi16(yu, 1);
+
+    *ver = _mm_add_epi16(_mm_abs_epi16(_mm_sub_epi16(_mm_sub_epi16(y2, yd), yu)), _mm_abs_epi16(_mm_sub_epi16(_mm_sub_epi16(yu_2, y), yu2)));
+    *hor = _mm_add_epi16(_mm_abs_epi16(_mm_sub_epi16(_mm_sub_epi16(y2, y_r), y_l)), _mm_abs_epi16(_mm_sub_epi16(_mm_sub_epi16(yu_2, yu_r), yu_l)));
+    *d0  = _mm_add_epi16(_mm_abs_epi16(_mm_sub_epi16(_mm_sub_epi16(y2, yd_l), yu_r)), _mm_abs_epi16(_mm_sub_epi16(_mm_sub_epi16(yu_2, y_l), yu2_r)));
+    *d1  = _mm_add_epi16(_mm_abs_epi16(_mm_sub_epi16(_mm_sub_epi16(y2, yu_l), yd_r)), _mm_abs_epi16(_mm_sub_epi16(_mm_sub_epi16(yu_2, yu2_l), y_r)));
+}
+
+void xevem_alf_laplacian_grp_sse(const pel * src, const int stride, int g0, int g1, int * sum_ver, int * sum_hor, int * sum_d0, int * sum_d1)
+{
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i ver, hor, d0, d1, vh, dd;
+    int g;
+
+    for(g = g0; g < g1; g += 2)
+    {
+        const int full = (g + 1 < g1);
+
+        alf_laplacian_8px(src + (g << 2), stride, full, &ver, &hor, &d0, &d1);
+        vh = _mm_hadd_epi32(_mm_madd_epi16(ver, ones), _mm_madd_epi16(hor, ones));
+        dd = _mm_hadd_epi32(_mm_madd_epi16(d0, ones), _mm_madd_epi16(d1, ones));
+
+        sum_ver[g] = _mm_extract_epi32(vh, 0);
+        sum_hor[g] = _mm_extract_epi32(vh, 2);
+        sum_d0[g]  = _mm_extract_epi32(dd, 0);
+        sum_d1[g]  = _mm_extract_epi32(dd, 2);
+        if(full)
+        {
+            sum_ver[g + 1] = _mm_extract_epi32(vh, 1);
+            sum_hor[g + 1] = _mm_extract_epi32(vh, 3);
+            sum_d0[g + 1]  = _mm_extract_epi32(dd, 1);
+            sum_d1[g + 1]  = _mm_extract_epi32(dd, 3);
+        }
+    }
+}
+
+void xevem_alf_derive_classification_blk_sse(ALF_CLASSIFIER ** classifier, const pel * src_luma, const int src_stride, const AREA * blk, const int shift, int bit_depth)
+{
+    int laplacian[NUM_DIRECTIONS][CLASSIFICATION_BLK_SIZE + 5][CLASSIFICATION_BLK_SIZE + 5];
+    int sum[NUM_DIRECTIONS][(CLASSIFICATION_BLK_SIZE >> 2) + 1];
+    const int num_grp = (blk->width >> 2) + 1;
+    const pel * src = src_luma + (blk->y - 2) * src_stride + blk->x - 2;
+    int i, j, d;
+
+    for(i = 0; i < blk->height + 4; i += 2)
+    {
+        xevem_alf_laplacian_grp_sse(src, src_stride, 0, num_grp, sum[VER], sum[HOR], sum[DIAG0], sum[DIAG1]);
+        for(d = 0; d < NUM_DIRECTIONS; d++)
+        {
+            for(j = 0; j < num_grp - 1; j++)
+            {
+                laplacian[d][i][j << 2] = sum[d][j] + sum[d][j + 1];
+            }
+        }
+        src += src_stride << 1;
+    }
+    alf_derive_classification_lap(classifier, laplacian, blk, bit_depth);
+}
+
+/* accumulate the outer product of the filter taps, the entries below the
+   diagonal are overwritten by the mirrored entries at the end of a block */
+static __inline void alf_cov_acc_sse(ALF_COVARIANCE * cov, const int * e, const int num_coef, const int y_local)
+{
+    __m128i ek, p;
+    double * E;
+    int k, l;
+
+    for(k = 0; k < num_coef; k++)
+    {
+        E = cov->E[k];
+        ek = _mm_set1_epi32(e[k]);
+        for(l = k & ~3; l + 4 <= num_coef; l += 4)
+        {
+            p = _mm_mullo_epi32(ek, _mm_loadu_si128((const __m128i *)(e + l)));
+            _mm_storeu_pd(E + l, _mm_add_pd(_mm_loadu_pd(E + l), _mm_cvtepi32_pd(p)));
+            _mm_storeu_pd(E + l + 2, _mm_add_pd(_mm_loadu_pd(E + l + 2), _mm_cvtepi32_pd(_mm_srli_si128(p, 8))));
+        }
+        for(l = XEVE_MAX(l, k); l < num_coef; l++)
+        {
+            E[l] += e[k] * e[l];
+        }
+        cov->y[k] += e[k] * y_local;
+    }
+    cov->pix_acc += y_local * y_local;
+}
+
+void xevem_alf_get_blk_stats_sse(int ch, ALF_COVARIANCE * alf_cov, const ALF_FILTER_SHAPE * shape, ALF_CLASSIFIER ** classifier, pel * org0, const int org_stride, pel * rec0, const int rec_stride, const int x, const int y, const int width, const int height)
+{
+    int E_local[MAX_NUM_ALF_LUMA_COEFF];
+    int trans_idx = 0, class_idx = 0, num_classes, i, j, k, l;
+    pel * rec = rec0 + y * rec_stride + x;
+    pel * org = org0 + y * org_stride + x;
+
+    for(i = 0; i < height; i++)
+    {
+        for(j = 0; j < width; j++)
+        {
+            xeve_mset(E_local, 0, shape->num_coef * sizeof(int));
+            if(classifier)
+            {
+                ALF_CLASSIFIER cl = classifier[(ch ? (y << 1) : y) + i][(ch ? (x << 1) : x) + j];
+                trans_idx = cl & 0x03;
+                class_idx = (cl >> 2) & 0x1F;
+            }
+            xeve_alf_clac_covariance(E_local, rec + j, rec_stride, shape->pattern, shape->filterLength >> 1, trans_idx);
+            alf_cov_acc_sse(&alf_cov[class_idx], E_local, shape->num_coef, org[j] - rec[j]);
+        }
+        org += org_stride;
+        rec += rec_stride;
+    }
+
+    num_classes = classifier ? MAX_NUM_ALF_CLASSES : 1;
+    for(class_idx = 0; class_idx < num_classes; class_idx++)
+    {
+        for(k = 1; k < shape->num_coef; k++)
+        {
+            for(l = 0; l < k; l++)
+            {
+                alf_cov[class_idx].E[k][l] = alf_cov[class_idx].E[l][k];
+            }
+        }
+    }
+}
+#endif /* X86_SSE */
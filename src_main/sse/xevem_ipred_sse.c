@@ -0,0 +1,283 @@
+/* The copyright in this software is being made available under the BSD
+   License, included below. This software may be subject to contributor and
+   other third party rights, including patent rights, and no such rights are
+   granted under this license.
+
+   Copyright (c) 2020, Samsung Electronics Co., Ltd.
+   All Rights Reserved. */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+   
+   - Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+   
+   - Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+   
+   - Neither the name of the copyright owner, nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+   
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+   POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#include "xevem_type.h"
+#include "xevem_ipred_sse.h"
+
+#if X86_SSE
+
+#define TRANSPOSE_8x8_16B_SSE(r0, r1, r2, r3, r4, r5, r6, r7) \
+{ \
+    __m128i a0_, a1_, a2_, a3_, a4_, a5_, a6_, a7_; \
+    __m128i b0_, b1_, b2_, b3_, b4_, b5_, b6_, b7_; \
+    a0_ = _mm_unpacklo_epi16(r0, r1); \
+    a1_ = _mm_unpackhi_epi16(r0, r1); \
+    a2_ = _mm_unpacklo_epi16(r2, r3); \
+    a3_ = _mm_unpackhi_epi16(r2, r3); \
+    a4_ = _mm_unpacklo_epi16(r4, r5); \
+    a5_ = _mm_unpackhi_epi16(r4, r5); \
+    a6_ = _mm_unpacklo_epi16(r6, r7); \
+    a7_ = _mm_unpackhi_epi16(r6, r7); \
+    b0_ = _mm_unpacklo_epi32(a0_, a2_); \
+    b1_ = _mm_unpackhi_epi32(a0_, a2_); \
+    b2_ = _mm_unpacklo_epi32(a1_, a3_); \
+    b3_ = _mm_unpackhi_epi32(a1_, a3_); \
+    b4_ = _mm_unpacklo_epi32(a4_, a6_); \
+    b5_ = _mm_unpackhi_epi32(a4_, a6_); \
+    b6_ = _mm_unpacklo_epi32(a5_, a7_); \
+    b7_ = _mm_unpackhi_epi32(a5_, a7_); \
+    r0 = _mm_unpacklo_epi64(b0_, b4_); \
+    r1 = _mm_unpackhi_epi64(b0_, b4_); \
+    r2 = _mm_unpacklo_epi64(b1_, b5_); \
+    r3 = _mm_unpackhi_epi64(b1_, b5_); \
+    r4 = _mm_unpacklo_epi64(b2_, b6_); \
+    r5 = _mm_unpackhi_epi64(b2_, b6_); \
+    r6 = _mm_unpacklo_epi64(b3_, b7_); \
+    r7 = _mm_unpackhi_epi64(b3_, b7_); \
+}
+
+/* 4-tap filter of 8 consecutive outputs, a..d hold the taps starting at
+   pn_n1, p, pn and pn_p2 */
+#define IPRED_ANG_FILT8_SSE(a, b, c, d, f01, f23, rnd, max, out) \
+{ \
+    __m128i lo_, hi_; \
+    lo_ = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(a, b), f01), \
+                        _mm_madd_epi16(_mm_unpacklo_epi16(c, d), f23)); \
+    hi_ = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(a, b), f01), \
+                        _mm_madd_epi16(_mm_unpackhi_epi16(c, d), f23)); \
+    lo_ = _mm_srai_epi32(_mm_add_epi32(lo_, rnd), ADI_4T_FILTER_BITS); \
+    hi_ = _mm_srai_epi32(_mm_add_epi32(hi_, rnd), ADI_4T_FILTER_BITS); \
+    out = _mm_packs_epi32(lo_, hi_); \
+    out = _mm_min_epi16(_mm_max_epi16(out, _mm_setzero_si128()), max); \
+}
+
+static void ipred_ang_run(const pel *src, int base, pel *dst, int from, int to, const int *filt, int pos_max, int max_val)
+{
+    int i, k, pos[4];
+    pel temp_pel;
+
+    for(i = from; i < to; i++)
+    {
+        for(k = 0; k < 4; k++)
+        {
+            pos[k] = XEVE_CLIP3(-1, pos_max, base + i - 1 + k);
+        }
+        temp_pel = (src[pos[0]] * filt[0] + src[pos[1]] * filt[1] + src[pos[2]] * filt[2] + src[pos[3]] * filt[3] + ADI_4T_FILTER_OFFSET) >> ADI_4T_FILTER_BITS;
+        dst[i] = XEVE_CLIP3(0, max_val, temp_pel);
+    }
+}
+
+/* dst[i] = filt * src[base + i - 1 .. base + i + 2] for i in [0, n), taps
+   outside [-1, pos_max] are clamped as in the C kernels */
+static void ipred_ang_run_sse(const pel *src, int base, pel *dst, int n, const int *filt, int pos_max, int max_val)
+{
+    __m128i f01, f23, rnd, max, a, b, c, d, out;
+    const pel *s = src + base - 1;
+    int i, lo, hi;
+
+    lo = XEVE_MIN(n, XEVE_MAX(0, -base));
+    hi = XEVE_MAX(lo, XEVE_MIN(n, pos_max - 1 - base));
+
+    ipred_ang_run(src, base, dst, 0, lo, filt, pos_max, max_val);
+
+    f01 = _mm_set1_epi32((filt[1] << 16) | (filt[0] & 0xFFFF));
+    f23 = _mm_set1_epi32((filt[3] << 16) | (filt[2] & 0xFFFF));
+    rnd = _mm_set1_epi32(ADI_4T_FILTER_OFFSET);
+    max = _mm_set1_epi16((s16)max_val);
+
+    for(i = lo; i + 8 <= hi; i += 8)
+    {
+        a = _mm_loadu_si128((__m128i*)(s + i));
+        b = _mm_loadu_si128((__m128i*)(s + i + 1));
+        c = _mm_loadu_si128((__m128i*)(s + i + 2));
+        d = _mm_loadu_si128((__m128i*)(s + i + 3));
+        IPRED_ANG_FILT8_SSE(a, b, c, d, f01, f23, rnd, max, out);
+        _mm_storeu_si128((__m128i*)(dst + i), out);
+    }
+    if(i + 4 <= hi)
+    {
+        a = _mm_loadl_epi64((__m128i*)(s + i));
+        b = _mm_loadl_epi64((__m128i*)(s + i + 1));
+        c = _mm_loadl_epi64((__m128i*)(s + i + 2));
+        d = _mm_loadl_epi64((__m128i*)(s + i + 3));
+        IPRED_ANG_FILT8_SSE(a, b, c, d, f01, f23, rnd, max, out);
+        _mm_storel_epi64((__m128i*)(dst + i), out);
+        i += 4;
+    }
+
+    ipred_ang_run(src, base, dst, i, n, filt, pos_max, max_val);
+}
+
+/* dst[j * w + i] = src[i * h + j] */
+static void ipred_ang_transpose_sse(const pel *src, pel *dst, int w, int h)
+{
+    __m128i r0, r1, r2, r3, r4, r5, r6, r7;
+    int i, j;
+
+    if((w & 7) || (h & 7))
+    {
+        for(j = 0; j < h; j++)
+        {
+            for(i = 0; i < w; i++)
+            {
+                dst[j * w + i] = src[i * h + j];
+            }
+        }
+        return;
+    }
+
+    for(i = 0; i < w; i += 8)
+    {
+        for(j = 0; j < h; j += 8)
+        {
+            const pel *s = src + i * h + j;
+            pel *d = dst + j * w + i;
+
+            r0 = _mm_loadu_si128((__m128i*)(s));
+            r1 = _mm_loadu_si128((__m128i*)(s + h));
+            r2 = _mm_loadu_si128((__m128i*)(s + h * 2));
+            r3 = _mm_loadu_si128((__m128i*)(s + h * 3));
+            r4 = _mm_loadu_si128((__m128i*)(s + h * 4));
+            r5 = _mm_loadu_si128((__m128i*)(s + h * 5));
+            r6 = _mm_loadu_si128((__m128i*)(s + h * 6));
+            r7 = _mm_loadu_si128((__m128i*)(s + h * 7));
+            TRANSPOSE_8x8_16B_SSE(r0, r1, r2, r3, r4, r5, r6, r7);
+            _mm_storeu_si128((__m128i*)(d), r0);
+            _mm_storeu_si128((__m128i*)(d + w), r1);
+            _mm_storeu_si128((__m128i*)(d + w * 2), r2);
+            _mm_storeu_si128((__m128i*)(d + w * 3), r3);
+            _mm_storeu_si128((__m128i*)(d + w * 4), r4);
+            _mm_storeu_si128((__m128i*)(d + w * 5), r5);
+            _mm_storeu_si128((__m128i*)(d + w * 6), r6);
+            _mm_storeu_si128((__m128i*)(d + w * 7), r7);
+        }
+    }
+}
+
+void xevem_ipred_ang_less_ver_no_right_sse(pel *src_le, pel *src_up, pel *src_ri, u16 avail_lr, pel *dst, int w, int h, int ipm, int bit_depth)
+{
+    const int * mt = xevem_tbl_ipred_dxdy[ipm];
+    const int pos_max = w + h - 1;
+    const int max_val = (1 << bit_depth) - 1;
+    int offset, t_dx, j;
+
+    for(j = 0; j < h; j++)
+    {
+        t_dx = ((j + 1) * (mt[0])) >> 10;
+        offset = (((j + 1) * (mt[0])) >> 5) - ((t_dx) << 5);
+
+        ipred_ang_run_sse(src_up, t_dx, dst, w, xevem_tbl_ipred_adi[offset], pos_max, max_val);
+        dst += w;
+    }
+}
+
+void xevem_ipred_ang_gt_hor_no_right_sse(pel *src_le, pel *src_up, pel *src_ri, u16 avail_lr, pel *dst, int w, int h, int ipm, int bit_depth)
+{
+    const int * mt = xevem_tbl_ipred_dxdy[ipm];
+    const int pos_max = w + h - 1;
+    const int max_val = (1 << bit_depth) - 1;
+    pel tmp[MAX_CU_SIZE * MAX_CU_SIZE];
+    int offset, t_dy, i;
+
+    /* predict column by column, then transpose into raster order */
+    for(i = 0; i < w; i++)
+    {
+        t_dy = ((i + 1) * (mt[1])) >> 10;
+        offset = (((i + 1) * (mt[1])) >> 5) - ((t_dy) << 5);
+
+        ipred_ang_run_sse(src_le, t_dy, tmp + i * h, h, xevem_tbl_ipred_adi[offset], pos_max, max_val);
+    }
+    ipred_ang_transpose_sse(tmp, dst, w, h);
+}
+
+void xevem_ipred_ang_no_right_sse(pel *src_le, pel *src_up, pel *src_ri, u16 avail_lr, pel *dst, int w, int h, int ipm, int bit_depth)
+{
+    const int * mt = xevem_tbl_ipred_dxdy[ipm];
+    const int pos_max = w + h - 1;
+    const int max_val = (1 << bit_depth) - 1;
+    pel tmp[MAX_CU_SIZE * MAX_CU_SIZE];
+    int t_dy[MAX_CU_SIZE];
+    int filt[4];
+    const int * filter;
+    int offset, t_dx, i, j;
+
+    /* samples with j >= t_dy[i] come from the left column; taps run
+       backwards, so the filter is reversed and the run starts at y - 2 */
+    for(i = 0; i < w; i++)
+    {
+        t_dy[i] = ((i + 1) * (mt[1])) >> 10;
+        offset = (((i + 1) * (mt[1])) >> 5) - ((t_dy[i]) << 5);
+        filter = xevem_tbl_ipred_adi[offset];
+        filt[0] = filter[3]; filt[1] = filter[2]; filt[2] = filter[1]; filt[3] = filter[0];
+
+        if(t_dy[i] < h)
+        {
+            ipred_ang_run_sse(src_le, -1, tmp + i * h + t_dy[i], h - t_dy[i], filt, pos_max, max_val);
+        }
+    }
+    ipred_ang_transpose_sse(tmp, dst, w, h);
+
+    /* t_dy is non-decreasing, so the samples taken from the top row of
+       each line are a suffix starting at the first i with t_dy[i] > j */
+    for(j = 0, i = 0; j < h; j++)
+    {
+        while(i < w && t_dy[i] <= j)
+        {
+            i++;
+        }
+        if(i == w)
+        {
+            break;
+        }
+
+        t_dx = ((j + 1) * (mt[0])) >> 10;
+        offset = (((j + 1) * (mt[0])) >> 5) - ((t_dx) << 5);
+        filter = xevem_tbl_ipred_adi[offset];
+        filt[0] = filter[3]; filt[1] = filter[2]; filt[2] = filter[1]; filt[3] = filter[0];
+
+        ipred_ang_run_sse(src_up, i - t_dx - 1, dst + j * w + i, w - i, filt, pos_max, max_val);
+    }
+}
+
+const XEVE_INTRA_PRED_ANG xeve_tbl_intra_pred_ang_sse[3][2] =
+{
+    {xevem_ipred_ang_less_ver_no_right_sse, ipred_ang_less_ver_on_right},
+    {xevem_ipred_ang_gt_hor_no_right_sse, ipred_ang_gt_hor_on_right},
+    {xevem_ipred_ang_no_right_sse, ipred_ang_only_right},
+};
+
+#endif /* X86_SSE */
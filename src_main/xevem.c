@@ -188,6 +188,7 @@ static int ctu_mt_core(void * arg)
     xeve_update_core_loc_param_mt(ctx, core);
 
     int bef_cu_qp = ctx->tile[i].qp_prev_eco[core->thread_cnt];
+    long long ctu_start;
 
     /* LCU encoding loop */
     while (ctx->tile[i].f_ctb > 0)
@@ -195,8 +196,13 @@ static int ctu_mt_core(void * arg)
         if (core->y_lcu != sp_y_lcu && core->x_lcu < (sp_x_lcu + ctx->tile[core->tile_idx].w_ctb - 1))
         {
             /* up-right CTB */
-            spinlock_wait(&ctx->sync_flag[core->lcu_num - ctx->w_lcu + 1], THREAD_TERMINATED);
+            spinlock_wait(ctx->sync_block, &ctx->sync_flag[core->lcu_num - ctx->w_lcu + 1], THREAD_TERMINATED, &core->sync_wait_time);
         }
+        if (core->x_lcu == sp_x_lcu)
+        {
+            xeve_mt_row_state_load(ctx, core, GET_SBAC_ENC(bs), &bef_cu_qp);
+        }
+        ctu_start = get_time_us();
 
         /* initialize structures *****************************************/
         ret = ctx->fn_mode_init_lcu(ctx, core);
@@ -232,10 +238,18 @@ static int ctu_mt_core(void * arg)
 #endif
         xeve_assert_rv(ret == XEVE_OK, ret);
 
-        threadsafe_assign(&ctx->sync_flag[core->lcu_num], THREAD_TERMINATED);
+        xeve_mt_row_state_store(ctx, core, GET_SBAC_ENC(bs), bef_cu_qp);
+        ctx->map_ctu_time[core->lcu_num] = (s32)(get_time_us() - ctu_start);
+        threadsafe_assign(ctx->sync_block, &ctx->sync_flag[core->lcu_num], THREAD_TERMINATED);
         threadsafe_decrement(ctx->sync_block, (volatile s32 *)&ctx->tile[i].f_ctb);
 
-        core->lcu_num = xeve_mt_get_next_ctu_num(ctx, core, ctx->parallel_rows);
+        if (core->x_lcu == sp_x_lcu + ctb_cnt_in_row - 1)
+        {
+            /* loop filtering behind the wavefront */
+            xeve_mt_deblock_rows(ctx, core);
+        }
+
+        core->lcu_num = xeve_mt_get_next_ctu_num(ctx, core);
         if (core->lcu_num == -1)
             break;
     }
@@ -243,52 +257,213 @@ static int ctu_mt_core(void * arg)
 }
 
 
-static int tile_mt_core(void * arg)
+/* set up the core thread_cnt for the mode decision of the CTU row 'row' of
+   the tile i. every field the mode decision reads from the core is set here,
+   so the result does not depend on the tile the core coded before */
+static void tile_init_row_core(XEVE_CTX * ctx, int i, int thread_cnt, int row)
+{
+    XEVE_CORE * core = ctx->core[thread_cnt];
+    XEVE_SH   * sh = ctx->sh;
+
+    core->ctx = ctx;
+    core->thread_cnt = thread_cnt;
+    core->tile_idx = i;
+    core->x_lcu = (ctx->tile[i].ctba_rs_first) % ctx->w_lcu;         //entry point lcu's x location
+    core->y_lcu = (ctx->tile[i].ctba_rs_first) / ctx->w_lcu + row;   //entry point lcu's y location
+    core->lcu_num = core->y_lcu * ctx->w_lcu + core->x_lcu;
+    core->qp_y = sh->qp + 6 * ctx->sps.bit_depth_luma_minus8;
+    core->qp_u = ctx->qp_chroma_dynamic[0][sh->qp_u] + 6 * ctx->sps.bit_depth_chroma_minus8;
+    core->qp_v = ctx->qp_chroma_dynamic[1][sh->qp_v] + 6 * ctx->sps.bit_depth_chroma_minus8;
+    xevem_init_core_mt(ctx, i, core, thread_cnt);
+}
+
+/* set up the mode decision of the tile i by the wavefront of its parallel_rows
+   threads, the threads are thread_cnt and the threads following it */
+static void tile_init(XEVE_CTX * ctx, int i, int thread_cnt)
+{
+    int row, j;
+
+    /* the first rows are given to the threads, the others are taken on completion */
+    ctx->tile[i].row_next = ctx->tile[i].parallel_rows;
+    ctx->tile[i].qp = ctx->sh->qp;
+    for (j = 0; j < ctx->param.threads; j++)
+    {
+        ctx->tile[i].qp_prev_eco[j] = ctx->sh->qp;
+    }
+    for (row = 0; row < ctx->tile[i].parallel_rows; row++)
+    {
+        tile_init_row_core(ctx, i, thread_cnt + row, row);
+    }
+}
+
+/* encode tiles of the current picture until no tile is left, each tile task
+   takes the next tile which is not started yet by any other tile task and
+   codes it on its own */
+static int tile_task(void * arg)
 {
     XEVE_CORE * core = (XEVE_CORE *)arg;
     XEVE_CTX  * ctx = core->ctx;
-    int i;
-    int res, ret;
-    int temp_store_total_ctb = ctx->tile[core->tile_idx].f_ctb;
-    int parallel_task = ctx->tile_cnt == 1 ? ((ctx->param.threads > ctx->tile[core->tile_idx].h_ctb) ?
-                                             ctx->tile[core->tile_idx].h_ctb : ctx->param.threads): 1;
-    ctx->parallel_rows = parallel_task;
-    ctx->tile[core->tile_idx].qp = ctx->sh->qp;
-    for (i = 0; i < ctx->param.threads; i++)
+    int         left, i, ret;
+
+    while ((left = threadsafe_decrement(ctx->sync_block, &ctx->tile_left)) >= 0)
     {
-        ctx->tile[core->tile_idx].qp_prev_eco[i] = ctx->sh->qp;
+        i = ctx->md_tile_order[ctx->md_tile_cnt - 1 - left];
+        ctx->tile[i].parallel_rows = 1;
+        tile_init(ctx, i, core->thread_cnt);
+
+        ret = ctu_mt_core((void*)core);
+        xeve_assert_rv(ret == XEVE_OK, ret);
     }
+    return XEVE_OK;
+}
 
-    for (int thread_cnt = 1; thread_cnt < parallel_task; thread_cnt++)
-    {
-        ctx->core[thread_cnt]->tile_idx = core->tile_idx;
-        ctx->core[thread_cnt]->x_lcu = ((ctx->tile[core->tile_num].ctba_rs_first) % ctx->w_lcu);               //entry point lcu's x location
-        ctx->core[thread_cnt]->y_lcu = ((ctx->tile[core->tile_num].ctba_rs_first) / ctx->w_lcu) + thread_cnt; // entry point lcu's y location
-        ctx->core[thread_cnt]->lcu_num = ctx->core[thread_cnt]->y_lcu * ctx->w_lcu + ctx->core[thread_cnt]->x_lcu;
+/* spread the threads over the tiles of the current picture by their CTU
+   count: every tile has one thread, then each other thread goes to the tile
+   having the most CTUs per thread which has less threads than CTU rows */
+static void tile_split_threads(XEVE_CTX * ctx)
+{
+    XEVE_TILE * tile, * best;
+    int         i, left;
 
-        xevem_init_core_mt(ctx, core->tile_idx, core, thread_cnt);
+    for (i = 0; i < ctx->md_tile_cnt; i++)
+    {
+        ctx->tile[ctx->md_tile_order[i]].parallel_rows = 1;
+    }
 
-        ctx->core[thread_cnt]->thread_cnt = thread_cnt;
-        ctx->tc->run(ctx->thread_pool[thread_cnt], ctu_mt_core, (void*)ctx->core[thread_cnt]);
+    for (left = ctx->param.threads - ctx->md_tile_cnt; left > 0; left--)
+    {
+        best = NULL;
+        for (i = 0; i < ctx->md_tile_cnt; i++)
+        {
+            tile = &ctx->tile[ctx->md_tile_order[i]];
+            if (tile->parallel_rows < tile->h_ctb &&
+                (best == NULL || tile->f_ctb * best->parallel_rows > best->f_ctb * tile->parallel_rows))
+            {
+                best = tile;
+            }
+        }
+        if (best == NULL)
+        {
+            break;
+        }
+        best->parallel_rows++;
     }
+}
 
-    core->x_lcu = ((ctx->tile[core->tile_num].ctba_rs_first) % ctx->w_lcu);
-    core->y_lcu = ((ctx->tile[core->tile_num].ctba_rs_first) / ctx->w_lcu);
-    core->lcu_num = core->y_lcu * ctx->w_lcu + core->x_lcu;
+/* entropy code the CTUs of a tile, the tile ends byte aligned */
+static int eco_tile(XEVE_CTX * ctx, XEVE_CORE * core, XEVE_BSW * bs, int i)
+{
+    XEVE_SH * sh = ctx->sh;
+    XEVE_ALF_SLICE_PARAM * alf_slice_param = &(sh->alf_sh_param);
+    int       split_mode_child[4];
+    int       split_allow[6] = { 0, 0, 0, 0, 0, 1 };
+    int       ctb_cnt_in_tile, col_bd, ret;
+
+    ctx->tile[i].qp = sh->qp;
+    ctx->tile[i].qp_prev_eco[core->thread_cnt] = sh->qp;
+    core->tile_idx = i;
+
+    /* CABAC Initialize for each Tile */
+    ctx->fn_eco_sbac_reset(GET_SBAC_ENC(bs), sh->slice_type, sh->qp, ctx->sps.tool_cm_init);
 
-    ctu_mt_core(arg);
+    /*Set entry point for each Tile in the tile Slice*/
+    core->x_lcu = (ctx->tile[i].ctba_rs_first) % ctx->w_lcu; //entry point lcu's x location
+    core->y_lcu = (ctx->tile[i].ctba_rs_first) / ctx->w_lcu; // entry point lcu's y location
+    ctb_cnt_in_tile = ctx->tile[i].f_ctb; //Total LCUs in the current tile
+    xeve_update_core_loc_param(ctx, core);
 
-    for (int thread_cnt1 = 1; thread_cnt1 < parallel_task; thread_cnt1++)
+    col_bd = 0;
+    if (i% ctx->param.tile_columns)
     {
-        ctx->tc->join(ctx->thread_pool[thread_cnt1], &res);
-        if (XEVE_FAILED(res))
+        int temp = i - 1;
+        while (temp >= 0)
         {
-            ret = res;
+            col_bd += ctx->tile[temp].w_ctb;
+            if (!(temp%ctx->param.tile_columns)) break;
+            temp--;
         }
     }
 
-    ctx->tile[core->tile_idx].f_ctb = temp_store_total_ctb;
+    while (1) // LCU level CABAC loop
+    {
+        if ((alf_slice_param->is_ctb_alf_on) && (sh->alf_on))
+        {
+            XEVE_SBAC *sbac;
+            sbac = GET_SBAC_ENC(bs);
+            XEVE_TRACE_COUNTER;
+            XEVE_TRACE_STR("Usage of ALF: ");
+            xeve_sbac_encode_bin((int)(*(alf_slice_param->alf_ctb_flag + core->lcu_num)), sbac, sbac->ctx.alf_ctb_flag, bs);
+            XEVE_TRACE_INT((int)(*(alf_slice_param->alf_ctb_flag + core->lcu_num)));
+            XEVE_TRACE_STR("\n");
+        }
+        if ((sh->alfChromaMapSignalled) && (sh->alf_on))
+        {
+            XEVE_SBAC *sbac;
+            sbac = GET_SBAC_ENC(bs);
+            xeve_sbac_encode_bin((int)(*(alf_slice_param->alf_ctb_chroma_flag + core->lcu_num)), sbac, sbac->ctx.alf_ctb_flag, bs);
+        }
+        if ((sh->alfChroma2MapSignalled) && (sh->alf_on))
+        {
+            XEVE_SBAC *sbac;
+            sbac = GET_SBAC_ENC(bs);
+            xeve_sbac_encode_bin((int)(*(alf_slice_param->alf_ctb_chroma2_flag + core->lcu_num)), sbac, sbac->ctx.alf_ctb_flag, bs);
+        }
+
+        ret = xeve_eco_tree(ctx, core, core->x_pel, core->y_pel, 0, ctx->max_cuwh, ctx->max_cuwh, 0, 1, NO_SPLIT
+                          , split_mode_child, 0, split_allow, 0, 0, 0, xeve_get_default_tree_cons(), bs);
+        xeve_assert_rv(ret == XEVE_OK, ret);
+        /* prepare next step *********************************************/
+        core->x_lcu++;
+        if (core->x_lcu >= ctx->tile[i].w_ctb + col_bd)
+        {
+            core->x_lcu = (ctx->tile[i].ctba_rs_first) % ctx->w_lcu;
+            core->y_lcu++;
+        }
+
+        xeve_update_core_loc_param(ctx, core);
+        ctb_cnt_in_tile--;
 
+        /* end_of_picture_flag */
+        if (ctb_cnt_in_tile == 0)
+        {
+            xeve_eco_tile_end_flag(bs, 1);
+            xeve_sbac_finish(bs);
+            break;
+        }
+    } //End of LCU encoding loop in a tile
+
+    return XEVE_OK;
+}
+
+/* entropy code tiles of the current slice until no tile is left, each tile
+   is appended to the bitstream buffer of the core.
+   this runs after the mode decision, loop filter and ALF of the whole picture,
+   because every CTU carries ALF CTB flags decided at picture level. it only
+   shortens the serial entropy coding of slices with several tiles, a slice
+   with a single tile is coded on the calling thread as before */
+static int eco_tile_task(void * arg)
+{
+    XEVE_CORE * core = (XEVE_CORE *)arg;
+    XEVE_CTX  * ctx = core->ctx;
+    XEVE_SH   * sh = ctx->sh;
+    XEVE_BSW  * bs = &ctx->bs[core->thread_cnt];
+    XEVE_TILE * tile;
+    u8        * beg;
+    int         left, ret;
+
+    while ((left = threadsafe_decrement(ctx->sync_block, &ctx->tile_left)) >= 0)
+    {
+        tile = &ctx->tile[sh->tile_order[sh->num_tiles_in_slice - 1 - left]];
+        beg = bs->cur;
+
+        ret = eco_tile(ctx, core, bs, sh->tile_order[sh->num_tiles_in_slice - 1 - left]);
+        xeve_assert_rv(ret == XEVE_OK, ret);
+        xeve_bsw_deinit(bs);
+
+        tile->bs_data = beg;
+        tile->bs_size = (int)(bs->cur - beg);
+        tile->bin_cnt = GET_SBAC_ENC(bs)->bin_counter;
+    }
     return XEVE_OK;
 }
 
@@ -302,10 +477,6 @@ int xeve_pic(XEVE_CTX * ctx, XEVE_BITB * bitb, XEVE_STAT * stat)
     XEVE_APS_GEN * aps_dra;
     int            ret;
     u32            i, j;
-    int            split_mode_child[4];
-    int            split_allow[6] = { 0, 0, 0, 0, 0, 1 };
-    int            ctb_cnt_in_tile = 0;
-    int            col_bd = 0;
     int            num_slice_in_pic = ctx->param.num_slice_in_pic;
     u8           * tiles_in_slice;
     u16            total_tiles_in_slice;
@@ -323,6 +494,9 @@ int xeve_pic(XEVE_CTX * ctx, XEVE_BITB * bitb, XEVE_STAT * stat)
         aps_dra = &ctx->aps_gen_array[1];
     }
 
+    /* slices consist of whole tiles and the tiles are coded independently, so
+       the mode decision of all slices runs at once after their headers are set */
+    ctx->md_tile_cnt = 0;
     for (ctx->slice_num = 0; ctx->slice_num < num_slice_in_pic; ctx->slice_num++)
     {
         ctx->sh = &ctx->sh_array[ctx->slice_num];
@@ -423,60 +597,66 @@ int xeve_pic(XEVE_CTX * ctx, XEVE_BITB * bitb, XEVE_STAT * stat)
         core->dqp_curr_best[ctx->log2_max_cuwh - 2][ctx->log2_max_cuwh - 2].curr_qp = ctx->sh->qp;
         core->dqp_curr_best[ctx->log2_max_cuwh - 2][ctx->log2_max_cuwh - 2].prev_qp = ctx->sh->qp;
 
-        /* Tile wise encoding with in a slice */
-        u32 k = 0;
-        total_tiles_in_slice = sh->num_tiles_in_slice;
-        THREAD_CONTROLLER * tc;
-        int res;
-        i = 0;
-        tc = ctx->tc;
-        int parallel_task = 1;
-        int thread_cnt = 0, thread_cnt1 = 0;;
-        int task_completed = 0;
-
-        //Code for CTU parallel encoding
-        while (total_tiles_in_slice)
+        for (i = 0; i < sh->num_tiles_in_slice; i++)
         {
-            parallel_task = (ctx->param.threads > total_tiles_in_slice) ? total_tiles_in_slice : ctx->param.threads;
-            for (thread_cnt = 0; (thread_cnt < parallel_task - 1); thread_cnt++)
-            {
-                i = tiles_in_slice[thread_cnt + task_completed];
+            ctx->tile_to_slice_map[tiles_in_slice[i]] = ctx->slice_num;
+            ctx->md_tile_order[ctx->md_tile_cnt++] = tiles_in_slice[i];
+        }
+    }
 
-                ctx->tile[i].qp = ctx->sh->qp;
-                for (j = 0; j < (u32)ctx->param.threads; j++)
-                {
-                    ctx->tile[i].qp_prev_eco[j] = ctx->sh->qp;
-                }
-                ctx->core[thread_cnt]->tile_idx = i;
-                xevem_init_core_mt(ctx, i, core, thread_cnt);
-                ctx->core[thread_cnt]->thread_cnt = thread_cnt;
-                tc->run(ctx->thread_pool[thread_cnt], tile_mt_core, (void*)ctx->core[thread_cnt]);
-            }
+    /* the slices of a picture only differ in their tiles, the mode decision
+       reads the other fields of the slice header from the first slice */
+    ctx->sh = &ctx->sh_array[0];
+    xeve_mt_deblock_init(ctx);
 
-            i = tiles_in_slice[thread_cnt + task_completed];
-            ctx->tile[i].qp = ctx->sh->qp;
-            ctx->core[thread_cnt]->tile_idx = i;
+    /* Tile wise encoding of all slices */
+    TASK_GROUP grp;
+    int res;
+    int thread_cnt;
 
-            for (j = 0; j < (u32)ctx->param.threads; j++)
-            {
-                ctx->tile[i].qp_prev_eco[j] = ctx->sh->qp;
-            }
-
-            xevem_init_core_mt(ctx, i, core, thread_cnt);
+    task_group_init(&grp);
+    if (ctx->md_tile_cnt <= ctx->param.threads)
+    {
+        //every tile has its own threads coding its CTU rows as a wavefront,
+        //the row tasks of all tiles are submitted at once
+        tile_split_threads(ctx);
+        for (i = 0, thread_cnt = 0; i < (u32)ctx->md_tile_cnt; i++)
+        {
+            tile_init(ctx, ctx->md_tile_order[i], thread_cnt);
+            thread_cnt += ctx->tile[ctx->md_tile_order[i]].parallel_rows;
+        }
+        for (j = 1; j < (u32)thread_cnt; j++)
+        {
+            ret = task_submit(ctx->ts, &grp, ctu_mt_core, (void*)ctx->core[j]);
+            xeve_assert_rv(ret == THREAD_SUCCESS, XEVE_ERR_UNKNOWN);
+        }
+        ret = ctu_mt_core((void*)core);
+    }
+    else
+    {
+        //tile tasks take tiles in order until all tiles of the picture are started
+        ctx->tile_left = ctx->md_tile_cnt;
+        for (thread_cnt = 1; thread_cnt < ctx->param.threads; thread_cnt++)
+        {
+            ctx->core[thread_cnt]->ctx = ctx;
             ctx->core[thread_cnt]->thread_cnt = thread_cnt;
-            tile_mt_core((void*)ctx->core[thread_cnt]);
-            for (thread_cnt1 = 0; thread_cnt1 < parallel_task - 1; thread_cnt1++)
-            {
-                tc->join(ctx->thread_pool[thread_cnt1], &res);
-                if (XEVE_FAILED(res))
-                {
-                    ret = res;
-                }
-            }
-            total_tiles_in_slice -= parallel_task;
-            task_completed += parallel_task;
+            ret = task_submit(ctx->ts, &grp, tile_task, (void*)ctx->core[thread_cnt]);
+            xeve_assert_rv(ret == THREAD_SUCCESS, XEVE_ERR_UNKNOWN);
         }
-    }//End of mode decision
+
+        core->thread_cnt = 0;
+        ret = tile_task((void*)core);
+    }
+    res = task_group_wait(ctx->ts, &grp);
+    xeve_assert_rv(ret == XEVE_OK, ret);
+    xeve_assert_rv(res == XEVE_OK, res);
+    for (i = 0; i < (u32)ctx->md_tile_cnt; i++)
+    {
+        //the mode decision counted the CTUs of the tile down
+        XEVE_TILE * tile = &ctx->tile[ctx->md_tile_order[i]];
+        tile->f_ctb = tile->w_ctb * tile->h_ctb;
+    }
+    //End of mode decision
 
 #if TRACE_START_POC
         if (fp_trace_started == 1)
@@ -504,9 +684,12 @@ int xeve_pic(XEVE_CTX * ctx, XEVE_BITB * bitb, XEVE_STAT * stat)
     core->x_pel = core->y_pel = 0;
     core->lcu_num = 0;
     ctx->lcu_cnt = ctx->f_lcu;
-    for (i = 0; i < ctx->f_scu; i++)
+    if (!ctx->dbk_pipe)
     {
-        MCU_CLR_COD(ctx->map_scu[i]);
+        for (i = 0; i < ctx->f_scu; i++)
+        {
+            MCU_CLR_COD(ctx->map_scu[i]);
+        }
     }
 
     ctx->fn_loop_filter(ctx, core);
@@ -585,102 +768,61 @@ int xeve_pic(XEVE_CTX * ctx, XEVE_BITB * bitb, XEVE_STAT * stat)
         xeve_stat_set_enc_state(FALSE);
 #endif
         /* Tile level encoding for a slice */
-        /* Tile wise encoding with in a slice */
-        int k = 0;
+        int k, parallel_task, thread_cnt;
         total_tiles_in_slice = sh->num_tiles_in_slice;
-        while (total_tiles_in_slice)
+        parallel_task = XEVE_MIN(ctx->param.threads - 1, total_tiles_in_slice);
+#if ENC_DEC_TRACE
+        parallel_task = 1; /* keep the trace in coding order */
+#endif
+        if (parallel_task > 1)
         {
-            int i = tiles_in_slice[k++];
-            ctx->tile[i].qp = ctx->sh->qp;
-            ctx->tile[i].qp_prev_eco[core->thread_cnt] = ctx->sh->qp;
-            core->tile_idx = i;
-
-            /* CABAC Initialize for each Tile */
-            ctx->fn_eco_sbac_reset(GET_SBAC_ENC(bs), ctx->sh->slice_type, ctx->sh->qp, ctx->sps.tool_cm_init);
-
-            /*Set entry point for each Tile in the tile Slice*/
-            core->x_lcu = (ctx->tile[i].ctba_rs_first) % ctx->w_lcu; //entry point lcu's x location
-            core->y_lcu = (ctx->tile[i].ctba_rs_first) / ctx->w_lcu; // entry point lcu's y location
-            ctb_cnt_in_tile = ctx->tile[i].f_ctb; //Total LCUs in the current tile
-            xeve_update_core_loc_param(ctx, core);
-
-            XEVE_BSW bs_beg;
-            bs_beg.cur = bs->cur;
-            bs_beg.leftbits = bs->leftbits;
-
-            col_bd = 0;
-            if (i% ctx->param.tile_columns)
+            /* tiles are coded to the bitstream buffers of the worker cores
+               and copied to the slice data in tile order. entropy coding does
+               not overlap the mode decision, see eco_tile_task() */
+            TASK_GROUP grp;
+            int res;
+
+            ctx->tile_left = total_tiles_in_slice;
+            task_group_init(&grp);
+            for (thread_cnt = 1; thread_cnt <= parallel_task; thread_cnt++)
             {
-                int temp = i - 1;
-                while (temp >= 0)
-                {
-                    col_bd += ctx->tile[temp].w_ctb;
-                    if (!(temp%ctx->param.tile_columns)) break;
-                    temp--;
-                }
+                xeve_bsw_init(&ctx->bs[thread_cnt], ctx->bs[thread_cnt].beg, ctx->bs[thread_cnt].size, NULL);
+                ctx->core[thread_cnt]->ctx = ctx;
+                ctx->core[thread_cnt]->thread_cnt = thread_cnt;
+                ret = task_submit(ctx->ts, &grp, eco_tile_task, (void*)ctx->core[thread_cnt]);
+                xeve_assert_rv(ret == THREAD_SUCCESS, XEVE_ERR_UNKNOWN);
             }
-            else
+            res = task_group_wait(ctx->ts, &grp);
+            xeve_assert_rv(res == XEVE_OK, res);
+
+            for (k = 0; k < total_tiles_in_slice; k++)
             {
-                col_bd = 0;
-            }
+                XEVE_TILE * tile = &ctx->tile[tiles_in_slice[k]];
 
-            while (1) // LCU level CABAC loop
+                ret = xeve_bsw_write_bytes(bs, tile->bs_data, tile->bs_size);
+                xeve_assert_rv(ret == 0, XEVE_ERR_UNKNOWN);
+                bin_counts_in_units += tile->bin_cnt;
+                sh->entry_point_offset_minus1[k] = tile->bs_size - 1;
+            }
+        }
+        else
+        {
+            for (k = 0; k < total_tiles_in_slice; k++)
             {
-                XEVE_ALF_SLICE_PARAM * alf_slice_param = &(ctx->sh->alf_sh_param);
-                if ((alf_slice_param->is_ctb_alf_on) && (sh->alf_on))
-                {
-                    XEVE_SBAC *sbac;
-                    sbac = GET_SBAC_ENC(bs);
-                    XEVE_TRACE_COUNTER;
-                    XEVE_TRACE_STR("Usage of ALF: ");
-                    xeve_sbac_encode_bin((int)(*(alf_slice_param->alf_ctb_flag + core->lcu_num)), sbac, sbac->ctx.alf_ctb_flag, bs);
-                    XEVE_TRACE_INT((int)(*(alf_slice_param->alf_ctb_flag + core->lcu_num)));
-                    XEVE_TRACE_STR("\n");
-                }
-                if ((ctx->sh->alfChromaMapSignalled) && (ctx->sh->alf_on))
-                {
-                    XEVE_SBAC *sbac;
-                    sbac = GET_SBAC_ENC(bs);
-                    xeve_sbac_encode_bin((int)(*(alf_slice_param->alf_ctb_chroma_flag + core->lcu_num)), sbac, sbac->ctx.alf_ctb_flag, bs);
-                }
-                if ((ctx->sh->alfChroma2MapSignalled) && (ctx->sh->alf_on))
-                {
-                    XEVE_SBAC *sbac;
-                    sbac = GET_SBAC_ENC(bs);
-                    xeve_sbac_encode_bin((int)(*(alf_slice_param->alf_ctb_chroma2_flag + core->lcu_num)), sbac, sbac->ctx.alf_ctb_flag, bs);
-                }
+                XEVE_BSW bs_beg;
+                bs_beg.cur = bs->cur;
+                bs_beg.leftbits = bs->leftbits;
 
-                ret = xeve_eco_tree(ctx, core, core->x_pel, core->y_pel, 0, ctx->max_cuwh, ctx->max_cuwh, 0, 1, NO_SPLIT
-                                      , split_mode_child, 0, split_allow, 0, 0, 0, xeve_get_default_tree_cons(), bs);
+                ret = eco_tile(ctx, core, bs, tiles_in_slice[k]);
                 xeve_assert_rv(ret == XEVE_OK, ret);
-                /* prepare next step *********************************************/
-                core->x_lcu++;
-                if (core->x_lcu >= ctx->tile[i].w_ctb + col_bd)
-                {
-                    core->x_lcu = (ctx->tile[i].ctba_rs_first) % ctx->w_lcu;
-                    core->y_lcu++;
-                }
 
-                xeve_update_core_loc_param(ctx, core);
-                ctb_cnt_in_tile--;
-                ctx->lcu_cnt--; //To be updated properly in case of multicore
+                XEVE_SBAC* tmp_sbac;
+                tmp_sbac = GET_SBAC_ENC(bs);
+                bin_counts_in_units += tmp_sbac->bin_counter;
 
-                /* end_of_picture_flag */
-                if (ctb_cnt_in_tile == 0)
-                {
-                    xeve_eco_tile_end_flag(bs, 1);
-                    xeve_sbac_finish(bs);
-                    break;
-                }
-            } //End of LCU encoding loop in a tile
-
-            XEVE_SBAC* tmp_sbac;
-            tmp_sbac = GET_SBAC_ENC(bs);
-            bin_counts_in_units += tmp_sbac->bin_counter;
-            total_tiles_in_slice--;
-
-            sh->entry_point_offset_minus1[k - 1] = (u32)((bs)->cur - bs_beg.cur - 4 + (4 - (bs->leftbits >> 3)) + (bs_beg.leftbits >> 3) - 1);
-        } // End to tile encoding loop in a slice
+                sh->entry_point_offset_minus1[k] = (u32)((bs)->cur - bs_beg.cur - 4 + (4 - (bs->leftbits >> 3)) + (bs_beg.leftbits >> 3) - 1);
+            }
+        }
 
         num_bytes_in_units = (int)(bs->cur - cur_tmp) - 4;
 
@@ -724,6 +866,8 @@ int xeve_pic(XEVE_CTX * ctx, XEVE_BITB * bitb, XEVE_STAT * stat)
 #endif
         /* Bit-stream writing (END) */
 
+        ret = xeve_nalu_out(ctx, 0);
+        xeve_assert_rv(ret == XEVE_OK, ret);
     }  // End of slice loop
     return XEVE_OK;
 }
@@ -783,6 +927,7 @@ XEVE xeve_create(XEVE_CDSC * cdsc, int * err)
 ERR:
     if(ctx)
     {
+        xeve_delete_bs_buf(ctx);
         if (cdsc->param.profile)
         {
             xevem_platform_deinit(ctx);
@@ -791,7 +936,6 @@ ERR:
         {
             xeve_platform_deinit(ctx);
         }
-        xeve_delete_bs_buf(ctx);
         xeve_ctx_free(ctx);
     }
     if(err) *err = ret;
@@ -816,6 +960,8 @@ void xeve_delete(XEVE id)
         ctx->fn_flush(ctx);
     }
 
+    xeve_delete_bs_buf(ctx);
+
     if (ctx->param.profile)
     {
         xevem_platform_deinit(ctx);
@@ -825,13 +971,13 @@ void xeve_delete(XEVE id)
         xeve_platform_deinit(ctx);
     }
 
-    xeve_delete_bs_buf(ctx);
     xeve_ctx_free(ctx);
 }
 
 int xeve_encode(XEVE id, XEVE_BITB * bitb, XEVE_STAT * stat)
 {
     XEVE_CTX * ctx;
+    int        ret;
 
     XEVE_ID_TO_CTX_RV(id, ctx, XEVE_ERR_INVALID_ARGUMENT);
     xeve_assert_rv(ctx->fn_enc, XEVE_ERR_UNEXPECTED);
@@ -845,7 +991,8 @@ int xeve_encode(XEVE id, XEVE_BITB * bitb, XEVE_STAT * stat)
     {
         if (ctx->param.use_fcst)
         {
-            xeve_forecast_fixed_gop(ctx);
+            ret = xeve_forecast_submit(ctx, ctx->pico);
+            xeve_assert_rv(ret == XEVE_OK, ret);
         }
     }
     /* store input picture and return if needed */
@@ -853,6 +1000,13 @@ int xeve_encode(XEVE id, XEVE_BITB * bitb, XEVE_STAT * stat)
     {
         return XEVE_OK_OUT_NOT_AVAILABLE;
     }
+    /* forecast results of the pictures to be encoded */
+    ret = xeve_forecast_sync(ctx);
+    xeve_assert_rv(ret == XEVE_OK, ret);
+    if (ctx->param.rc_pass_fast)
+    {
+        return xeve_rc_fast_pass(ctx);
+    }
 
     /* update BSB */
     bitb->err = 0;
@@ -889,6 +1043,11 @@ int xeve_config(XEVE id, int cfg, void * buf, int * size)
             ctx->pic_ticnt = ctx->pic_icnt;
             break;
 
+        case XEVE_CFG_SET_NALU_OUT:
+            xeve_assert_rv(*size == sizeof(XEVE_NALU_OUT), XEVE_ERR_INVALID_ARGUMENT);
+            xeve_mcpy(&ctx->nalu_out, buf, sizeof(XEVE_NALU_OUT));
+            break;
+
         case XEVE_CFG_SET_FINTRA:
             xeve_assert_rv(*size == sizeof(int), XEVE_ERR_INVALID_ARGUMENT);
             t0 = *((int *)buf);
@@ -1028,6 +1187,10 @@ int xeve_config(XEVE id, int cfg, void * buf, int * size)
             xeve_assert_rv(*size == sizeof(int), XEVE_ERR_INVALID_ARGUMENT);
             *((int *)buf) = XEVE_PROFILE_MAIN;
             break;
+        case XEVE_CFG_GET_SYNC_WAIT_TIME:
+            return xeve_get_sync_wait_time(ctx, (long long *)buf, size);
+        case XEVE_CFG_GET_ROW_TIME:
+            return xeve_get_row_time(ctx, (long long *)buf, size);
         case XEVE_CFG_GET_BPS:
             xeve_assert_rv(*size == sizeof(int), XEVE_ERR_INVALID_ARGUMENT);
             if (ctx->rc != NULL)
@@ -35,6 +35,11 @@
 
 #include "xevem_alf.h"
 
+XEVEM_ALF_CLASSIFY_BLK xevem_func_alf_derive_classification_blk;
+XEVEM_ALF_FILTER_BLK   xevem_func_alf_filter_5x5_blk;
+XEVEM_ALF_FILTER_BLK   xevem_func_alf_filter_7x7_blk;
+XEVEM_ALF_BLK_STATS    xevem_func_alf_get_blk_stats;
+
 void alf_init(ADAPTIVE_LOOP_FILTER * alf, int bit_depth)
 {
     alf->clip_ranges.comp[0] = (CLIP_RANGE) { .min = 0, .max = (1 << bit_depth) - 1, .bd = bit_depth, .n = 0 };
@@ -48,9 +53,9 @@ void alf_init(ADAPTIVE_LOOP_FILTER * alf, int bit_depth)
         alf->ctu_enable_flag[compIdx] = NULL;
     }
 
-    alf->derive_classification_blk = alf_derive_classification_blk;
-    alf->filter_5x5_blk = alf_filter_blk_5;
-    alf->filter_7x7_blk = alf_filter_blk_7;
+    alf->derive_classification_blk = xevem_func_alf_derive_classification_blk;
+    alf->filter_5x5_blk = xevem_func_alf_filter_5x5_blk;
+    alf->filter_7x7_blk = xevem_func_alf_filter_7x7_blk;
 }
 
 void alf_init_filter_shape(ALF_FILTER_SHAPE* filter_shape, int size)
@@ -378,7 +383,7 @@ void alf_recon_coef(ADAPTIVE_LOOP_FILTER * alf, ALF_SLICE_PARAM* alf_slice_param
     }
 }
 
-int alf_create(ADAPTIVE_LOOP_FILTER * alf, const int pic_width, const int pic_height, const int max_cu_width, const int max_cu_height, const int max_cu_depth,  const int chroma_format_idc, int bit_depth)
+int alf_create(ADAPTIVE_LOOP_FILTER * alf, const int pic_width, const int pic_height, const int max_cu_width, const int max_cu_height, const int max_cu_depth,  const int chroma_format_idc, int bit_depth, int num_threads)
 {
     int ret;
 
@@ -402,6 +407,7 @@ int alf_create(ADAPTIVE_LOOP_FILTER * alf, const int pic_width, const int pic_he
     alf->max_cu_width = max_cu_width;
     alf->max_cu_height = max_cu_height;
     alf->max_cu_depth = max_cu_depth;
+    alf->num_threads = num_threads;
     alf->chroma_format = chroma_format_idc;
 
     alf->num_ctu_in_widht = (alf->pic_width / alf->max_cu_width) + ((alf->pic_width % alf->max_cu_width) ? 1 : 0);
@@ -418,10 +424,10 @@ int alf_create(ADAPTIVE_LOOP_FILTER * alf, const int pic_width, const int pic_he
     alf->temp_buf1 = (pel*)malloc(((pic_width >> 1) + (7 * alf->num_ctu_in_widht))*((pic_height >> 1) + (7 * alf->num_ctu_in_height)) * sizeof(pel)); // for chroma just left for unification
     alf->temp_buf2 = (pel*)malloc(((pic_width >> 1) + (7 * alf->num_ctu_in_widht))*((pic_height >> 1) + (7 * alf->num_ctu_in_height)) * sizeof(pel));
     }
-    alf->classifier_mt = (ALF_CLASSIFIER**)malloc(MAX_CU_SIZE * XEVE_MAX_THREADS * sizeof(ALF_CLASSIFIER*));
+    alf->classifier_mt = (ALF_CLASSIFIER**)malloc(MAX_CU_SIZE * alf->num_threads * sizeof(ALF_CLASSIFIER*));
     if (alf->classifier_mt)
     {
-        for (int i = 0; i < MAX_CU_SIZE * XEVE_MAX_THREADS; i++)
+        for (int i = 0; i < MAX_CU_SIZE * alf->num_threads; i++)
         {
             alf->classifier_mt[i] = (ALF_CLASSIFIER*)malloc(MAX_CU_SIZE * sizeof(ALF_CLASSIFIER));
             xeve_mset(alf->classifier_mt[i], 0, MAX_CU_SIZE * sizeof(ALF_CLASSIFIER));
@@ -459,7 +465,7 @@ void alf_destroy(ADAPTIVE_LOOP_FILTER * alf)
     }
     if (alf->classifier_mt)
     {
-        for (int i = 0; i < MAX_CU_SIZE * XEVE_MAX_THREADS; i++)
+        for (int i = 0; i < MAX_CU_SIZE * alf->num_threads; i++)
         {
             free(alf->classifier_mt[i]);
             alf->classifier_mt[i] = NULL;
@@ -482,24 +488,19 @@ void alf_derive_classification(ADAPTIVE_LOOP_FILTER * alf, ALF_CLASSIFIER** clas
         {
             int w = XEVE_MIN(j + CLASSIFICATION_BLK_SIZE, width) - j;
             AREA area = { j, i, w, h };
-            alf_derive_classification_blk(classifier, src_luma, src_luma_stride, &area, alf->input_bit_depth[LUMA_CH] + 4, alf->input_bit_depth[LUMA_CH]);
+            alf->derive_classification_blk(classifier, src_luma, src_luma_stride, &area, alf->input_bit_depth[LUMA_CH] + 4, alf->input_bit_depth[LUMA_CH]);
         }
     }
 }
 
 void alf_derive_classification_blk(ALF_CLASSIFIER ** classifier, const pel * src_luma, const int src_stride,  const AREA * blk, const int shift, int bit_depth)
 {
-    static const int th[16] = { 0, 1, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3, 4 };
     const int stride = src_stride;
     const pel * src = src_luma;
-    const int max_act = 15;
-
     int fl = 2;
     int flP1 = fl + 1;
     int fl2 = 2 * fl;
 
-    int main_dir, sec_dir, dir_temp_hv, dir_temp_d;
-
     int pix_y;
     int height = blk->height + fl2;
     int width = blk->width + fl2;
@@ -553,6 +554,20 @@ void alf_derive_classification_blk(ALF_CLASSIFIER ** classifier, const pel * src
         }
     }
 
+    alf_derive_classification_lap(classifier, laplacian, blk, bit_depth);
+}
+
+/* derive the class of each 4x4 block from the laplacian sums of its 8x8
+   window, laplacian[dir][i][j] holds the sum of four 2x2 positions of
+   row pair i starting at column j */
+void alf_derive_classification_lap(ALF_CLASSIFIER ** classifier, int laplacian[NUM_DIRECTIONS][CLASSIFICATION_BLK_SIZE + 5][CLASSIFICATION_BLK_SIZE + 5], const AREA * blk, int bit_depth)
+{
+    static const int th[16] = { 0, 1, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3, 4 };
+    const int max_act = 15;
+    const int pos_x = blk->x;
+    const int pos_y = blk->y;
+    int main_dir, sec_dir, dir_temp_hv, dir_temp_d;
+
     // classification block size
     const int cls_size_y = 4;
     const int cls_size_x = 4;
@@ -1338,7 +1353,7 @@ void AlfSliceParam_reset(ADAPTIVE_LOOP_FILTER * alf, ALF_SLICE_PARAM* alf_param)
     alf_param->max_idr_poc = INT_MAX;  // Max of 2 IDR POC available for current coded nalu  (to identify availability of this filter for temp prediction)
 }
 
-int xeve_alf_create(XEVE_ALF * enc_alf, const int pic_widht, const int pic_height, const int max_cu_width, const int max_cu_height, const int max_cu_depth, const int chroma_format_idc, int bit_depth)
+int xeve_alf_create(XEVE_ALF * enc_alf, const int pic_widht, const int pic_height, const int max_cu_width, const int max_cu_height, const int max_cu_depth, const int chroma_format_idc, int bit_depth, int num_threads)
 {
     int ret;
     ADAPTIVE_LOOP_FILTER * alf = &enc_alf->alf;
@@ -1358,7 +1373,7 @@ int xeve_alf_create(XEVE_ALF * enc_alf, const int pic_widht, const int pic_heigh
     enc_alf->filter_coef_set = NULL;
     enc_alf->dif_filter_coef = NULL;
 
-    alf_create(alf, pic_widht, pic_height, max_cu_width, max_cu_height, max_cu_depth, chroma_format_idc, bit_depth);
+    alf_create(alf, pic_widht, pic_height, max_cu_width, max_cu_height, max_cu_depth, chroma_format_idc, bit_depth, num_threads);
     for (u8 comp_id = 0; comp_id < N_C; comp_id++)
     {
         u8 ch_type = comp_id == Y_C ? LUMA_CH : CHROMA_CH;
@@ -3760,7 +3775,7 @@ void xeve_alf_derive_stats_filtering(XEVE_ALF * enc_alf, YUV * org_yuv, YUV * re
 
                 for (int shape = 0; shape != size; shape++)
                 {
-                    xeve_alf_get_blk_stats((int)ch_type, enc_alf->alf_cov[comp_id][shape][ctu_rs_addr], &alf->filter_shapes[ch_type][shape]
+                    xevem_func_alf_get_blk_stats((int)ch_type, enc_alf->alf_cov[comp_id][shape][ctu_rs_addr], &alf->filter_shapes[ch_type][shape]
                               , comp_id ? NULL : alf->classifier, org, org_stride, rec, rec_stride, x_pos2, y_pos2, width2, height2);
 
                     const int num_classes = comp_id == Y_C ? MAX_NUM_ALF_CLASSES : 1;
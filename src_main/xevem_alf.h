@@ -250,6 +250,7 @@ struct _ADAPTIVE_LOOP_FILTER
     int                 num_ctu_in_pic;
     ALF_CLASSIFIER   ** classifier;
     ALF_CLASSIFIER   ** classifier_mt;
+    int                 num_threads;
     int                 chroma_format;
     int                 last_ras_poc;
     BOOL                pending_ras_init;
@@ -264,7 +265,7 @@ struct _ADAPTIVE_LOOP_FILTER
     void              (* filter_7x7_blk)( ALF_CLASSIFIER** classifier, pel * rec_dst, const int dst_stride, const pel * rec_src, const int src_stride, const AREA* blk, const u8 comp_id, short* filter_set, const CLIP_RANGE* clip_range );
 };
 
-int alf_create(ADAPTIVE_LOOP_FILTER * alf, const int pic_width, const int pic_height, const int max_cu_width, const int max_cu_height, const int max_cu_depth, const int chroma_format_idc, int bit_depth);
+int alf_create(ADAPTIVE_LOOP_FILTER * alf, const int pic_width, const int pic_height, const int max_cu_width, const int max_cu_height, const int max_cu_depth, const int chroma_format_idc, int bit_depth, int num_threads);
 void alf_destroy(ADAPTIVE_LOOP_FILTER * alf);
 void alf_init(ADAPTIVE_LOOP_FILTER * alf, int bit_depth);
 void alf_copy_and_extend_tile(pel* tmp_yuv, const int s, const pel* rec_yuv, const int s2, const int w, const int h, const int m);
@@ -283,6 +284,7 @@ void alf_reset_idr_idx_list_buf_aps(ADAPTIVE_LOOP_FILTER * alf);
 int  alf_get_protect_idx_from_list(ADAPTIVE_LOOP_FILTER * alf, int idx);
 void alf_store_enc_alf_param_line_aps(ADAPTIVE_LOOP_FILTER * alf, ALF_SLICE_PARAM* pAlfParam, unsigned t_layer);
 void alf_derive_classification_blk(ALF_CLASSIFIER** classifier, const pel * src_luma, const int src_stride, const AREA * blk, const int shift, int bit_depth);
+void alf_derive_classification_lap(ALF_CLASSIFIER** classifier, int laplacian[NUM_DIRECTIONS][CLASSIFICATION_BLK_SIZE + 5][CLASSIFICATION_BLK_SIZE + 5], const AREA * blk, int bit_depth);
 void alf_filter_blk_7(ALF_CLASSIFIER** classifier, pel * rec_dst, const int dst_stride, const pel * rec_src, const int src_stride, const AREA* blk, const u8 comp_id, short* filter_set, const CLIP_RANGE* clip_range);
 void alf_filter_blk_5(ALF_CLASSIFIER** classifier, pel * rec_dst, const int dst_stride, const pel * rec_src, const int src_stride, const AREA* blk, const u8 comp_id, short* filter_set, const CLIP_RANGE* clip_range);
 
@@ -338,7 +340,7 @@ void       xeve_alf_delete_buf(XEVE_ALF * enc_alf);
 void       xeve_alf_set_reset_alf_buf_flag(XEVE_ALF * enc_anf, int flag);
 u8         xeve_alf_aps_get_current_alf_idx(XEVE_ALF * enc_anf);
 void       xeve_alf_aps_enc_opt_process(XEVE_ALF * enc_anf, const double* lambdas, XEVE_CTX * ctx, XEVE_PIC * pic, XEVE_ALF_SLICE_PARAM * input_alf_slice_param);
-int        xeve_alf_create(XEVE_ALF * enc_alf, const int pic_width, const int pic_height, const int max_cu_width, const int max_cu_height, const int max_cu_depth, const int chroma_format_idc, int bit_depth);
+int        xeve_alf_create(XEVE_ALF * enc_alf, const int pic_width, const int pic_height, const int max_cu_width, const int max_cu_height, const int max_cu_depth, const int chroma_format_idc, int bit_depth, int num_threads);
 void       xeve_alf_destroy(XEVE_ALF * enc_alf);
 void       xeve_alf_process(XEVE_ALF * enc_alf, CODING_STRUCTURE * cs, const double *lambdas, ALF_SLICE_PARAM* alf_slice_param);
 double     xeve_alf_derive_ctb_enable_flags(XEVE_ALF * enc_alf, CODING_STRUCTURE * cs, const int input_shape_idx, u8 channel, const int num_classes, const int num_coef, double* dist_unfilter, BOOL rec_coef);
@@ -377,6 +379,15 @@ void       xeve_alf_get_frame_stat(XEVE_ALF * enc_alf, ALF_COVARIANCE* frame_cov
 void       xeve_alf_derive_stats_filtering(XEVE_ALF * enc_alf, YUV * orgYuv, YUV * rec);
 void       xeve_alf_get_blk_stats(int ch, ALF_COVARIANCE* alf_cov, const ALF_FILTER_SHAPE* shape, ALF_CLASSIFIER** classifier, pel* org, const int org_stride, pel* rec, const int rec_stride, const int x, const int y, const int width, const int height);
 void       xeve_alf_clac_covariance(int *ELocal, const pel *rec, const int stride, const int *filter_pattern, const int half_filter_length, const int trans_idx);
+
+typedef void (*XEVEM_ALF_CLASSIFY_BLK)(ALF_CLASSIFIER** classifier, const pel * src_luma, const int src_stride, const AREA * blk, const int shift, int bit_depth);
+typedef void (*XEVEM_ALF_FILTER_BLK)(ALF_CLASSIFIER** classifier, pel * rec_dst, const int dst_stride, const pel * rec_src, const int src_stride, const AREA* blk, const u8 comp_id, short* filter_set, const CLIP_RANGE* clip_range);
+typedef void (*XEVEM_ALF_BLK_STATS)(int ch, ALF_COVARIANCE* alf_cov, const ALF_FILTER_SHAPE* shape, ALF_CLASSIFIER** classifier, pel* org, const int org_stride, pel* rec, const int rec_stride, const int x, const int y, const int width, const int height);
+
+extern XEVEM_ALF_CLASSIFY_BLK xevem_func_alf_derive_classification_blk;
+extern XEVEM_ALF_FILTER_BLK   xevem_func_alf_filter_5x5_blk;
+extern XEVEM_ALF_FILTER_BLK   xevem_func_alf_filter_7x7_blk;
+extern XEVEM_ALF_BLK_STATS    xevem_func_alf_get_blk_stats;
 double     xeve_alf_clac_err(ALF_COVARIANCE* cov);
 void       xeve_alf_set_enable_flag(ALF_SLICE_PARAM* alf_slice_param, u8 comp_id, BOOL val);
 void       xeve_alf_set_enable_ctb_flag(XEVE_ALF * enc_alf, ALF_SLICE_PARAM* alf_slice_param, u8 comp_id, u8** ctu_flags);
@@ -388,4 +399,7 @@ void       xeve_alf_gns_transpose_back_substitution(double U[MAX_NUM_ALF_COEFF][
 void       xeve_alf_gns_back_substitution(double R[MAX_NUM_ALF_COEFF][MAX_NUM_ALF_COEFF], double* z, int size, double* A);
 int        xeve_alf_gns_solve_chol(double **LHS, double *rhs, double *x, int num_eq);
 void       tile_boundary_check(int* avail_left, int* avail_right, int* avail_top, int* avail_bottom, const int width, const int height, int x_pos, int y_pos, int x_l, int x_r, int y_l, int y_r);
+
+#include "xevem_alf_sse.h"
+#include "xevem_alf_avx.h"
 #endif
@@ -503,43 +503,57 @@ static void deblock_scu_line_chroma(pel *buf, int stride, u8 bs, u16 alpha, u8 b
 #endif
 }
 
-static void deblock_scu_addb_ver_luma(pel *buf, int stride, u8 bs, u16 alpha, u8 beta, u8 c1, int bit_depth_minus8)
+XEVEM_DBK_ADDB xevem_func_dbk_addb_luma_hor;
+XEVEM_DBK_ADDB xevem_func_dbk_addb_luma_ver;
+XEVEM_DBK_ADDB xevem_func_dbk_addb_chroma_hor;
+XEVEM_DBK_ADDB xevem_func_dbk_addb_chroma_ver;
+
+void xevem_dbk_addb_luma_hor(pel *buf, int stride, const XEVEM_DBK_PRM *prm, int len, int bit_depth)
 {
-    u8 i;
-    pel *cur_buf = buf;
-    for(i = 0; i < MIN_CU_SIZE; ++i, cur_buf += stride)
+    int i;
+    for(i = 0; i < len; ++i)
     {
-        deblock_scu_line_luma(cur_buf, 1, bs, alpha, beta, c1, bit_depth_minus8);
+        deblock_scu_line_luma(buf + i, stride, (u8)prm[i].bs, (u16)prm[i].alpha, (u8)prm[i].beta, (u8)prm[i].c, bit_depth - 8);
     }
 }
 
-static void deblock_scu_addb_hor_luma(pel *buf, int stride, u8 bs, u16 alpha, u8 beta, u8 c1, int bit_depth_minus8)
+void xevem_dbk_addb_luma_ver(pel *buf, int stride, const XEVEM_DBK_PRM *prm, int len, int bit_depth)
 {
-    u8 i;
-    pel *cur_buf = buf;
-    for(i = 0; i < MIN_CU_SIZE; ++i, ++cur_buf)
+    int i;
+    for(i = 0; i < len; ++i)
     {
-        deblock_scu_line_luma(cur_buf, stride, bs, alpha, beta, c1, bit_depth_minus8);
+        deblock_scu_line_luma(buf + i * stride, 1, (u8)prm[i].bs, (u16)prm[i].alpha, (u8)prm[i].beta, (u8)prm[i].c, bit_depth - 8);
     }
 }
 
-static void deblock_scu_addb_ver_chroma(pel *buf, int stride, u8 bs, u16 alpha, u8 beta, u8 c0, int bit_depth_minus8)
+void xevem_dbk_addb_chroma_hor(pel *buf, int stride, const XEVEM_DBK_PRM *prm, int len, int bit_depth)
 {
-    u8 i;
-    pel *cur_buf = buf;
-    for(i = 0; i < (MIN_CU_SIZE >> 1); ++i, cur_buf += stride)
+    int i;
+    for(i = 0; i < len; ++i)
     {
-        deblock_scu_line_chroma(cur_buf, 1, bs, alpha, beta, c0, bit_depth_minus8);
+        deblock_scu_line_chroma(buf + i, stride, (u8)prm[i].bs, (u16)prm[i].alpha, (u8)prm[i].beta, (u8)prm[i].c, bit_depth - 8);
     }
 }
 
-static void deblock_scu_addb_hor_chroma(pel *buf, int stride, u8 bs, u16 alpha, u8 beta, u8 c0, int bit_depth_minus8)
+void xevem_dbk_addb_chroma_ver(pel *buf, int stride, const XEVEM_DBK_PRM *prm, int len, int bit_depth)
 {
-    u8 i;
-    pel *cur_buf = buf;
-    for(i = 0; i < (MIN_CU_SIZE >> 1); ++i, ++cur_buf)
+    int i;
+    for(i = 0; i < len; ++i)
     {
-        deblock_scu_line_chroma(cur_buf, stride, bs, alpha, beta, c0, bit_depth_minus8);
+        deblock_scu_line_chroma(buf + i * stride, 1, (u8)prm[i].bs, (u16)prm[i].alpha, (u8)prm[i].beta, (u8)prm[i].c, bit_depth - 8);
+    }
+}
+
+/* fill size lines of an edge starting at pos, only the first lines of them are filtered */
+static void deblock_addb_set_prm(XEVEM_DBK_PRM *prm, int pos, int size, int lines, u8 bs, u16 alpha, u8 beta, u8 c)
+{
+    int i;
+    for(i = 0; i < size; ++i)
+    {
+        prm[pos + i].bs = i < lines ? bs : DBF_ADDB_BS_OTHERS;
+        prm[pos + i].alpha = alpha;
+        prm[pos + i].beta = beta;
+        prm[pos + i].c = c;
     }
 }
 
@@ -606,7 +620,11 @@ static void deblock_addb_cu_hor(XEVE_PIC *pic, int x_pel, int y_pel, int cuw, in
 
     if(align_8_8_grid  && y_pel > 0 && (no_boundary))
     {
+        XEVEM_DBK_PRM prm_l[MAX_CU_SIZE], prm_c[2][MAX_CU_SIZE];
+        int size_c = MIN_CU_SIZE >> w_shift;
 
+        /* parameters of the whole edge are gathered first so that the
+           filter kernels can work on several SCUs at once */
         for(i = 0; i < (cuw >> MIN_CU_LOG2); ++i)
         {
 #if TRACE_DBF
@@ -641,13 +659,10 @@ static void deblock_addb_cu_hor(XEVE_PIC *pic, int x_pel, int y_pel, int cuw, in
             beta = xevem_addb_beta_tbl[indexB] << bitdepth_scale;
             c1 = xevem_addb_clip_tbl[indexA][bs_cur] << XEVE_MAX(0, (bit_depth_luma - 9));
 
-            if(xeve_check_luma(tree_cons))
-            {
-                deblock_scu_addb_hor_luma(y + t, s_l, bs_cur, alpha, beta, c1, bit_depth_luma - 8);
-            }
+            deblock_addb_set_prm(prm_l, t, MIN_CU_SIZE, MIN_CU_SIZE, bs_cur, alpha, beta, c1);
+
             if(xeve_check_chroma(tree_cons) && chroma_format_idc)
             {
-                t >>= w_shift;
                 int qp_u = XEVE_CLIP3(-6 * (bit_depth_chroma - 8), 57, qp + pic->pic_qp_u_offset);
                 indexA = get_index(qp_chroma_dynamic[0][qp_u], pic->pic_deblock_alpha_offset);
                 indexB = get_index(qp_chroma_dynamic[0][qp_u], pic->pic_deblock_beta_offset);
@@ -656,7 +671,7 @@ static void deblock_addb_cu_hor(XEVE_PIC *pic, int x_pel, int y_pel, int cuw, in
                 c1 = xevem_addb_clip_tbl[indexA][bs_cur];
                 c0 = (c1 + 1) << XEVE_MAX(0, (bit_depth_chroma - 9));
 
-                deblock_scu_addb_hor_chroma(u + t, s_c, bs_cur, alpha, beta, c0, bit_depth_chroma - 8);
+                deblock_addb_set_prm(prm_c[0], i * size_c, size_c, MIN_CU_SIZE >> 1, bs_cur, alpha, beta, c0);
 
                 int qp_v = XEVE_CLIP3(-6 * (bit_depth_chroma - 8), 57, qp + pic->pic_qp_v_offset);
                 indexA = get_index(qp_chroma_dynamic[1][qp_v], pic->pic_deblock_alpha_offset);
@@ -665,9 +680,20 @@ static void deblock_addb_cu_hor(XEVE_PIC *pic, int x_pel, int y_pel, int cuw, in
                 beta = xevem_addb_beta_tbl[indexB] << bitdepth_scale;
                 c1 = xevem_addb_clip_tbl[indexA][bs_cur];
                 c0 = (c1 + 1) << XEVE_MAX(0, (bit_depth_chroma - 9));
-                deblock_scu_addb_hor_chroma(v + t, s_c, bs_cur, alpha, beta, c0, bit_depth_chroma - 8);
+
+                deblock_addb_set_prm(prm_c[1], i * size_c, size_c, MIN_CU_SIZE >> 1, bs_cur, alpha, beta, c0);
             }
         }
+
+        if(xeve_check_luma(tree_cons))
+        {
+            xevem_func_dbk_addb_luma_hor(y, s_l, prm_l, cuw, bit_depth_luma);
+        }
+        if(xeve_check_chroma(tree_cons) && chroma_format_idc)
+        {
+            xevem_func_dbk_addb_chroma_hor(u, s_c, prm_c[0], w * size_c, bit_depth_chroma);
+            xevem_func_dbk_addb_chroma_hor(v, s_c, prm_c[1], w * size_c, bit_depth_chroma);
+        }
     }
 
     map_scu = deblock_set_coded_block(map_scu_tmp, w, h, w_scu);
@@ -683,6 +709,8 @@ static void deblock_addb_cu_ver_yuv(XEVE_PIC *pic, int x_pel, int y_pel, int log
     u8 beta;
     u8 c0, c1;
     const int bitdepth_scale = (bit_depth_luma - 8);
+    int size_c = MIN_CU_SIZE >> XEVE_GET_CHROMA_W_SHIFT(chroma_format_idc);
+    XEVEM_DBK_PRM prm_l[MAX_CU_SIZE], prm_c[2][MAX_CU_SIZE];
 
     for(i = 0; i < h; i++)
     {
@@ -719,7 +747,7 @@ static void deblock_addb_cu_ver_yuv(XEVE_PIC *pic, int x_pel, int y_pel, int log
                 beta = xevem_addb_beta_tbl[indexB] << bitdepth_scale;
                 c1 = xevem_addb_clip_tbl[indexA][bs_cur] << XEVE_MAX(0, (bit_depth_luma - 9));
 
-                deblock_scu_addb_ver_luma(y, s_l, bs_cur, alpha, beta, c1, bit_depth_luma - 8);
+                deblock_addb_set_prm(prm_l, i << MIN_CU_LOG2, MIN_CU_SIZE, MIN_CU_SIZE, bs_cur, alpha, beta, c1);
             }
             if(xeve_check_chroma(tree_cons) && chroma_format_idc)
             {
@@ -734,7 +762,7 @@ static void deblock_addb_cu_ver_yuv(XEVE_PIC *pic, int x_pel, int y_pel, int log
                 c1 = xevem_addb_clip_tbl[indexA][bs_cur];
                 c0 = (c1 + 1) << XEVE_MAX(0, (bit_depth_chroma - 9));
 
-                deblock_scu_addb_ver_chroma(u, s_c, bs_cur, alpha, beta, c0, bit_depth_chroma - 8);
+                deblock_addb_set_prm(prm_c[0], i * size_c, size_c, MIN_CU_SIZE >> 1, bs_cur, alpha, beta, c0);
 
                 int qp_v = XEVE_CLIP3(-6 * (bit_depth_chroma - 8), 57, qp + pic->pic_qp_v_offset);
                 indexA = get_index(qp_chroma_dynamic[1][qp_v], pic->pic_deblock_alpha_offset);
@@ -746,13 +774,9 @@ static void deblock_addb_cu_ver_yuv(XEVE_PIC *pic, int x_pel, int y_pel, int log
                 c1 = xevem_addb_clip_tbl[indexA][bs_cur];
                 c0 = (c1 + 1) << XEVE_MAX(0, (bit_depth_chroma - 9));
 
-                deblock_scu_addb_ver_chroma(v, s_c, bs_cur, alpha, beta, c0, bit_depth_chroma - 8);
+                deblock_addb_set_prm(prm_c[1], i * size_c, size_c, MIN_CU_SIZE >> 1, bs_cur, alpha, beta, c0);
             }
 
-            y += (s_l << MIN_CU_LOG2);
-            u += (s_c << (MIN_CU_LOG2 - (XEVE_GET_CHROMA_W_SHIFT(chroma_format_idc))));
-            v += (s_c << (MIN_CU_LOG2 - (XEVE_GET_CHROMA_W_SHIFT(chroma_format_idc))));
-
             map_scu += w_scu;
             map_refi += w_scu;
             map_mv += w_scu;
@@ -760,6 +784,15 @@ static void deblock_addb_cu_ver_yuv(XEVE_PIC *pic, int x_pel, int y_pel, int log
         }
     }
 
+    if(xeve_check_luma(tree_cons))
+    {
+        xevem_func_dbk_addb_luma_ver(y, s_l, prm_l, h << MIN_CU_LOG2, bit_depth_luma);
+    }
+    if(xeve_check_chroma(tree_cons) && chroma_format_idc)
+    {
+        xevem_func_dbk_addb_chroma_ver(u, s_c, prm_c[0], h * size_c, bit_depth_chroma);
+        xevem_func_dbk_addb_chroma_ver(v, s_c, prm_c[1], h * size_c, bit_depth_chroma);
+    }
 }
 
 static void deblock_addb_cu_ver(XEVE_PIC *pic, int x_pel, int y_pel, int cuw, int cuh, u32 *map_scu, s8(*map_refi)[REFP_NUM]
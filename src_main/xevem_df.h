@@ -38,6 +38,27 @@
 
 #include "xevem_type.h"
 
+/* ADDB parameters of one line crossing an edge */
+typedef struct _XEVEM_DBK_PRM
+{
+    s16 bs;
+    s16 alpha;
+    s16 beta;
+    s16 c;
+} XEVEM_DBK_PRM;
+
+typedef void (*XEVEM_DBK_ADDB)(pel *buf, int stride, const XEVEM_DBK_PRM *prm, int len, int bit_depth);
+
+extern XEVEM_DBK_ADDB xevem_func_dbk_addb_luma_hor;
+extern XEVEM_DBK_ADDB xevem_func_dbk_addb_luma_ver;
+extern XEVEM_DBK_ADDB xevem_func_dbk_addb_chroma_hor;
+extern XEVEM_DBK_ADDB xevem_func_dbk_addb_chroma_ver;
+
+void xevem_dbk_addb_luma_hor(pel *buf, int stride, const XEVEM_DBK_PRM *prm, int len, int bit_depth);
+void xevem_dbk_addb_luma_ver(pel *buf, int stride, const XEVEM_DBK_PRM *prm, int len, int bit_depth);
+void xevem_dbk_addb_chroma_hor(pel *buf, int stride, const XEVEM_DBK_PRM *prm, int len, int bit_depth);
+void xevem_dbk_addb_chroma_ver(pel *buf, int stride, const XEVEM_DBK_PRM *prm, int len, int bit_depth);
+
 int  xevem_deblock(XEVE_CTX * ctx, XEVE_PIC * pic, int tile_idx, int filter_across_boundary, XEVE_CORE * core);
 void xevem_deblock_unit(XEVE_CTX * ctx, XEVE_PIC * pic, int x, int y, int cuw, int cuh, int is_hor_edge, XEVE_CORE * core, int boundary_filtering);
 void xevem_deblock_cu_hor(XEVE_PIC *pic, int x_pel, int y_pel, int cuw, int cuh, u32 *map_scu, s8(*map_refi)[REFP_NUM], s16(*map_mv)[REFP_NUM][MV_D]
@@ -49,4 +70,7 @@ void xevem_deblock_cu_ver(XEVE_PIC *pic, int x_pel, int y_pel, int cuw, int cuh,
 void xevem_deblock_tree(XEVE_CTX * ctx, XEVE_PIC * pic, int x, int y, int cuw, int cuh, int cud, int cup, int is_hor_edge
                       , TREE_CONS tree_cons, XEVE_CORE * core, int boundary_filtering);
 
+#include "xevem_df_sse.h"
+#include "xevem_df_avx.h"
+
 #endif /* _XEVEM_DF_H_ */
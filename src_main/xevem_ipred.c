@@ -472,9 +472,6 @@ static void ipred_bi(pel *src_le, pel *src_up, pel *src_ri, u16 avail_lr, pel *d
     (d_out) = ((d_in) * (mt)) >> 10;\
     (offset) = (((d_in) * (mt)) >> 5) - ((d_out) << 5);
 
-#define ADI_4T_FILTER_BITS                 7
-#define ADI_4T_FILTER_OFFSET              (1<<(ADI_4T_FILTER_BITS-1))
-
 void ipred_ang_less_ver_no_right(pel *src_le, pel *src_up, pel *src_ri, u16 avail_lr, pel *dst, int w, int h, int ipm, int bit_depth)
 {
     int offset;
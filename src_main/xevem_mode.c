@@ -1537,8 +1537,7 @@ static double mode_coding_tree_main(XEVE_CTX *ctx, XEVE_CORE *core, int x0, int
         {
             copy_history_buffer(&mcore->history_buffer, &org_mot_lut);
         }
-        ctx->sh->qp_prev_mode = core->dqp_data[log2_cuw - 2][log2_cuh - 2].prev_qp;
-        best_dqp = ctx->sh->qp_prev_mode;
+        best_dqp = core->dqp_data[log2_cuw - 2][log2_cuh - 2].prev_qp;
         split_mode = NO_SPLIT;
         if(split_allow[split_mode] && (cuw <= check_max_cu && cuh <= check_max_cu))
         {
@@ -2149,10 +2148,20 @@ static int xevem_mode_init_mt(XEVE_CTX *ctx, int thread_idx)
             ret = mctx->fn_pibc_init_tile(ctx, thread_idx);
             xeve_assert_rv(ret == XEVE_OK, ret);
         }
-        if (ctx->param.ibc_hash_search_flag)
-        {
-            xeve_ibc_hash_rebuild(mctx->ibc_hash, PIC_ORIG(ctx));
-        }
+    }
+
+    return XEVE_OK;
+}
+
+/* the hash of the original picture is shared by the threads of all tiles, it
+   is built before their mode decision starts */
+static int mode_analyze_frame_main(XEVE_CTX *ctx)
+{
+    XEVEM_CTX * mctx = (XEVEM_CTX *)ctx;
+
+    if (ctx->param.ibc_flag && ctx->param.ibc_hash_search_flag)
+    {
+        xeve_ibc_hash_rebuild(mctx->ibc_hash, PIC_ORIG(ctx));
     }
 
     return XEVE_OK;
@@ -2521,6 +2530,7 @@ void xeve_mode_create_main(XEVE_CTX *ctx)
 {
     /* set function addresses */
     ctx->fn_mode_init_mt = xevem_mode_init_mt;
+    ctx->fn_mode_analyze_frame = mode_analyze_frame_main;
     ctx->fn_mode_init_lcu = mode_init_lcu_main;
     ctx->fn_mode_copy_to_cu_data = copy_to_cu_data_main;
     ctx->fn_mode_reset_intra = mode_reset_intra_main;
@@ -1054,10 +1054,40 @@ static u32 pinter_me_epzs(XEVE_PINTER * pi, int x, int y, int log2_cuw, int log2
         }
     }
 
+    if(bi != BI_NORMAL && xeve_pinter_pyr_mv(pi, x, y, log2_cuw, log2_cuh, lidx, ri, mvt))
+    {
+        s16 range_pyr[MV_RANGE_DIM][MV_D];
+
+        /* search also around the motion found on the pyramid */
+        mvc[MV_X] = XEVE_CLIP3(pi->min_clip[MV_X], pi->max_clip[MV_X], x + mvt[MV_X]);
+        mvc[MV_Y] = XEVE_CLIP3(pi->min_clip[MV_Y], pi->max_clip[MV_Y], y + mvt[MV_Y]);
+        mvi[MV_X] = mvc[MV_X] << 2;
+        mvi[MV_Y] = mvc[MV_Y] << 2;
+
+        get_range_ipel(pi, mvc, range_pyr, 0, ri, lidx);
+        cost = me_ipel_diamond(pi, x, y, log2_cuw, log2_cuh, ri, lidx, range_pyr, gmvp, mvi, mvt, bi, &tmpstep, MAX_REFINE_SEARCH_STEP - pi->me_opt->max_refine_search_step_th, bit_depth_luma);
+
+        if(cost < cost_best)
+        {
+            cost_best = cost;
+            mv[MV_X] = mvt[MV_X];
+            mv[MV_Y] = mvt[MV_Y];
+            if(abs(mvp[MV_X] - mv[MV_X]) < 2 && abs(mvp[MV_Y] - mv[MV_Y]) < 2)
+            {
+                beststep = 0;
+            }
+            else
+            {
+                beststep = tmpstep;
+            }
+        }
+    }
+
     int cost_init = XEVE_UINT32_MAX;
-    /* Do raster search with best cost found so far */
+    /* Do raster search with best cost found so far, which is replaced by the
+       pyramid search when the pyramid covers the search range */
     cost_init = cost_best;
-    if(bi == BI_NON && beststep > RASTER_SEARCH_THD && pi->me_complexity > 1)
+    if(bi == BI_NON && beststep > RASTER_SEARCH_THD && pi->me_complexity > 1 && !xeve_pinter_pyr_covers(pi, x, y, lidx, ri, range))
     {
         cost = me_raster(pi, x, y, log2_cuw, log2_cuh, ri, lidx, range, gmvp, mvt, bit_depth_luma, cost_init);
 
@@ -5361,6 +5391,7 @@ static double pinter_analyze_cu(XEVE_CTX *ctx, XEVE_CORE *core, int x, int y, in
         int vertex_num;
 
         mcore->affine_flag = best_affine_mode;
+        mi->affine_flag = mcore->affine_flag;
         vertex_num = mcore->affine_flag + 1;
         for(lidx = 0; lidx < REFP_NUM; lidx++)
         {
@@ -5376,6 +5407,7 @@ static double pinter_analyze_cu(XEVE_CTX *ctx, XEVE_CORE *core, int x, int y, in
     else
     {
         mcore->affine_flag = 0;
+        mi->affine_flag = 0;
     }
 
     mcore->dmvr_flag = best_dmvr;
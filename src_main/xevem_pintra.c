@@ -181,8 +181,9 @@ static void pintra_ipred(XEVE_CTX * ctx, XEVE_CORE * core, pel * pred_buf, int i
 static int make_ipred_list(XEVE_CTX * ctx, XEVE_CORE * core, int log2_cuw, int log2_cuh, pel * org, int s_org, int * ipred_list)
 {
     XEVE_PINTRA *pi = &ctx->pintra[core->thread_cnt];
+    XEVE_PINTRA_CACHE *cache;
 
-    int cuw, cuh, pred_cnt, i, j;
+    int cuw, cuh, pred_cnt, i, j, hit;
     double cost, cand_cost[IPD_RDO_CNT];
     u32 cand_satd_cost[IPD_RDO_CNT];
     u32 cost_satd;
@@ -199,17 +200,26 @@ static int make_ipred_list(XEVE_CTX * ctx, XEVE_CORE * core, int log2_cuw, int l
     }
 
     pred_cnt = (ctx->sps.tool_eipd) ? IPD_CNT : IPD_CNT_B;
+    cache = xeve_pintra_cache_get(pi, core, log2_cuw, log2_cuh, &hit);
 
     for(i = 0; i < pred_cnt; i++)
     {
         int bit_cnt, shift = 0;
         pel * pred_buf = NULL;
 
-        pred_buf = pi->pred_cache[i];
+        if(!xeve_refresh_check_ipm(ctx, core->x_scu << MIN_CU_LOG2, cuw, i, 0))
+        {
+            continue;
+        }
+        if(!hit)
+        {
+            pred_buf = pi->pred_cache[i];
 
-        pintra_ipred(ctx, core, pred_buf, i, cuw, cuh);
+            pintra_ipred(ctx, core, pred_buf, i, cuw, cuh);
 
-        cost_satd = xeve_satd_16b(log2_cuw, log2_cuh, org, pred_buf, s_org, cuw, ctx->sps.bit_depth_luma_minus8 + 8);
+            cache->satd[i] = xeve_satd_16b(log2_cuw, log2_cuh, org, pred_buf, s_org, cuw, ctx->sps.bit_depth_luma_minus8 + 8);
+        }
+        cost_satd = cache->satd[i];
 
         cost = (double)cost_satd;
         SBAC_LOAD(core->s_temp_run, core->s_curr_best[log2_cuw - 2][log2_cuh - 2]);
@@ -252,6 +262,15 @@ static int make_ipred_list(XEVE_CTX * ctx, XEVE_CORE * core, int log2_cuw, int l
         }
     }
 
+    if(hit)
+    {
+        /* only the surviving candidates need a prediction for full RDO */
+        for(i = 0; i < XEVE_MIN(pred_cnt, ipd_rdo_cnt); i++)
+        {
+            pintra_ipred(ctx, core, pi->pred_cache[ipred_list[i]], ipred_list[i], cuw, cuh);
+        }
+    }
+
     return XEVE_MIN(pred_cnt, ipd_rdo_cnt);
 }
 
@@ -520,6 +539,10 @@ static double pintra_analyze_cu(XEVE_CTX* ctx, XEVE_CORE* core, int x, int y, in
                 {
                     continue;
                 }
+                if(!xeve_refresh_check_ipm(ctx, x, cuw, i, 1))
+                {
+                    continue;
+                }
 
                 cost_t = pintra_residue_rdo(ctx, core, org, org_cb, org_cr, s_org, s_org_c, log2_cuw, log2_cuh, coef, &dist_t, 1, x, y);
 
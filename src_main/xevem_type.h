@@ -124,7 +124,7 @@ typedef struct _XEVEM_CTX
     SIG_PARAM_DRA    * dra_array;
 
     /* ibc prediction analysis */
-    XEVE_PIBC          pibc[XEVE_MAX_THREADS];
+    XEVE_PIBC        * pibc;
     XEVE_IBC_HASH    * ibc_hash;
 
     int   (*fn_pibc_init_lcu)(XEVE_CTX * ctx, XEVE_CORE * core);
@@ -146,9 +146,9 @@ typedef struct _XEVEM_CTX
     u8               * map_ats_mode_v;
     u8               * map_ats_inter;
 
-    u32              * ats_inter_pred_dist[XEVE_MAX_THREADS];
-    u8               * ats_inter_info_pred[XEVE_MAX_THREADS];   //best-mode ats_inter info
-    u8               * ats_inter_num_pred[XEVE_MAX_THREADS];
+    u32             ** ats_inter_pred_dist;
+    u8              ** ats_inter_info_pred;   //best-mode ats_inter info
+    u8              ** ats_inter_num_pred;
 
 }XEVEM_CTX;
 
@@ -3414,10 +3414,8 @@ int xevem_set_tile_info(XEVE_CTX * ctx)
     }
 
     /* alloc tile information */
-    size = sizeof(XEVE_TILE) * f_tile;
-    ctx->tile = xeve_malloc(size);
-    xeve_assert_rv(ctx->tile, XEVE_ERR_OUT_OF_MEMORY);
-    xeve_mset(ctx->tile, 0, size);
+    size = xeve_alloc_tile(ctx, f_tile);
+    xeve_assert_rv(size == XEVE_OK, size);
 
     /* set tile information */
     if (ctx->param.tile_uniform_spacing_flag)
@@ -3589,7 +3587,7 @@ int xevem_ready(XEVE_CTX * ctx)
 
     ctx->param.framework_suco_max = XEVE_MIN(ctx->log2_max_cuwh, ctx->param.framework_suco_max);
     mctx->enc_alf = xeve_alf_create_buf(ctx->param.codec_bit_depth);
-    xeve_alf_create(mctx->enc_alf, ctx->w, ctx->h, ctx->max_cuwh, ctx->max_cuwh, 5, ctx->param.chroma_format_idc, ctx->param.codec_bit_depth);
+    xeve_alf_create(mctx->enc_alf, ctx->w, ctx->h, ctx->max_cuwh, ctx->max_cuwh, 5, ctx->param.chroma_format_idc, ctx->param.codec_bit_depth, ctx->param.threads);
 
     if (xeve_ready(ctx) != XEVE_OK)
     {
@@ -3601,27 +3599,6 @@ int xevem_ready(XEVE_CTX * ctx)
       mctx->ibc_hash = xeve_ibc_hash_create(ctx, ctx->w, ctx->h);
     }
 
-    //initialize the threads to NULL
-    for (int i = 0; i < XEVE_MAX_THREADS; i++)
-    {
-        ctx->thread_pool[i] = 0;
-    }
-
-    //get the context synchronization handle
-    ctx->sync_block = get_synchronized_object();
-    xeve_assert_gv(ctx->sync_block != NULL, ret, XEVE_ERR_UNKNOWN, ERR);
-
-    if (ctx->param.threads >= 1)
-    {
-        ctx->tc = xeve_malloc(sizeof(THREAD_CONTROLLER));
-        init_thread_controller(ctx->tc, ctx->param.threads);
-        for (int i = 0; i < ctx->param.threads; i++)
-        {
-            ctx->thread_pool[i] = ctx->tc->create(ctx->tc, i);
-            xeve_assert_gv(ctx->thread_pool[i] != NULL, ret, XEVE_ERR_UNKNOWN, ERR);
-        }
-    }
-
     if (mctx->map_affine == NULL)
     {
         size = sizeof(u32) * ctx->f_scu;
@@ -3737,6 +3714,9 @@ ERR:
 
     xeve_mfree_fast(ctx->map_tidx);
     xeve_mfree_fast((void*) ctx->sync_flag);
+    xeve_mfree_fast(ctx->row_state);
+    xeve_mfree_fast(ctx->map_ctu_time);
+    xeve_mfree_fast(ctx->row_time);
 
     if (ctx->param.tool_dra)
     {
@@ -3951,9 +3931,17 @@ void xevem_platform_init_func()
         xevem_func_aff_h_sobel_flt = &xevem_scaled_horizontal_sobel_filter_sse;
         xevem_func_aff_v_sobel_flt = &xevem_scaled_vertical_sobel_filter_sse;
         xevem_func_aff_eq_coef_comp = &xevem_equal_coeff_computer_sse;
-        xeve_func_intra_pred_ang = xeve_tbl_intra_pred_ang; /* to be updated */
+        xeve_func_intra_pred_ang = xeve_tbl_intra_pred_ang_avx;
         xeve_func_tx = &xeve_tbl_tx_avx;
         xeve_func_itx = &xeve_tbl_itx_avx;
+        xevem_func_alf_derive_classification_blk = &xevem_alf_derive_classification_blk_avx;
+        xevem_func_alf_filter_5x5_blk = &xevem_alf_filter_blk_5_avx;
+        xevem_func_alf_filter_7x7_blk = &xevem_alf_filter_blk_7_avx;
+        xevem_func_alf_get_blk_stats = &xevem_alf_get_blk_stats_avx;
+        xevem_func_dbk_addb_luma_hor = &xevem_dbk_addb_luma_hor_avx;
+        xevem_func_dbk_addb_luma_ver = &xevem_dbk_addb_luma_ver_avx;
+        xevem_func_dbk_addb_chroma_hor = &xevem_dbk_addb_chroma_hor_avx;
+        xevem_func_dbk_addb_chroma_ver = &xevem_dbk_addb_chroma_ver_avx;
     }
     else if (support_sse)
     {
@@ -3964,9 +3952,17 @@ void xevem_platform_init_func()
         xevem_func_aff_h_sobel_flt = &xevem_scaled_horizontal_sobel_filter_sse;
         xevem_func_aff_v_sobel_flt = &xevem_scaled_vertical_sobel_filter_sse;
         xevem_func_aff_eq_coef_comp = &xevem_equal_coeff_computer_sse;
-        xeve_func_intra_pred_ang = xeve_tbl_intra_pred_ang; /* to be updated */
+        xeve_func_intra_pred_ang = xeve_tbl_intra_pred_ang_sse;
         xeve_func_tx = &xeve_tbl_tx; /* to be updated */
         xeve_func_itx = &xeve_tbl_itx; /* to be updated */
+        xevem_func_alf_derive_classification_blk = &xevem_alf_derive_classification_blk_sse;
+        xevem_func_alf_filter_5x5_blk = &xevem_alf_filter_blk_5_sse;
+        xevem_func_alf_filter_7x7_blk = &xevem_alf_filter_blk_7_sse;
+        xevem_func_alf_get_blk_stats = &xevem_alf_get_blk_stats_sse;
+        xevem_func_dbk_addb_luma_hor = &xevem_dbk_addb_luma_hor_sse;
+        xevem_func_dbk_addb_luma_ver = &xevem_dbk_addb_luma_ver_sse;
+        xevem_func_dbk_addb_chroma_hor = &xevem_dbk_addb_chroma_hor_sse;
+        xevem_func_dbk_addb_chroma_ver = &xevem_dbk_addb_chroma_ver_sse;
     }
     else
 #endif
@@ -3981,6 +3977,14 @@ void xevem_platform_init_func()
         xeve_func_intra_pred_ang = xeve_tbl_intra_pred_ang;
         xeve_func_tx = &xeve_tbl_tx;
         xeve_func_itx = &xeve_tbl_itx;
+        xevem_func_alf_derive_classification_blk = &alf_derive_classification_blk;
+        xevem_func_alf_filter_5x5_blk = &alf_filter_blk_5;
+        xevem_func_alf_filter_7x7_blk = &alf_filter_blk_7;
+        xevem_func_alf_get_blk_stats = &xeve_alf_get_blk_stats;
+        xevem_func_dbk_addb_luma_hor = &xevem_dbk_addb_luma_hor;
+        xevem_func_dbk_addb_luma_ver = &xevem_dbk_addb_luma_ver;
+        xevem_func_dbk_addb_chroma_hor = &xevem_dbk_addb_chroma_hor;
+        xevem_func_dbk_addb_chroma_ver = &xevem_dbk_addb_chroma_ver;
     }
 }
 
@@ -3988,10 +3992,28 @@ int xevem_platform_init(XEVE_CTX * ctx)
 {
     XEVEM_CTX * mctx = (XEVEM_CTX *)ctx;
     int         ret = XEVE_ERR_UNKNOWN;
+    int         size;
 
     ret = xeve_platform_init(ctx);
     xeve_assert_rv(XEVE_OK == ret, ret);
 
+    /* allocate per-thread data of main profile */
+    size = sizeof(XEVE_PIBC) * ctx->param.threads;
+    mctx->pibc = (XEVE_PIBC *)xeve_malloc(size);
+    xeve_assert_rv(mctx->pibc, XEVE_ERR_OUT_OF_MEMORY);
+    xeve_mset(mctx->pibc, 0, size);
+
+    size = sizeof(void *) * ctx->param.threads;
+    mctx->ats_inter_pred_dist = (u32 **)xeve_malloc(size);
+    xeve_assert_rv(mctx->ats_inter_pred_dist, XEVE_ERR_OUT_OF_MEMORY);
+    xeve_mset(mctx->ats_inter_pred_dist, 0, size);
+    mctx->ats_inter_info_pred = (u8 **)xeve_malloc(size);
+    xeve_assert_rv(mctx->ats_inter_info_pred, XEVE_ERR_OUT_OF_MEMORY);
+    xeve_mset(mctx->ats_inter_info_pred, 0, size);
+    mctx->ats_inter_num_pred = (u8 **)xeve_malloc(size);
+    xeve_assert_rv(mctx->ats_inter_num_pred, XEVE_ERR_OUT_OF_MEMORY);
+    xeve_mset(mctx->ats_inter_num_pred, 0, size);
+
     ret = xevem_pintra_create(ctx, 0);
     xeve_assert_rv(XEVE_OK == ret, ret);
 
@@ -4030,7 +4052,7 @@ int xevem_platform_init(XEVE_CTX * ctx)
     ctx->fn_set_tile_info   = xevem_set_tile_info;
     ctx->fn_deblock_tree    = xevem_deblock_tree;
     ctx->fn_deblock_unit    = xevem_deblock_unit;
-    ctx->fn_pic_flt         = xevem_pic_filt;
+    ctx->fn_pic_flt         = ctx->param.tool_dra ? xevem_pic_filt : NULL;
     ctx->fn_deblock         = xevem_deblock;
     mctx->fn_alf            = xevem_alf_aps;
 
@@ -4045,6 +4067,15 @@ void xevem_platform_deinit(XEVE_CTX * ctx)
 
     xeve_platform_deinit(ctx);
     mctx->fn_alf = NULL;
+
+    xeve_mfree(mctx->pibc);
+    xeve_mfree(mctx->ats_inter_pred_dist);
+    xeve_mfree(mctx->ats_inter_info_pred);
+    xeve_mfree(mctx->ats_inter_num_pred);
+    mctx->pibc                = NULL;
+    mctx->ats_inter_pred_dist = NULL;
+    mctx->ats_inter_info_pred = NULL;
+    mctx->ats_inter_num_pred  = NULL;
 }
 
 int xevem_encode_sps(XEVE_CTX * ctx)
@@ -0,0 +1,46 @@
+# Encode a generated clip once per entry of THREADS and check that all
+# bitstreams and reconstructions are identical.
+#
+#   APP     encoder executable
+#   DIR     working directory
+#   ARGS    encoder arguments besides input, output and thread count
+#   THREADS comma separated thread counts, one encoding each
+
+set(W 256)
+set(H 256)
+set(FRAMES 4)
+
+file(REMOVE_RECURSE ${DIR})
+file(MAKE_DIRECTORY ${DIR})
+
+# a random 8-bit 4:2:0 picture which moves 3 samples per frame
+math(EXPR size "${W} * ${H} * 3 / 2")
+string(RANDOM LENGTH ${size} ALPHABET "0123456789:;<=>?@ABCDEFGHIJKLMNOP" RANDOM_SEED 1 pic)
+foreach(i RANGE 1 ${FRAMES})
+    math(EXPR off "${i} * 3")
+    string(SUBSTRING "${pic}" ${off} -1 head)
+    string(SUBSTRING "${pic}" 0 ${off} tail)
+    file(APPEND ${DIR}/in.yuv "${head}${tail}")
+endforeach()
+
+separate_arguments(args UNIX_COMMAND "${ARGS}")
+string(REPLACE "," ";" threads "${THREADS}")
+set(n 0)
+foreach(t ${threads})
+    execute_process(COMMAND ${APP} -i ${DIR}/in.yuv -w ${W} -h ${H} -z 30 -v 0 ${args} -m ${t}
+                            -o ${DIR}/out_${n}.evc -r ${DIR}/rec_${n}.yuv
+                    RESULT_VARIABLE res OUTPUT_QUIET ERROR_QUIET)
+    if(NOT (res EQUAL 0 OR res EQUAL 205) OR NOT EXISTS ${DIR}/out_${n}.evc)
+        message(FATAL_ERROR "encoding with ${t} threads failed (${res})")
+    endif()
+    file(MD5 ${DIR}/out_${n}.evc md5_bs)
+    file(MD5 ${DIR}/rec_${n}.yuv md5_rec)
+    message(STATUS "${t} threads: ${md5_bs} ${md5_rec}")
+    if(n EQUAL 0)
+        set(ref_bs ${md5_bs})
+        set(ref_rec ${md5_rec})
+    elseif(NOT md5_bs STREQUAL ref_bs OR NOT md5_rec STREQUAL ref_rec)
+        message(FATAL_ERROR "encoding ${n} with ${t} threads differs from the first encoding")
+    endif()
+    math(EXPR n "${n} + 1")
+endforeach()